@@ -0,0 +1,155 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <EOSAdmissibilityEnvelope.h>
+#include <Utils.h>
+#include <cfloat>
+#include <cmath>
+
+//-----------------------------------------------------
+
+EOSAdmissibilityEnvelope::EOSAdmissibilityEnvelope(std::vector<VarFcnBase*> &vf_,
+                                                   AdmissibilityEnvelopeData &iod_envelope)
+                        : vf(vf_)
+{
+  N = iod_envelope.N;
+  if(N<2) {
+    print_error("*** Error: Detected invalid number of points for the admissibility envelope (%d).\n", N);
+    exit_mpi();
+  }
+  if(iod_envelope.density_min<=0.0 || iod_envelope.density_max<=iod_envelope.density_min) {
+    print_error("*** Error: Detected invalid density range for the admissibility envelope ([%e, %e]).\n",
+                iod_envelope.density_min, iod_envelope.density_max);
+    exit_mpi();
+  }
+
+  log_rho_min = log10(iod_envelope.density_min);
+  log_rho_max = log10(iod_envelope.density_max);
+  dlog_rho = (log_rho_max - log_rho_min)/(N-1);
+}
+
+//-----------------------------------------------------
+
+void
+EOSAdmissibilityEnvelope::Setup()
+{
+  print("- Building the EOS admissibility envelope (%d material(s), %d points).\n", (int)vf.size(), N);
+
+  p_adm.assign(vf.size(), std::vector<double>());
+  p_floor.assign(vf.size(), std::vector<double>());
+
+  for(int id=0; id<(int)vf.size(); id++) {
+    if(vf[id]->type == VarFcnBase::DUMMY || vf[id]->HasIterativeInverse())
+      continue; //e(rho,p) may not exist (or may abort) at the probed states
+
+    p_adm[id].resize(N);
+    p_floor[id].resize(N);
+    for(int i=0; i<N; i++) {
+      double p = FindMinimumPressure(vf[id], pow(10.0, log_rho_min + i*dlog_rho));
+      if(p != -DBL_MAX && p != DBL_MAX)
+        p -= 1.0e-3*fabs(p); //margin (see above)
+      p_adm[id][i] = p;
+      p_floor[id][i] = (i==0) ? p : std::min(p_floor[id][i-1], p);
+    }
+
+    // the isentrope may leave the table at density_min. Probe the decades below it, so that the floor
+    // also covers the pressures reached there (-DBL_MAX if the EOS has no lower bound down there)
+    double p_below = DBL_MAX;
+    for(double log_rho = log_rho_min - 1.0; log_rho > -300.0; log_rho -= 1.0) {
+      double p = FindMinimumPressure(vf[id], pow(10.0, log_rho));
+      if(p == DBL_MAX)
+        continue; //this density is not admissible
+      if(p == -DBL_MAX) {
+        p_below = -DBL_MAX;
+        break;
+      }
+      p_below = std::min(p_below, p - 1.0e-3*fabs(p));
+    }
+    for(int i=0; i<N; i++)
+      p_floor[id][i] = std::min(p_floor[id][i], p_below);
+  }
+}
+
+//-----------------------------------------------------
+
+double
+EOSAdmissibilityEnvelope::FindMinimumPressure(VarFcnBase *vf_, double rho)
+{
+  // find an interval [p_lo, p_hi] with p_lo inadmissible and p_hi admissible
+  double p_lo, p_hi;
+  if(!vf_->CheckState(rho, 0.0, true)) {
+    p_hi = 0.0;
+    p_lo = -1.0;
+    while(!vf_->CheckState(rho, p_lo, true)) {
+      if(p_lo < -1.0e20)
+        return -DBL_MAX; //no lower bound
+      p_hi = p_lo;
+      p_lo *= 10.0;
+    }
+  } else {
+    p_lo = 0.0;
+    p_hi = 1.0;
+    while(vf_->CheckState(rho, p_hi, true)) {
+      if(p_hi > 1.0e20)
+        return DBL_MAX; //this density is not admissible
+      p_lo = p_hi;
+      p_hi *= 10.0;
+    }
+  }
+
+  // bisection (p_hi/p_lo <= 10 or p_lo = 0)
+  for(int it=0; it<60; it++) {
+    double p = 0.5*(p_lo + p_hi);
+    if(p == p_lo || p == p_hi)
+      break;
+    if(vf_->CheckState(rho, p, true))
+      p_lo = p;
+    else
+      p_hi = p;
+  }
+
+  return p_lo;
+}
+
+//-----------------------------------------------------
+
+int
+EOSAdmissibilityEnvelope::LocateDensity(double rho)
+{
+  if(!(rho>0.0))
+    return -1;
+  double x = (log10(rho) - log_rho_min)/dlog_rho;
+  if(x<0.0 || x>N-1)
+    return -1;
+  return std::min((int)x, N-2);
+}
+
+//-----------------------------------------------------
+
+double
+EOSAdmissibilityEnvelope::GetMinimumPressure(int id, double rho)
+{
+  if(p_adm[id].empty())
+    return -DBL_MAX;
+  int i = LocateDensity(rho);
+  if(i<0)
+    return -DBL_MAX;
+  return std::min(p_adm[id][i], p_adm[id][i+1]);
+}
+
+//-----------------------------------------------------
+
+double
+EOSAdmissibilityEnvelope::GetIsentropicPressureFloor(int id, double rho)
+{
+  if(p_floor[id].empty())
+    return -DBL_MAX;
+  int i = LocateDensity(rho);
+  if(i<0) //densities outside the table are not covered
+    return -DBL_MAX;
+  return p_floor[id][i+1]; //also covers [rho, rho_{i+1}] and densities below the table (see Setup)
+}
+
+//-----------------------------------------------------
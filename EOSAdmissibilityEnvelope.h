@@ -0,0 +1,65 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _EOS_ADMISSIBILITY_ENVELOPE_H_
+#define _EOS_ADMISSIBILITY_ENVELOPE_H_
+
+#include <IoData.h>
+#include <VarFcnBase.h>
+#include <vector>
+
+/*****************************************************************************************
+ * Class EOSAdmissibilityEnvelope stores, for each material, the minimum admissible pressure
+ * p_adm(rho), i.e. the lowest pressure at which VarFcnBase::CheckState passes (rho > 0, c^2 > 0),
+ * tabulated on a uniform grid of log10(rho). It is found by bisection at startup, assuming that
+ * the admissible pressures at a fixed density form a half-line (p > p_adm). This holds for EOS
+ * of the Mie-Gruneisen form (p = f(rho) + Gamma(rho)*rho*e, Gamma > 0), for which c^2 is affine in p.
+ * Materials for which e(rho,p) is found iteratively (HasIterativeInverse) are not tabulated, as the
+ * inverse may not exist at the probed states.
+ *
+ * Along a rarefaction, the density decreases. So, starting from density rho, the isentrope cannot
+ * reach a pressure below p_floor(rho) = min{p_adm(rho') : rho' <= rho}. This includes densities below
+ * the table, which are probed once per decade (down to 1e-300) at startup; if the EOS has no lower
+ * bound there, p_floor is -DBL_MAX (no floor). The exact Riemann solver uses
+ * p_floor to reject star pressure candidates, and p_adm to limit the RK step size, before calling
+ * the EOS. The tabulated values are lowered by a small margin so that they remain (approximate) lower
+ * bounds between grid points.
+ *****************************************************************************************/
+
+class EOSAdmissibilityEnvelope {
+
+  std::vector<VarFcnBase*> &vf;
+
+  int N;
+  double log_rho_min, log_rho_max, dlog_rho;
+
+  std::vector<std::vector<double> > p_adm; //!< p_adm[id][i]: minimum admissible pressure at the i-th density
+  std::vector<std::vector<double> > p_floor; //!< p_floor[id][i] = min{p_adm[id][j] : j <= i}, and p_adm below the table
+
+public:
+
+  EOSAdmissibilityEnvelope(std::vector<VarFcnBase*> &vf_, AdmissibilityEnvelopeData &iod_envelope);
+  ~EOSAdmissibilityEnvelope() {}
+
+  //! builds the tables for all the materials
+  void Setup();
+
+  //! minimum admissible pressure at density rho (-DBL_MAX if unknown)
+  double GetMinimumPressure(int id, double rho);
+
+  //! lower bound of the pressures reachable along an isentrope (rarefaction) from density rho (-DBL_MAX if unknown)
+  double GetIsentropicPressureFloor(int id, double rho);
+
+private:
+
+  //! returns -DBL_MAX if all the pressures are admissible, and DBL_MAX if none is
+  double FindMinimumPressure(VarFcnBase *vf_, double rho);
+
+  //! returns the cell index (i such that rho is in [rho_i, rho_{i+1}]), or -1 if rho is outside the table
+  int LocateDensity(double rho);
+
+};
+
+#endif
@@ -0,0 +1,316 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <EOSTabulator.h>
+#include <Utils.h>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cmath>
+#include <unistd.h> //truncate
+
+//-----------------------------------------------------
+
+EOSTabulator::EOSTabulator(std::vector<VarFcnBase*> &vf_) : vf(vf_)
+{
+  if(vf.empty()) {
+    print_error("*** Error: EOSTabulator requires at least one VarFcn.\n");
+    exit_mpi();
+  }
+}
+
+//-----------------------------------------------------
+
+int
+EOSTabulator::Tabulate(EOSTabulationData &tab)
+{
+  if(!IsSupportedPair(tab.xvar, tab.yvar)) {
+    print_error("*** Error: Unable to tabulate EOS with VariableX = %s and VariableY = %s.\n",
+                GetVariableName(tab.xvar), GetVariableName(tab.yvar));
+    return 1;
+  }
+  if(!strcmp(tab.filename, "")) {
+    print_error("*** Error: Output file for EOS tabulation (material %d) is not specified.\n", tab.materialid);
+    return 1;
+  }
+
+  // x0 == xmax or y0 == ymax generates 1D data
+  int Nx = (tab.x0 == tab.xmax) ? 1 : tab.Nx;
+  int Ny = (tab.y0 == tab.ymax) ? 1 : tab.Ny;
+  if(Nx<1 || Ny<1) {
+    print_error("*** Error: Detected invalid number of points for EOS tabulation (%d x %d).\n", Nx, Ny);
+    return 1;
+  }
+  double dx = Nx>1 ? (tab.xmax - tab.x0)/(Nx-1) : 0.0;
+  double dy = Ny>1 ? (tab.ymax - tab.y0)/(Ny-1) : 0.0;
+
+  std::vector<std::string> header = CreateHeader(tab, Nx, Ny);
+
+  // restart
+  int i0 = 0;
+  if(tab.restart == EOSTabulationData::YES)
+    i0 = ReadRestartFile(tab.filename, header, Ny);
+
+  FILE *file = fopen(tab.filename, i0>0 ? "a" : "w");
+  if(!file) {
+    print_error("*** Error: Cannot open file %s for output.\n", tab.filename);
+    return 1;
+  }
+  if(i0==0) {
+    for(auto &line : header)
+      fprintf(file, "%s\n", line.c_str());
+    fflush(file);
+  }
+  else if(i0<Nx)
+    print("- Resuming EOS tabulation from row %d (of %d) in %s.\n", i0+1, Nx, tab.filename);
+  else {
+    print("- EOS table in %s is already complete.\n", tab.filename);
+    fclose(file);
+    return 0;
+  }
+
+  int nThreads = vf.size();
+  print("- Tabulating %s of material %d on %d x %d points using %d thread(s).\n",
+        GetVariableName(tab.output), tab.materialid, Nx, Ny, nThreads);
+
+  // rows are computed in blocks. Within each block, points are distributed to threads dynamically.
+  // After each block, rows are written and flushed (so that an interrupted job can be restarted).
+  int rows_per_block = std::max(1, std::min(Nx, (1<<16)/Ny));
+  std::vector<double> values(rows_per_block*Ny);
+  std::atomic<int> nfailed(0); //!< points where (x,y) could not be converted to (rho,e)
+
+  for(int ib=i0; ib<Nx; ib+=rows_per_block) {
+
+    int nrows = std::min(rows_per_block, Nx-ib);
+    int npoints = nrows*Ny;
+    std::atomic<int> counter(0);
+
+    auto work = [&](int tid) {
+      VarFcnBase *vf_ = vf[tid];
+      int n;
+      while((n = counter++) < npoints) {
+        double x = tab.x0 + (ib + n/Ny)*dx;
+        double y = tab.y0 + (n%Ny)*dy;
+        double rho, e;
+        if(!ComputeDensityAndInternalEnergy(vf_, tab.xvar, x, tab.yvar, y, rho, e)) {
+          values[n] = NAN; //flagged in the output file
+          nfailed++;
+          continue;
+        }
+        values[n] = ComputeOutput(vf_, tab.output, rho, e);
+      }
+    };
+
+    if(nThreads==1)
+      work(0);
+    else {
+      std::vector<std::thread> threads;
+      for(int t=0; t<nThreads; t++)
+        threads.push_back(std::thread(work, t));
+      for(auto &th : threads)
+        th.join();
+    }
+
+    for(int r=0; r<nrows; r++) {
+      double x = tab.x0 + (ib+r)*dx;
+      for(int j=0; j<Ny; j++)
+        fprintf(file, "%.17e  %.17e  %.17e\n", x, tab.y0 + j*dy, values[r*Ny+j]);
+      fprintf(file, "\n");
+    }
+    fflush(file);
+
+    if(vf[0]->verbose>=1)
+      print("  o Completed %d of %d rows.\n", ib+nrows, Nx);
+  }
+
+  fclose(file);
+
+  if(nfailed>0)
+    print("Warning: Unable to find (rho,e) at %d point(s) of the EOS table. The values are set to NaN.\n",
+          nfailed.load());
+  print("- Wrote EOS table to %s.\n", tab.filename);
+  return 0;
+}
+
+//-----------------------------------------------------
+
+bool
+EOSTabulator::IsSupportedPair(EOSTabulationData::Variable xvar, EOSTabulationData::Variable yvar)
+{
+  auto is = [&](EOSTabulationData::Variable a, EOSTabulationData::Variable b) {
+    return (xvar==a && yvar==b) || (xvar==b && yvar==a);};
+
+  return is(EOSTabulationData::DENSITY,  EOSTabulationData::SPECIFIC_INTERNAL_ENERGY) ||
+         is(EOSTabulationData::DENSITY,  EOSTabulationData::PRESSURE) ||
+         is(EOSTabulationData::DENSITY,  EOSTabulationData::TEMPERATURE) ||
+         is(EOSTabulationData::PRESSURE, EOSTabulationData::SPECIFIC_INTERNAL_ENERGY);
+}
+
+//-----------------------------------------------------
+
+bool
+EOSTabulator::ComputeDensityAndInternalEnergy(VarFcnBase *vf_, EOSTabulationData::Variable xvar, double x,
+                                              EOSTabulationData::Variable yvar, double y, double &rho, double &e)
+{
+  // order the pair such that "a" is density if present, otherwise pressure
+  EOSTabulationData::Variable avar = xvar, bvar = yvar;
+  double a = x, b = y;
+  if(yvar == EOSTabulationData::DENSITY ||
+     (xvar != EOSTabulationData::DENSITY && yvar == EOSTabulationData::PRESSURE)) {
+    avar = yvar; bvar = xvar;
+    a = y;       b = x;
+  }
+
+  if(avar == EOSTabulationData::DENSITY) {
+    rho = a;
+    switch (bvar) {
+      case EOSTabulationData::SPECIFIC_INTERNAL_ENERGY :
+        e = b;
+        break;
+      case EOSTabulationData::PRESSURE :
+        e = vf_->GetInternalEnergyPerUnitMass(rho, b);
+        break;
+      case EOSTabulationData::TEMPERATURE :
+        e = vf_->GetInternalEnergyPerUnitMassFromTemperature(rho, b);
+        break;
+      default :
+        return false;
+    }
+  }
+  else if(avar == EOSTabulationData::PRESSURE && bvar == EOSTabulationData::SPECIFIC_INTERNAL_ENERGY) {
+    e = b;
+    rho = vf_->GetDensity(a, e);
+  }
+  else
+    return false;
+
+  // the inverse functions of some EOS may fail (e.g., out of the EOS's domain)
+  return std::isfinite(rho) && std::isfinite(e) && rho>0.0;
+}
+
+//-----------------------------------------------------
+
+double
+EOSTabulator::ComputeOutput(VarFcnBase *vf_, EOSTabulationData::Variable output, double rho, double e)
+{
+  switch (output) {
+    case EOSTabulationData::PRESSURE :
+      return vf_->GetPressure(rho, e);
+    case EOSTabulationData::SPECIFIC_INTERNAL_ENERGY :
+      return e;
+    case EOSTabulationData::DENSITY :
+      return rho;
+    case EOSTabulationData::DP_DE :
+      return rho*vf_->GetBigGamma(rho, e);
+    case EOSTabulationData::GRUNEISEN_PARAMETER :
+      return vf_->GetBigGamma(rho, e);
+    case EOSTabulationData::DP_DRHO :
+      return vf_->GetDpdrho(rho, e);
+    case EOSTabulationData::BULK_MODULUS :
+      return rho*vf_->GetDpdrho(rho, e);
+    case EOSTabulationData::TEMPERATURE :
+      return vf_->GetTemperature(rho, e);
+    case EOSTabulationData::SPECIFIC_ENTHALPY :
+      return e + vf_->GetPressure(rho, e)/rho;
+  }
+  return 0.0;
+}
+
+//-----------------------------------------------------
+
+const char*
+EOSTabulator::GetVariableName(EOSTabulationData::Variable var)
+{
+  switch (var) {
+    case EOSTabulationData::PRESSURE :                 return "Pressure";
+    case EOSTabulationData::SPECIFIC_INTERNAL_ENERGY : return "SpecificInternalEnergy";
+    case EOSTabulationData::DENSITY :                  return "Density";
+    case EOSTabulationData::DP_DE :                    return "PressureDerivativeEnergy";
+    case EOSTabulationData::GRUNEISEN_PARAMETER :      return "GruneisenParameter";
+    case EOSTabulationData::DP_DRHO :                  return "PressureDerivativeDensity";
+    case EOSTabulationData::BULK_MODULUS :             return "BulkModulus";
+    case EOSTabulationData::TEMPERATURE :              return "Temperature";
+    case EOSTabulationData::SPECIFIC_ENTHALPY :        return "SpecificEnthalpy";
+  }
+  return "Unknown";
+}
+
+//-----------------------------------------------------
+
+std::vector<std::string>
+EOSTabulator::CreateHeader(EOSTabulationData &tab, int Nx, int Ny)
+{
+  std::vector<std::string> header;
+  char line[512];
+
+  snprintf(line, sizeof(line), "## EOS table. MaterialID: %d, EOS type: %d.", tab.materialid, vf[0]->type);
+  header.push_back(line);
+  snprintf(line, sizeof(line), "## TabulatedVariable: %s", GetVariableName(tab.output));
+  header.push_back(line);
+  snprintf(line, sizeof(line), "## VariableX: %s, %.12e -> %.12e, %d points", GetVariableName(tab.xvar),
+           tab.x0, tab.xmax, Nx);
+  header.push_back(line);
+  snprintf(line, sizeof(line), "## VariableY: %s, %.12e -> %.12e, %d points", GetVariableName(tab.yvar),
+           tab.y0, tab.ymax, Ny);
+  header.push_back(line);
+  snprintf(line, sizeof(line), "## %s  %s  %s", GetVariableName(tab.xvar), GetVariableName(tab.yvar),
+           GetVariableName(tab.output));
+  header.push_back(line);
+
+  return header;
+}
+
+//-----------------------------------------------------
+
+int
+EOSTabulator::ReadRestartFile(const char *filename, std::vector<std::string> &header, int Ny)
+{
+  FILE *file = fopen(filename, "r");
+  if(!file)
+    return 0;
+
+  char line[512];
+
+  // the header must match exactly. Otherwise, the file is overwritten.
+  for(auto &h : header) {
+    if(!fgets(line, sizeof(line), file)) {
+      fclose(file);
+      return 0;
+    }
+    line[strcspn(line, "\n")] = '\0';
+    if(h != line) {
+      fclose(file);
+      print("Warning: Existing file %s does not match the specified EOS table. Overwriting it.\n", filename);
+      return 0;
+    }
+  }
+
+  // count the complete rows (Ny data lines followed by a blank line)
+  long end_of_last_row = ftell(file);
+  int nrows = 0, nlines = 0;
+  while(fgets(line, sizeof(line), file)) {
+    if(line[0]=='\n') {
+      if(nlines != Ny)
+        break; //corrupted
+      nrows++;
+      nlines = 0;
+      end_of_last_row = ftell(file);
+    }
+    else
+      nlines++;
+  }
+  fclose(file);
+
+  // remove the incomplete row (if any)
+  if(truncate(filename, end_of_last_row) != 0) {
+    print("Warning: Unable to truncate %s for restart. Starting over.\n", filename);
+    return 0;
+  }
+
+  return nrows;
+}
+
+//-----------------------------------------------------
+
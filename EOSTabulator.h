@@ -0,0 +1,60 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _EOS_TABULATOR_H_
+#define _EOS_TABULATOR_H_
+
+#include <VarFcnBase.h>
+#include <vector>
+#include <string>
+
+/*****************************************************************************************
+ * Class EOSTabulator evaluates a thermodynamic variable (EOSTabulationData::output) of a
+ * material on a uniform grid of two state variables (xvar, yvar), and writes the result
+ * to a file. The grid points are distributed to multiple threads. Each thread must have
+ * its own VarFcn object, as some of them (e.g., ANEOS) store intermediate results and are
+ * not thread-safe.
+ *
+ * Output format (text, one grid point per line, a blank line after each x-row):
+ *   ## header (material, variables, ranges, number of points)
+ *   x  y  value
+ * Points where (x,y) cannot be converted to (rho,e) get value = NaN (a warning is printed).
+ *
+ * Rows are written in order, and flushed periodically. If Restart = Yes, an existing file
+ * with the same header is read, and the tabulation resumes after the last complete row.
+ *****************************************************************************************/
+
+class EOSTabulator {
+
+  std::vector<VarFcnBase*> &vf; //!< one VarFcn per thread (for the same material)
+
+public:
+
+  EOSTabulator(std::vector<VarFcnBase*> &vf_);
+  ~EOSTabulator() {}
+
+  //! returns 0 if successful
+  int Tabulate(EOSTabulationData &tab);
+
+private:
+
+  //! converts (x,y) to (rho,e). Returns false if the pair (xvar,yvar) is not supported, or the conversion fails
+  bool ComputeDensityAndInternalEnergy(VarFcnBase *vf_, EOSTabulationData::Variable xvar, double x,
+                                       EOSTabulationData::Variable yvar, double y, double &rho, double &e);
+
+  double ComputeOutput(VarFcnBase *vf_, EOSTabulationData::Variable output, double rho, double e);
+
+  bool IsSupportedPair(EOSTabulationData::Variable xvar, EOSTabulationData::Variable yvar);
+
+  const char* GetVariableName(EOSTabulationData::Variable var);
+
+  std::vector<std::string> CreateHeader(EOSTabulationData &tab, int Nx, int Ny);
+
+  //! returns the number of complete rows in an existing file (0 if the file cannot be used)
+  int ReadRestartFile(const char *filename, std::vector<std::string> &header, int Ny);
+
+};
+
+#endif
@@ -4,6 +4,8 @@
  ************************************************************************/
 
 #include<ExactRiemannSolverBase.h>
+#include<StarPressureAtlas.h>
+#include<EOSAdmissibilityEnvelope.h>
 #include<array>
 #include<utility> //std::pair
 #include<bits/stdc++.h> //std::swap
@@ -26,8 +28,6 @@ using std::endl;
 //using std::chrono::duration;
 //using std::chrono::milliseconds;
 
-extern int verbose;
-
 #define INVALID_MATERIAL_ID -1
 //-----------------------------------------------------
 
@@ -44,10 +44,68 @@ ExactRiemannSolverBase::ExactRiemannSolverBase(std::vector<VarFcnBase*> &vf_,
   min_pressure         = iod_riemann.min_pressure;
   failure_threshold    = iod_riemann.failure_threshold;
   pressure_at_failure  = iod_riemann.pressure_at_failure;
+  acoustic_threshold   = iod_riemann.acoustic_threshold;
+  num_solutions = num_acoustic_solutions = 0;
+  num_bracketing_candidates = iod_riemann.bracketing_candidates;
+  atlas = NULL;
+  envelope = NULL;
+  fallback = NULL;
+  verbose = 0;
+  last_stage = ADAPTIVE;
+  for(int i=0; i<STAGE_SIZE; i++)
+    stage_count[i] = 0;
+  last_region = INITIAL_STATE;
+  last_left = true;
   surface_tension      = iod_riemann.surface_tension == ExactRiemannSolverData::YES;
   integrationPath1.reserve(500);
   integrationPath3.reserve(500);
+#if PRINT_RIEMANN_SOLUTION == 1
+  solution_file = "RiemannSolution.txt";
+#endif
+}
+
+//-----------------------------------------------------
+
+ExactRiemannSolverBase::~ExactRiemannSolverBase()
+{
+  if(fallback)
+    delete fallback;
+}
+
+//-----------------------------------------------------
+
+void
+ExactRiemannSolverBase::SetVerbosity(int verbose_)
+{
+  verbose = verbose_;
+  if(fallback)
+    fallback->verbose = verbose_;
+}
+
+//-----------------------------------------------------
+
+bool
+ExactRiemannSolverBase::IsValidInputState(const double *V, int id)
+{
+  if(id<0 || id>=(int)vf.size())
+    return false;
+  for(int i=0; i<5; i++)
+    if(!std::isfinite(V[i]))
+      return false;
+  return !vf[id]->CheckState(V[0], V[4], true);
+}
+
+//-----------------------------------------------------
+
+#if PRINT_RIEMANN_SOLUTION == 1
+void
+ExactRiemannSolverBase::SetSolutionFile(const char *filename)
+{
+  solution_file = filename;
+  if(fallback)
+    fallback->solution_file = filename;
 }
+#endif
 
 //-----------------------------------------------------
 /** Solves the one-dimensional Riemann problem. Extension of Kamm 2015 
@@ -55,6 +113,8 @@ ExactRiemannSolverBase::ExactRiemannSolverBase(std::vector<VarFcnBase*> &vf_,
  * Returns an integer error code
  * 0: no errors
  * 1: riemann solver failed to find a bracketing interval
+ * 2: vacuum (no solution; the star states are at the vacuum pressure, see FindVacuumState)
+ * 3: cavitation (no solution above the pressure floor; the star states are at the floor)
  */
 int
 ExactRiemannSolverBase::ComputeRiemannSolution(double *dir, 
@@ -67,6 +127,22 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
 {
   assert(curvature == 0.0); //the base class does not handle curvature!
 
+  double el = vf[idl]->GetInternalEnergyPerUnitMass(Vm[0], Vm[4]);
+  double er = vf[idr]->GetInternalEnergyPerUnitMass(Vp[0], Vp[4]);
+
+  return ComputeRiemannSolutionWithEnergies(dir, Vm, idl, el, Vp, idr, er, Vs, id, Vsm, Vsp);
+}
+
+//-----------------------------------------------------
+
+int
+ExactRiemannSolverBase::ComputeRiemannSolutionWithEnergies(double *dir,
+    double *Vm, int idl, double el /*"left" state*/,
+    double *Vp, int idr, double er /*"right" state*/,
+    double *Vs, int &id /*solution at xi = 0 (i.e. x=0) */,
+    double *Vsm /*left 'star' solution*/,
+    double *Vsp /*right 'star' solution*/)
+{
   //std::cout << "ExactRiemannSolverBase::ComputeRiemannSolution: this is the base version!" << std::endl;
   // Convert to a 1D problem (i.e. One-Dimensional Riemann)
   double rhol  = Vm[0];
@@ -85,11 +161,12 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
   integrationPath3.push_back(vectR); 
 
 #if PRINT_RIEMANN_SOLUTION == 1
+  // sol1d holds the profile of this solve only (cleared here, and before each star-state evaluation)
+  sol1d.clear();
   std::cout << "Left State (rho, u, p): " << rhol << ", " << ul << ", " << pl << "." << std::endl;
   std::cout << "Right State (rho, u, p): " << rhor << ", " << ur << ", " << pr << "." << std::endl;
 #endif
 
-  double el = vf[idl]->GetInternalEnergyPerUnitMass(rhol, pl);
   double cl = vf[idl]->ComputeSoundSpeedSquare(rhol, el);
 
   if(rhol<=0 || cl<0) {
@@ -100,7 +177,6 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
   } else
     cl = sqrt(cl);
 
-  double er = vf[idr]->GetInternalEnergyPerUnitMass(rhor, pr);
   double cr = vf[idr]->ComputeSoundSpeedSquare(rhor, er);
 
   if(rhor<=0 || cr<0) {
@@ -112,6 +188,27 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
     cr = sqrt(cr);
 
 
+  num_solutions++;
+  last_stage = ADAPTIVE;
+
+  // If the star states are not requested (Vsm = Vsp = NULL), check first whether the solution at
+  // xi = 0 is simply one of the initial states (e.g., supersonic flow). If so, skip the iterations.
+  double Vsm_tmp[5], Vsp_tmp[5];
+  if(!Vsm || !Vsp) {
+    int side = FindUpwindInitialState(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr);
+    if(side != 0) {
+      id = side<0 ? idl : idr;
+      for(int i=0; i<5; i++)
+        Vs[i] = side<0 ? Vm[i] : Vp[i];
+      last_region = INITIAL_STATE;
+      last_left = side<0;
+      return 0;
+    }
+    Vsm = Vsm_tmp; //computed, but not returned to the caller
+    Vsp = Vsp_tmp;
+  }
+
+
   // Declare variables in the "star region"
   double p0(DBL_MIN), ul0(0.0), ur0(0.0), rhol0(DBL_MIN), rhor0(DBL_MIN);
   double p1(DBL_MIN), ul1(0.0), ur1(0.0), rhol1(DBL_MIN), rhor1(DBL_MIN); //Secant Method ("k-1","k" in Kamm, (19))
@@ -138,6 +235,29 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
     return 0;
   }
 
+  // Weak jumps: linearized (acoustic) solution
+  if(acoustic_threshold>0.0 &&
+     ComputeLinearizedStarState(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, rhol2, rhor2, ul2, p2)) {
+    num_acoustic_solutions++;
+    FinalizeSolution(dir, Vm, Vp, rhol, ul, pl, idl, rhor, ur, pr, idr, rhol2, rhor2, ul2, p2,
+	trans_rare, Vrare_x0, //inputs
+	Vs, id, Vsm, Vsp/*outputs*/);
+    return 0;
+  }
+
+  // Vacuum or cavitation: there is no star state above the pressure floor
+  int vacuum = FindVacuumState(rhol, ul, pl, el, cl, idl, rhor, ur, pr, er, cr, idr, /*inputs*/
+                               p2, rhol2, ul2, rhor2, ur2, trans_rare, Vrare_x0/*outputs*/);
+  if(vacuum) {
+    if(verbose>=1)
+      cout << "Warning: Riemann solver detected " << (vacuum==2 ? "a vacuum" : "cavitation")
+           << " (p = " << p2 << ", ul* = " << ul2 << ", ur* = " << ur2 << ")." << endl;
+    FinalizeVacuumSolution(dir, Vm, Vp, rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, rhol2, rhor2, ul2, ur2, p2,
+	trans_rare, Vrare_x0, /*inputs*/
+	Vs, id, Vsm, Vsp /*outputs*/);
+    return vacuum;
+  }
+
   // -------------------------------
   // Step 1: Initialization
   //         (find initial interval [p0, p1])
@@ -151,7 +271,7 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
 
     // get sol1d, trans_rare and Vrare_x0
 #if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
+    sol1d.clear(); //keep only the profile of the latest evaluation
 #endif
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p1, idl, rhol0, rhol0*1.1, rhol2, ul2,
 	&trans_rare, Vrare_x0/*filled only if found a trans. rarefaction*/);
@@ -174,9 +294,11 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
 	for(int i=0; i<5; i++)
 	  Vs[i] = Vp[i];
       }
+      last_region = INITIAL_STATE;
+      last_left = u_avg >= 0;
 
-      ExactRiemannSolverNonAdaptive riemannNonAdaptive(vf, iod_riemann); 
-      int retryRiemann = riemannNonAdaptive.ComputeRiemannSolution(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp);
+      double interval[6] = {p0, rhol0, rhor0, p1, rhol1, rhor1};
+      int retryRiemann = ComputeRiemannSolutionByFallback(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp, interval);
       if(verbose>=1)
 	cout << "Warning: Riemann solver failed to find an initial bracketing interval. Activated the non-adaptive version." << endl; 
       return retryRiemann;
@@ -186,8 +308,8 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
 	trans_rare, Vrare_x0, /*inputs*/
 	Vs, id, Vsm, Vsp /*outputs*/);
 
-    ExactRiemannSolverNonAdaptive riemannNonAdaptive(vf, iod_riemann); 
-    int retryRiemann = riemannNonAdaptive.ComputeRiemannSolution(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp);
+    double interval[6] = {p0, rhol0, rhor0, p1, rhol1, rhor1};
+    int retryRiemann = ComputeRiemannSolutionByFallback(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp, interval);
     if(verbose>=1)
       cout << "Warning: Riemann solver failed to find an initial bracketing interval. Activated the non-adaptive version." << endl;
     return retryRiemann;
@@ -212,10 +334,6 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
   p2 = p1; 
   f2 = f1;
 
-#if PRINT_RIEMANN_SOLUTION == 1
-  sol1d.clear();
-#endif
-
   for(iter=0; iter<maxIts_main; iter++) {
 
     // 2.1: Update p using the Brent method (safeguarded secant method)
@@ -238,6 +356,10 @@ ExactRiemannSolverBase::ComputeRiemannSolution(double *dir,
 
 try_again:
 
+#if PRINT_RIEMANN_SOLUTION == 1
+    sol1d.clear(); //keep only the profile of the latest evaluation
+#endif
+
     // 2.2: Calculate ul2, ur2 
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p2, idl/*inputs*/, 
 	rhol0, rhol1/*initial guesses for Hugo. eq.*/,
@@ -304,10 +426,6 @@ try_again:
 
     trans_rare = false; //reset
 
-#if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
-#endif
-
   }
 
 
@@ -329,8 +447,9 @@ try_again:
 	<< ")" << endl;
     }
 
-    ExactRiemannSolverNonAdaptive riemannNonAdaptive(vf, iod_riemann);
-    int retryRiemann = riemannNonAdaptive.ComputeRiemannSolution(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp);
+    // the interval [p0, p1] still brackets the root --- pass it to the fallback solver
+    double interval[6] = {p0, rhol0, rhor0, p1, rhol1, rhor1};
+    int retryRiemann = ComputeRiemannSolutionByFallback(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp, interval);
     if(verbose>=1)
       cout << "Warning: Exact Riemann solver (adaptive) failed to converge. Activated the non-adaptive version." << endl;
     return retryRiemann;
@@ -346,6 +465,34 @@ try_again:
 
 }
 
+//-----------------------------------------------------
+/** The fallback chain: the non-adaptive solver is created once and reused. It is first started from
+ * the interval found by the adaptive solver (along with its star densities), which skips the search
+ * for a bracketing interval. The integration paths of the adaptive solver are not passed on, as they
+ * may come from a failed solve. If this interval is not usable, it solves the problem from scratch. */
+int
+ExactRiemannSolverBase::ComputeRiemannSolutionByFallback(double *dir, double *Vm, int idl,
+    double *Vp, int idr, double *Vs, int &id, double *Vsm, double *Vsp, double *interval)
+{
+  if(!fallback) {
+    fallback = new ExactRiemannSolverNonAdaptive(vf, iod_riemann);
+    fallback->verbose = verbose;
+#if PRINT_RIEMANN_SOLUTION == 1
+    fallback->solution_file = solution_file;
+#endif
+  }
+
+  bool warm = false;
+  int err = fallback->ComputeRiemannSolutionFromInterval(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp, interval, &warm);
+
+  last_stage = err ? FAILED : (warm ? NONADAPTIVE_WARM : NONADAPTIVE_COLD);
+  stage_count[last_stage]++;
+  last_region = fallback->last_region;
+  last_left = fallback->last_left;
+
+  return err;
+}
+
 //-----------------------------------------------------
 
   void
@@ -384,23 +531,31 @@ ExactRiemannSolverBase::FinalizeSolution(double *dir, double *Vm, double *Vp,
       rhol2, 0.9*rhol2/*initial guesses for Hugo. eq.*/,
       rhol2_tmp, ul2_tmp/*outputs*/, 
       &trans_rare, Vrare_x0/*filled only if found a trans. rarefaction*/);
-  if (!success) {
-    std::cout <<  "*** Error: ComputeRhoUStar(1) failed when finalizng the solution." << std::endl;
-    exit(-1);
-  } 
+  if (!success) //keep the solution found by the solver; only the profile is incomplete
+    std::cout <<  "Warning: ComputeRhoUStar(1) failed when finalizing the solution profile." << std::endl;
   success = ComputeRhoUStar(3, integrationPath3, rhor, ur, pr,  p2, idr/*inputs*/, 
       rhor2, 0.9*rhor2/*initial guesses for Hugo. erq.*/,
       rhor2_tmp, ur2_tmp/*outputs*/,
       &trans_rare, Vrare_x0/*filled only if found a trans. rarefaction*/);
-  if (!success) {
-    std::cout <<  "*** Error: ComputeRhoUStar(3) failed when finalizng the solution." << std::endl;
-    exit(-1);
-  } 
+  if (!success) //keep the solution found by the solver; only the profile is incomplete
+    std::cout <<  "Warning: ComputeRhoUStar(3) failed when finalizing the solution profile." << std::endl;
+#else
+  // The main loop resumes the integration of rarefactions from the stored paths, i.e. from a point
+  // inside the fan. So, if the fan crosses x = 0, the sampled state (Vrare_x0) may not be accurate.
+  // Integrate the transonic rarefaction again, from the initial state. If this fails, keep Vrare_x0.
+  if(trans_rare &&
+     !(pl > p2 && ResampleTransonicRarefaction(1, rhol, ul, pl, idl, p2, rhol2, Vrare_x0)) &&
+     !(pr > p2 && ResampleTransonicRarefaction(3, rhor, ur, pr, idr, p2, rhor2, Vrare_x0)) &&
+     verbose>=1)
+    cout << "Warning: Failed to integrate the transonic rarefaction again. Using the state found by the solver."
+         << endl;
 #endif
 
   Vs[0] = Vs[1] = Vs[2] = Vs[3] = Vs[4] = 0.0;
 
+  last_left = u2>=0;
   if(trans_rare) {
+    last_region = RAREFACTION_FAN;
     Vs[0] = Vrare_x0[0];
     Vs[1] = Vrare_x0[1]*dir[0];
     Vs[2] = Vrare_x0[1]*dir[1];
@@ -435,6 +590,7 @@ ExactRiemannSolverBase::FinalizeSolution(double *dir, double *Vm, double *Vp,
 	  is_star_state = true;
       }
 
+      last_region = is_star_state ? STAR_STATE : INITIAL_STATE;
       if(is_star_state) {
 	Vs[0] = rhol2;
 	Vs[1] = u2*dir[0];
@@ -474,6 +630,7 @@ ExactRiemannSolverBase::FinalizeSolution(double *dir, double *Vm, double *Vp,
 	  is_star_state = true;
       }
 
+      last_region = is_star_state ? STAR_STATE : INITIAL_STATE;
       if(is_star_state) {
 	Vs[0] = rhor2;
 	Vs[1] = u2*dir[0];
@@ -529,7 +686,13 @@ ExactRiemannSolverBase::FinalizeSolution(double *dir, double *Vm, double *Vp,
   last++;
   sol1d.push_back(vector<double>{sol1d[last][0]+xi_span, sol1d[last][1], sol1d[last][2], sol1d[last][3], sol1d[last][4]});
 
-  FILE* solFile = fopen("RiemannSolution.txt", "w");
+  if(solution_file.empty())
+    return;
+  FILE* solFile = fopen(solution_file.c_str(), "w");
+  if(!solFile) {
+    print_error("*** Error: Cannot open file %s for output.\n", solution_file.c_str());
+    return;
+  }
   print(solFile, "## One-Dimensional Riemann Problem.\n");
   print(solFile, "## Initial State: %e %e %e, id %d (left) | (right) %e %e %e, id %d.\n", 
       rhol, ul, pl, idl, rhor, ur, pr, idr);
@@ -565,6 +728,12 @@ ExactRiemannSolverBase::FinalizeOneSidedSolution(double *dir, double *Vm,
 #if PRINT_RIEMANN_SOLUTION == 1
   // the 2-wave
   sol1d.push_back(vector<double>{u2, rhol2, u2, p2, (double)idl});
+#else
+  // integrate the transonic rarefaction again, from the initial state (see FinalizeSolution)
+  if(trans_rare && !(pl > p2 && ResampleTransonicRarefaction(1, rhol, ul, pl, idl, p2, rhol2, Vrare_x0)) &&
+     verbose>=1)
+    cout << "Warning: Failed to integrate the transonic rarefaction again. Using the state found by the solver."
+         << endl;
 #endif
 
   if(id != INVALID_MATERIAL_ID) {
@@ -640,7 +809,13 @@ ExactRiemannSolverBase::FinalizeOneSidedSolution(double *dir, double *Vm,
   double xi_span = sol1d[last][0] - sol1d[0][0];
   sol1d.insert(sol1d.begin(), vector<double>{sol1d[0][0]-xi_span, sol1d[0][1], sol1d[0][2], sol1d[0][3], sol1d[0][4]});
 
-  FILE* solFile = fopen("RiemannSolution.txt", "w");
+  if(solution_file.empty())
+    return;
+  FILE* solFile = fopen(solution_file.c_str(), "w");
+  if(!solFile) {
+    print_error("*** Error: Cannot open file %s for output.\n", solution_file.c_str());
+    return;
+  }
   print(solFile, "## One-Dimensional Riemann Problem.\n");
   print(solFile, "## Initial State: %e %e %e, id %d (left) | wall velocity: %e.\n", 
       rhol, ul, pl, idl, u2);
@@ -701,6 +876,10 @@ ExactRiemannSolverBase::FindInitialInterval(double rhol, double ul, double pl, d
     p_fmin = p1;  rhol_fmin = rhol1;  rhor_fmin = rhor1;  ul_fmin = ul1;  ur_fmin = ur1;
   }
 
+  // candidates at or below this pressure cannot be reached by (at least) one of the rarefactions
+  double p_floor = envelope ? std::max(envelope->GetIsentropicPressureFloor(idl, rhol),
+                                       envelope->GetIsentropicPressureFloor(idr, rhor)) : -DBL_MAX;
+
   for(i=0; i<maxIts_bracket; i++) {
 
     f0 = ul0 - ur0;
@@ -709,6 +888,12 @@ ExactRiemannSolverBase::FindInitialInterval(double rhol, double ul, double pl, d
     if(f0*f1<=0.0)
       return true;
 
+    // the secant method is making slow progress. Try the speculative (multi-point) search
+    if(i==10 && num_bracketing_candidates>=2 &&
+       FindInitialIntervalBySampling(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, 2, /*inputs*/
+           p0, rhol0, rhor0, ul0, ur0, p1, rhol1, rhor1, ul1, ur1/*outputs*/))
+      return true;
+
     // find a physical p2 that has the opposite sign
     if(fabs(f0-f1)>1e-9) {
       p2 = p1 - f1*(p1-p0)/(f1-f0); //the Secant method
@@ -725,6 +910,9 @@ ExactRiemannSolverBase::FindInitialInterval(double rhol, double ul, double pl, d
       p2 = 1.0e-8; 
     }
 
+    if(p2<=p_floor) //clip to the admissible range (p0 > p_floor, as it is feasible)
+      p2 = p_floor + 0.5*(p0 - p_floor);
+
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p2, idl, rhol0, rhol1, rhol2, ul2);
     // compute the 3-wave only if the 1-wave is succeeded
     success = success && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr,  p2, idr, rhor0, rhor1, rhor2, ur2);
@@ -830,7 +1018,7 @@ ExactRiemannSolverBase::FindInitialInterval(double rhol, double ul, double pl, d
   bool
 ExactRiemannSolverBase::FindInitialIntervalOneSided(double rhol, double ul, double pl, double el, double cl, int idl,
     double ustar, double &p0, double &rhol0, double &ul0, 
-    double &p1, double &rhol1, double &ul1)
+    double &p1, double &rhol1, double &ul1, double *ps_hint)
 {
 
   assert(ul>ustar); //this function is only needed (and applicable) when there is a shock
@@ -841,7 +1029,7 @@ ExactRiemannSolverBase::FindInitialIntervalOneSided(double rhol, double ul, doub
 
   // Step 1: Find two feasible points (This step should never fail)
   success = FindInitialFeasiblePointsOneSided(rhol, ul, pl, el, cl, idl, ustar, /*inputs*/
-      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/);
+      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/, ps_hint);
 
   if(!success) {//This should never happen (unless user's inputs have errors)!
     p0 = p1 = pressure_at_failure;
@@ -996,6 +1184,12 @@ ExactRiemannSolverBase::FindInitialFeasiblePoints(double rhol, double ul, double
   int found = 0;
   bool success = true;
 
+  // Method 0: Use the tabulated star pressure (if available)
+  if(atlas &&
+     FindInitialFeasiblePointsByAtlas(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, /*inputs*/
+         p0, rhol0, rhor0, ul0, ur0, p1, rhol1, rhor1, ul1, ur1/*outputs*/) == 2)
+    return true;
+
   // Method 1: Use the acoustic theory (Eqs. (20)-(22) of Kamm) to find p0, p1
   found = FindInitialFeasiblePointsByAcousticTheory(rhol, ul, pl, el, cl, idl, 
       rhor, ur, pr, er, cr, idr, /*inputs*/
@@ -1004,10 +1198,16 @@ ExactRiemannSolverBase::FindInitialFeasiblePoints(double rhol, double ul, double
   if(found==2)
     return true; //yeah
 
+  // Method 2 (if requested): evaluate a vector of candidate pressures at once
+  if(found==0 && num_bracketing_candidates>=2 &&
+     FindInitialIntervalBySampling(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, found, /*inputs*/
+         p0, rhol0, rhor0, ul0, ur0, p1, rhol1, rhor1, ul1, ur1/*outputs*/))
+    return true; //p0 < p1
+
   if(found==1) //the first one (p0) is good --> only need to find p1
     goto myLabel;
 
-  // Method 2: based on dp (fixed width search)
+  // Method 3: based on dp (fixed width search)
 
   // 2.1. find the first one (p0)
   dp = (pl!=pr) ? fabs(pl-pr) : 0.5*pl;
@@ -1144,12 +1344,500 @@ ExactRiemannSolverBase::FindInitialFeasiblePointsByAcousticTheory(double rhol, d
   return found;
 }
 
+//----------------------------------------------------------------------------------
+/** Initializes p0 and p1 around the star pressure interpolated from the atlas, i.e.
+ * p0 = (1-delta)*p_atlas, p1 = (1+delta)*p_atlas. Returns 2 if both points are feasible, and 0
+ * otherwise (including when the atlas does not cover this problem). In that case, the caller falls
+ * back to the acoustic theory.
+ */
+  int
+ExactRiemannSolverBase::FindInitialFeasiblePointsByAtlas(double rhol, double ul, double pl, double cl, int idl,
+    double rhor, double ur, double pr, double cr, int idr, /*inputs*/
+    double &p0, double &rhol0, double &rhor0, double &ul0, double &ur0,
+    double &p1, double &rhol1, double &rhor1, double &ul1, double &ur1/*outputs*/)
+{
+  double ps;
+  if(!atlas->GetStarPressure(rhol, ul, pl, cl, idl, rhor, ur, pr, cr, idr, ps) || ps<=min_pressure)
+    return 0;
+
+  const double delta = 0.02; //roughly the interpolation error of the default atlas (perfect gases)
+  p0 = (1.0 - delta)*ps;
+  p1 = (1.0 + delta)*ps;
+
+  bool success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p1, idl,
+                     rhol, (p1>pl) ? rhol*1.1 : rhol*0.9, rhol1, ul1);
+  success = success && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p1, idr,
+                     rhor, (p1>pr) ? rhor*1.1 : rhor*0.9, rhor1, ur1);
+  if(!success)
+    return 0;
+
+  // p0 < p1: the rarefaction integrations (if any) continue from p1
+  success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p0, idl, rhol, rhol1, rhol0, ul0);
+  success = success && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p0, idr, rhor, rhor1, rhor0, ur0);
+
+  return success ? 2 : 0;
+}
+
+//----------------------------------------------------------------------------------
+/** Speculative search for a bracketing interval, used in place of the serial probes of
+ * FindInitialFeasiblePoints (if the acoustic estimate is not feasible), and when the secant search
+ * in FindInitialInterval makes slow progress.
+ * The star relation f(p) = ul*(p) - ur*(p) is evaluated at a vector of candidates, log-spaced between
+ * 1e-3*min(pl, pr, p_acoustic) and 10*max(pl, pr, p_acoustic), and the narrowest interval in which f
+ * changes sign is selected. The candidates are visited from high to low pressure, so each rarefaction
+ * integration continues from the end point of the previous one (integrationPath). If f does not
+ * change sign, a second round extends the range upwards (f > 0 everywhere), or down to
+ * max(pressure_at_failure, min_pressure) (f < 0 everywhere). Candidates at which the wave curves
+ * cannot be computed are skipped.
+ */
+  bool
+ExactRiemannSolverBase::FindInitialIntervalBySampling(double rhol, double ul, double pl, double cl, int idl,
+    double rhor, double ur, double pr, double cr, int idr, int nknown, /*inputs*/
+    double &p0, double &rhol0, double &rhor0, double &ul0, double &ur0,
+    double &p1, double &rhol1, double &rhor1, double &ul1, double &ur1/*outputs*/)
+{
+  int n = num_bracketing_candidates;
+  if(n<2)
+    return false;
+
+  bracket_samples.clear();
+  if(nknown>=1)
+    bracket_samples.push_back(std::vector<double>{p0, rhol0, rhor0, ul0, ur0});
+  if(nknown>=2)
+    bracket_samples.push_back(std::vector<double>{p1, rhol1, rhor1, ul1, ur1});
+
+  // range of the first round
+  double Cl = rhol*cl, Cr = rhor*cr; //acoustic impedances
+  double p_ac = (Cr*pl + Cl*pr + Cl*Cr*(ul - ur))/(Cl + Cr);
+  double phi = 10.0*std::max(std::max(pl, pr), p_ac);
+  if(phi<=0.0)
+    return false; //log-spacing not applicable. Use the serial search
+  double pfloor = std::max(pressure_at_failure, min_pressure); //lowest candidate (2nd round)
+  if(pfloor<=0.0 || pfloor>=phi)
+    pfloor = 1.0e-8*phi;
+  double pmin = std::min(std::min(pl, pr), p_ac);
+  double plo = std::max(pfloor, (pmin>0.0 ? 1.0e-3*pmin : 1.0e-6*phi)); //deep rarefactions are expensive
+  if(plo>=phi)
+    plo = pfloor;
+
+  double p, rhol2, rhor2, ul2, ur2;
+  bool success;
+  int kmin = 0, kmax = n-1; //candidate k: plo*(phi/plo)^(k/kmax)
+
+  for(int round=0; round<2; round++) {
+
+    for(int k=kmax; k>=kmin; k--) {
+      p = plo*pow(phi/plo, (double)k/kmax);
+      success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p, idl,
+          rhol, (p>pl) ? rhol*1.1 : rhol*0.9, rhol2, ul2);
+      success = success && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p, idr,
+          rhor, (p>pr) ? rhor*1.1 : rhor*0.9, rhor2, ur2);
+      if(success)
+        bracket_samples.push_back(std::vector<double>{p, rhol2, rhor2, ul2, ur2});
+    }
+
+    if(bracket_samples.size()<2)
+      return false;
+
+    std::sort(bracket_samples.begin(), bracket_samples.end(),
+              [](const std::vector<double> &a, const std::vector<double> &b) {return a[0]<b[0];});
+
+    // the narrowest interval with a sign change
+    int best = -1;
+    double fa, fb, width = DBL_MAX;
+    int nneg = 0;
+    for(int i=0; i<(int)bracket_samples.size(); i++) {
+      fb = bracket_samples[i][3] - bracket_samples[i][4];
+      if(fb<0.0)
+        nneg++;
+      if(i==0)
+        continue;
+      fa = bracket_samples[i-1][3] - bracket_samples[i-1][4];
+      if(fa*fb<=0.0 && bracket_samples[i][0]-bracket_samples[i-1][0]<width) {
+        width = bracket_samples[i][0] - bracket_samples[i-1][0];
+        best = i-1;
+      }
+    }
+
+    if(best>=0) {
+      std::vector<double> &s0(bracket_samples[best]), &s1(bracket_samples[best+1]);
+      p0 = s0[0];  rhol0 = s0[1];  rhor0 = s0[2];  ul0 = s0[3];  ur0 = s0[4];
+      p1 = s1[0];  rhol1 = s1[1];  rhor1 = s1[2];  ul1 = s1[3];  ur1 = s1[4];
+#if PRINT_RIEMANN_SOLUTION == 1
+      fprintf(stdout, "Speculative bracketing (%d samples): p0 = %e, f0 = %e, p1 = %e, f1 = %e.\n",
+              (int)bracket_samples.size(), p0, ul0-ur0, p1, ul1-ur1);
+#endif
+      return true;
+    }
+
+    // second round (plo or phi is not repeated)
+    if(nneg==0) { //p* > phi
+      plo  = phi;
+      phi *= 1.0e4;
+      kmin = 1;
+      kmax = n;
+    } else if(pfloor<plo) { //p* < plo
+      phi  = plo;
+      plo  = pfloor;
+      kmin = 0;
+      kmax = n;
+    } else
+      return false;
+  }
+
+  return false;
+}
+
+//----------------------------------------------------------------------------------
+/** Linearized Riemann solver for weak jumps, i.e. |pl-pr|/(rho*c^2) and |ul-ur|/c below
+ * acoustic_threshold. Along each wave, du = -+dp/(rho*c) and drho = dp/c^2 (the Hugoniot and the
+ * isentrope agree to second order in dp). The predictor uses the impedances of the initial
+ * states (as in FindInitialFeasiblePointsByAcousticTheory). The corrector integrates these relations
+ * by the trapezoidal rule, using the sound speed at the predicted star states, which makes the star
+ * state second-order accurate in the jumps. Returns false (i.e. the exact solver must be used) if
+ * the jumps are above the threshold, the predicted state is non-physical, or the 1- or 3-wave may
+ * be a transonic rarefaction.
+ */
+bool
+ExactRiemannSolverBase::ComputeLinearizedStarState(double rhol, double ul, double pl, double cl, int idl,
+                                                   double rhor, double ur, double pr, double cr, int idr,
+                                                   double &rhol2, double &rhor2, double &u2, double &p2)
+{
+  if(fabs(pl - pr) > acoustic_threshold*std::min(rhol*cl*cl, rhor*cr*cr) ||
+     fabs(ul - ur) > acoustic_threshold*std::min(cl, cr))
+    return false;
+
+  // predictor
+  double Cl = rhol*cl, Cr = rhor*cr; //acoustic impedances
+  double ps = (Cr*pl + Cl*pr + Cl*Cr*(ul - ur))/(Cl + Cr);
+  double rhols = rhol + (ps - pl)/(cl*cl);
+  double rhors = rhor + (ps - pr)/(cr*cr);
+  if(rhols<=0 || rhors<=0)
+    return false;
+
+  double cls = vf[idl]->ComputeSoundSpeedSquare(rhols, vf[idl]->GetInternalEnergyPerUnitMass(rhols, ps));
+  double crs = vf[idr]->ComputeSoundSpeedSquare(rhors, vf[idr]->GetInternalEnergyPerUnitMass(rhors, ps));
+  if(cls<=0 || crs<=0)
+    return false;
+  cls = sqrt(cls);
+  crs = sqrt(crs);
+
+  // corrector (trapezoidal rule)
+  Cl = 0.5*(Cl + rhols*cls);
+  Cr = 0.5*(Cr + rhors*crs);
+  p2 = (Cr*pl + Cl*pr + Cl*Cr*(ul - ur))/(Cl + Cr);
+  u2 = (Cl*ul + Cr*ur + pl - pr)/(Cl + Cr);
+  rhol2 = rhol + 0.5*(p2 - pl)*(1.0/(cl*cl) + 1.0/(cls*cls));
+  rhor2 = rhor + 0.5*(p2 - pr)*(1.0/(cr*cr) + 1.0/(crs*crs));
+  if(rhol2<=0 || rhor2<=0)
+    return false;
+
+  // (near-)transonic rarefaction: x = 0 may be inside the fan. The band of characteristic speeds
+  // is widened by its own width to account for the error in cls and crs.
+  if(p2<pl) {
+    double a = ul - cl, b = u2 - cls, w = fabs(a - b);
+    if(std::min(a,b) - w < 0.0 && std::max(a,b) + w > 0.0)
+      return false;
+  }
+  if(p2<pr) {
+    double a = ur + cr, b = u2 + crs, w = fabs(a - b);
+    if(std::min(a,b) - w < 0.0 && std::max(a,b) + w > 0.0)
+      return false;
+  }
+
+  return true;
+}
+
+//-----------------------------------------------------
+
+bool
+ExactRiemannSolverBase::ResampleTransonicRarefaction(int wavenumber, double rho, double u, double p, int id,
+                                                     double ps, double rhos, double Vrare_x0[3])
+{
+  std::vector<std::vector<double> > path(1, std::vector<double>{p, rho, u});
+  double rhos_tmp, us_tmp, V[3];
+  bool found = false;
+  if(!ComputeRhoUStar(wavenumber, path, rho, u, p, ps, id, rhos, 0.9*rhos, rhos_tmp, us_tmp, &found, V) || !found)
+    return false;
+
+  for(int i=0; i<3; i++)
+    Vrare_x0[i] = V[i];
+  return true;
+}
+
+//----------------------------------------------------------------------------------
+/** Cheap test of the wave pattern. Returns -1 (or 1) if the solution at xi = 0 is *provably* the
+ * left (or right) initial state, i.e. the 1-wave (or 3-wave) moves entirely to the right (or left).
+ * Returns 0 otherwise (undetermined). Take the 1-wave as an example: if p* <= pl, it is a
+ * rarefaction with head speed ul - cl; if p* > pl, it is a shock, whose speed decreases as p*
+ * increases. So it suffices to find an upper bound p_h >= p* (i.e. ul(p_h) <= ur(p_h)) such that the
+ * 1-wave speed at p_h is positive. p_h is set to pl if the acoustic estimate of p* is below pl;
+ * otherwise it is the acoustic estimate plus a margin. At most two wave-curve evaluations are needed,
+ * and none if the flow is subsonic on both sides (which is checked first).
+ */
+int
+ExactRiemannSolverBase::FindUpwindInitialState(double rhol, double ul, double pl, double cl, int idl,
+                                               double rhor, double ur, double pr, double cr, int idr)
+{
+  bool left_candidate  = ul - cl > 0.0;
+  bool right_candidate = ur + cr < 0.0;
+  if(!left_candidate && !right_candidate)
+    return 0;
+
+  // acoustic estimate of p*
+  double Cl = rhol*cl, Cr = rhor*cr; //acoustic impedances
+  double p_ac = (Cr*pl + Cl*pr + Cl*Cr*(ul - ur))/(Cl + Cr);
+
+  double rhol_h(rhol), ul_h(ul), rhor_h(rhor), ur_h(ur);
+
+  if(left_candidate) {
+    if(p_ac <= pl) { // try to show p* <= pl (1-wave is a rarefaction or vanishes)
+      if(ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, pl, idr, rhor, (pl>pr) ? rhor*1.1 : rhor*0.9,
+                         rhor_h, ur_h) && ul <= ur_h)
+        return -1;
+    } 
+    else { // try to show that the 1-shock moves to the right
+      double p_h = 2.0*p_ac - std::min(pl, pr);
+      if(ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p_h, idl, rhol, rhol*1.1, rhol_h, ul_h) &&
+         ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p_h, idr, rhor, (p_h>pr) ? rhor*1.1 : rhor*0.9,
+                         rhor_h, ur_h) && ul_h <= ur_h &&
+         (rhol_h*ul_h - rhol*ul)/(rhol_h - rhol) > 0.0) //shock speed at p_h
+        return -1;
+    }
+  }
+
+  if(right_candidate) {
+    if(p_ac <= pr) { // try to show p* <= pr (3-wave is a rarefaction or vanishes)
+      if(ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, pr, idl, rhol, (pr>pl) ? rhol*1.1 : rhol*0.9,
+                         rhol_h, ul_h) && ul_h <= ur)
+        return 1;
+    }
+    else { // try to show that the 3-shock moves to the left
+      double p_h = 2.0*p_ac - std::min(pl, pr);
+      if(ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p_h, idl, rhol, (p_h>pl) ? rhol*1.1 : rhol*0.9,
+                         rhol_h, ul_h) &&
+         ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p_h, idr, rhor, rhor*1.1, rhor_h, ur_h) &&
+         ul_h <= ur_h &&
+         (rhor_h*ur_h - rhor*ur)/(rhor_h - rhor) < 0.0) //shock speed at p_h
+        return 1;
+    }
+  }
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------------
+/** Vacuum/cavitation detection. The star pressure cannot be lower than the floor
+ *   pf = max(pmin_l, pmin_r, p_vac_l + pressure_at_failure, p_vac_r + pressure_at_failure,
+ *            p_l(rhomin_l), p_r(rhomin_r)),
+ * where pmin is the pressure cut-off of each material, p_vac = -pc the vacuum pressure of (Noble-Abel)
+ * stiffened gases, and p_K(rhomin_K) the pressure at the density cut-off (if rhomin_K > 0) along the
+ * isentrope through the initial state (closed form for stiffened gases, integrated for other EOS).
+ * (min_pressure is not a floor --- it only guides the search.) For EOS other than stiffened gases, the
+ * vacuum pressure is not known in closed form and not included. So, if neither material is a stiffened gas
+ * and the cut-offs are not set (default: pmin = -DBL_MAX, rhomin = 0), no floor exists and a vacuum is not
+ * detected here (the iterative solver handles the problem as before).
+ * Since ul*(p) - ur*(p) decreases with p, there is no solution if ul*(pf) <= ur*(pf), i.e., the left fluid
+ * cannot catch up with the right fluid even if both expand to the floor. The velocity change across each
+ * rarefaction is given by the Riemann invariant for stiffened gases (u + 2c(1-b*rho)/(gam-1)), and bounded
+ * from below by the acoustic approximation (pK - pf)/(rhoK*cK) for other EOS (rho*c decreases along an
+ * isentrope). If the waves meet with these velocity changes, they meet above pf. Otherwise, the isentropes
+ * of the other EOS are integrated to pf. Cheap (a few flops) in all the other cases.
+ */
+int
+ExactRiemannSolverBase::FindVacuumState(double rhol, double ul, double pl, double el, double cl, int idl,
+                                        double rhor, double ur, double pr, double er, double cr, int idr,
+                                        double &pf, double &rhol2, double &ul2, double &rhor2, double &ur2,
+                                        bool &trans_rare, double *Vrare_x0)
+{
+  if(ur <= ul) //the two waves cannot both be rarefactions
+    return 0;
+
+  pf = std::max(vf[idl]->pmin, vf[idr]->pmin);
+  bool vacuum = false; //true: pf is (slightly above) a vacuum pressure, false: a cut-off
+
+  double gl, pcl, bl, gr, pcr, br;
+  bool sgl = vf[idl]->GetStiffenedGasParameters(gl, pcl, bl);
+  bool sgr = vf[idr]->GetStiffenedGasParameters(gr, pcr, br);
+  if(sgl) {
+    double p_vac = -pcl + std::max(pressure_at_failure, 1.0e-12*pcl); //representable (> -pc)
+    if(p_vac >= pf) {
+      pf = p_vac;
+      vacuum = true;
+    }
+    double rhomin = vf[idl]->rhomin;
+    if(rhomin>0.0 && rhomin<rhol) { //isentrope: (p+pc)(1/rho-b)^gam = const
+      double p_rhomin = -pcl + (pl + pcl)*pow((1.0/rhol - bl)/(1.0/rhomin - bl), gl);
+      if(p_rhomin > pf) {
+        pf = p_rhomin;
+        vacuum = false;
+      }
+    }
+  } else {
+    double rhomin = vf[idl]->rhomin, p_rhomin;
+    if(rhomin>0.0 && rhomin<rhol && ComputeIsentropicPressure(idl, rhol, el, rhomin, p_rhomin) && p_rhomin > pf) {
+      pf = p_rhomin;
+      vacuum = false;
+    }
+  }
+  if(sgr) {
+    double p_vac = -pcr + std::max(pressure_at_failure, 1.0e-12*pcr);
+    if(p_vac >= pf) {
+      pf = p_vac;
+      vacuum = true;
+    }
+    double rhomin = vf[idr]->rhomin;
+    if(rhomin>0.0 && rhomin<rhor) {
+      double p_rhomin = -pcr + (pr + pcr)*pow((1.0/rhor - br)/(1.0/rhomin - br), gr);
+      if(p_rhomin > pf) {
+        pf = p_rhomin;
+        vacuum = false;
+      }
+    }
+  } else {
+    double rhomin = vf[idr]->rhomin, p_rhomin;
+    if(rhomin>0.0 && rhomin<rhor && ComputeIsentropicPressure(idr, rhor, er, rhomin, p_rhomin) && p_rhomin > pf) {
+      pf = p_rhomin;
+      vacuum = false;
+    }
+  }
+
+  if(pf == -DBL_MAX || pf >= pl || pf >= pr) //no floor, or not two rarefactions
+    return 0;
+
+  double dul = sgl ? 2.0*cl*(1.0 - bl*rhol)/(gl - 1.0)*(1.0 - pow((pf + pcl)/(pl + pcl), 0.5*(gl - 1.0)/gl))
+                   : (pl - pf)/(rhol*cl);
+  double dur = sgr ? 2.0*cr*(1.0 - br*rhor)/(gr - 1.0)*(1.0 - pow((pf + pcr)/(pr + pcr), 0.5*(gr - 1.0)/gr))
+                   : (pr - pf)/(rhor*cr);
+  if(ul + dul > ur - dur)
+    return 0; //the two rarefactions meet above pf (dul and dur are not larger than the exact values)
+
+  // states at the floor. For stiffened gases, they are computed in closed form (the numerical integration
+  // loses accuracy as p approaches the vacuum), and the isentrope is integrated only for a transonic
+  // rarefaction (to find the state at xi = 0).
+  bool tr = false;
+  double Vx[3], rho_tmp, u_tmp;
+  if(sgl) {
+    rhol2 = 1.0/(bl + (1.0/rhol - bl)*pow((pl + pcl)/(pf + pcl), 1.0/gl));
+    ul2   = ul + dul;
+    double cl2 = sqrt(gl*(pf + pcl)/(rhol2*(1.0 - bl*rhol2)));
+    if(ul - cl < 0.0 && ul2 - cl2 > 0.0 &&
+       (!ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, pf, idl, rhol, rhol*0.9, rho_tmp, u_tmp, &tr, Vx) || !tr))
+      return 0;
+  } else if(!ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, pf, idl, rhol, rhol*0.9, rhol2, ul2, &tr, Vx))
+    return 0; //the isentrope cannot be continued to pf (let the iterative solver handle it)
+
+  if(sgr) {
+    rhor2 = 1.0/(br + (1.0/rhor - br)*pow((pr + pcr)/(pf + pcr), 1.0/gr));
+    ur2   = ur - dur;
+    double cr2 = sqrt(gr*(pf + pcr)/(rhor2*(1.0 - br*rhor2)));
+    if(ur + cr > 0.0 && ur2 + cr2 < 0.0 &&
+       (!ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, pf, idr, rhor, rhor*0.9, rho_tmp, u_tmp, &tr, Vx) || !tr))
+      return 0;
+  } else if(!ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, pf, idr, rhor, rhor*0.9, rhor2, ur2, &tr, Vx))
+    return 0;
+
+  if(ul2 > ur2)
+    return 0;
+
+  trans_rare = tr;
+  if(tr)
+    for(int i=0; i<3; i++)
+      Vrare_x0[i] = Vx[i];
+
+  return vacuum ? 2 : 3;
+}
+
+//----------------------------------------------------------------------------------
+//! Pressure at density rhos (< rho) along the isentrope through (rho, e): de/drho = p/rho^2, integrated by
+//! RK4 in log(rho) with a fixed number of steps (the result is only used as a pressure floor). Returns
+//! false if the isentrope leaves the admissible region of the EOS (c^2 <= 0) before reaching rhos.
+  bool
+ExactRiemannSolverBase::ComputeIsentropicPressure(int id, double rho, double e, double rhos, double &ps)
+{
+  VarFcnBase *vf_ = vf[id];
+  const int nSteps = 32;
+  double h = log(rhos/rho)/nSteps; //step in s = log(rho)
+  auto dedS = [&](double r, double e_) {return vf_->GetPressure(r, e_)/r;}; //de/ds = p/rho
+
+  double r = rho;
+  for(int n=0; n<nSteps; n++) {
+    double r1 = r*exp(0.5*h), r2 = r*exp(h);
+    double k1 = dedS(r, e);
+    double k2 = dedS(r1, e + 0.5*h*k1);
+    double k3 = dedS(r1, e + 0.5*h*k2);
+    double k4 = dedS(r2, e + h*k3);
+    e += h/6.0*(k1 + 2.0*k2 + 2.0*k3 + k4);
+    r = r2;
+    double c2 = vf_->ComputeSoundSpeedSquare(r, e);
+    if(!std::isfinite(e) || !(c2>0.0))
+      return false;
+  }
+
+  ps = vf_->GetPressure(rhos, e);
+  return std::isfinite(ps);
+}
+
+//----------------------------------------------------------------------------------
+/** The vacuum (or cavitated) region is bounded by the tails of the two rarefactions, moving at ul2 and
+ * ur2 (ul2 < ur2). If xi = 0 is outside this region, the solution is sampled as in FinalizeSolution.
+ * Otherwise, the state at the nearer edge is returned (the pressure is pf, and the density is close
+ * to zero in the case of a vacuum). The EOS is not called, as the star states may be (nearly) vacuum.
+ */
+void
+ExactRiemannSolverBase::FinalizeVacuumSolution(double *dir, double *Vm, double *Vp,
+    double rhol, double ul, double pl, double cl, int idl, 
+    double rhor, double ur, double pr, double cr, int idr, 
+    double rhol2, double rhor2, double ul2, double ur2, double pf,
+    bool trans_rare, double Vrare_x0[3], /*inputs*/
+    double *Vs, int &id, double *Vsm, double *Vsp /*outputs*/)
+{
+  double utanl[3] = {Vm[1]-ul*dir[0], Vm[2]-ul*dir[1], Vm[3]-ul*dir[2]};
+  double utanr[3] = {Vp[1]-ur*dir[0], Vp[2]-ur*dir[1], Vp[3]-ur*dir[2]};
+
+  // the star states move at different velocities
+  Vsm[0] = rhol2;
+  Vsp[0] = rhor2;
+  for(int i=0; i<3; i++) {
+    Vsm[i+1] = utanl[i] + ul2*dir[i];
+    Vsp[i+1] = utanr[i] + ur2*dir[i];
+  }
+  Vsm[4] = Vsp[4] = pf;
+
+  bool left = ul2 >= 0.0 || (ur2 > 0.0 && -ul2 <= ur2); //xi = 0 is on the left of the region, or closer to its left edge
+  id = left ? idl : idr;
+  double *utan = left ? utanl : utanr;
+
+  last_left = left;
+  if(trans_rare) {
+    last_region = RAREFACTION_FAN;
+    Vs[0] = Vrare_x0[0];
+    for(int i=0; i<3; i++)
+      Vs[i+1] = utan[i] + Vrare_x0[1]*dir[i];
+    Vs[4] = Vrare_x0[2];
+  }
+  else if((left && ul - cl >= 0.0) || (!left && ur + cr <= 0.0)) { //rarefaction head
+    last_region = INITIAL_STATE;
+    for(int i=0; i<5; i++)
+      Vs[i] = left ? Vm[i] : Vp[i];
+  }
+  else {
+    last_region = STAR_STATE;
+    for(int i=0; i<5; i++)
+      Vs[i] = left ? Vsm[i] : Vsp[i];
+  }
+
+#if PRINT_RIEMANN_SOLUTION == 1
+  std::cout << "Vacuum/cavitated region: xi = [" << ul2 << ", " << ur2 << "], p = " << pf << "." << std::endl;
+#endif
+}
+
 //----------------------------------------------------------------------------------
 
   int
 ExactRiemannSolverBase::FindInitialFeasiblePointsOneSidedByAcousticTheory(double rhol, double ul, 
     double pl, [[maybe_unused]] double el, double cl, int idl, double ustar,
-    double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1)
+    double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1, double *ps_hint)
 {
 
   assert(ul>ustar); //only needed in the case of a shock
@@ -1157,9 +1845,10 @@ ExactRiemannSolverBase::FindInitialFeasiblePointsOneSidedByAcousticTheory(double
   int found = 0;
   bool success = true;
 
-  // 1.1: Initialize p0 using acoustic theory ((20) of Kamm)
+  // 1.1: Initialize p0 using acoustic theory ((20) of Kamm), or the given estimate. A shock requires p* > pl,
+  //      so an estimate p* <= pl (e.g., from a previous time step with a rarefaction) is not used.
   double Cl = rhol*cl; //acoustic impedance
-  p0 = pl + Cl*(ul - ustar);
+  p0 = (ps_hint && *ps_hint > pl) ? *ps_hint : pl + Cl*(ul - ustar);
 
   success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p0, idl/*inputs*/,
       rhol, (p0>pl) ? rhol*1.1 : rhol*0.9/*initial guesses for Hugo. eq.*/,
@@ -1210,11 +1899,15 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
 
   if(p > ps) {//rarefaction --- numerical integration
 
+    if(envelope && ps <= envelope->GetIsentropicPressureFloor(id, rho))
+      return false; //the isentrope leaves the admissible region before reaching ps
+
     // prepare for numerical integration
     double rhos_0 = rho, us_0 = u, ps_0 = p, xi_0; //start point of each step
     double rhos_1 = rho, us_1 = u, ps_1 = p, xi_1; //end point of each step
     double dp = (p-ps)/numSteps_rarefaction;  // initial step size
     double dp_min_adaption = dp / 2.5;
+    bool integrate_e = vf[id]->HasIterativeInverse(); //if true, integrate (rho,e,u) to avoid calling e(rho,p)
     double pressure_endpoint_tol = tol_rarefaction * std::max( 1.0, fabs(p) );
 
     double e = vf[id]->GetInternalEnergyPerUnitMass(rho,p);
@@ -1227,6 +1920,9 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
     } else
       c = sqrt(c);
 
+    double es_0 = e, es_1 = e; //only used if integrate_e == true
+    double dpdrho_0 = c*c; //dp/drho along the isentrope at the start point (only used with the envelope)
+
     int index0 = 0; // index of new starting point
     // find the new starting point, and update dp accordingly
     if (integrationPath.size() > 1) { 
@@ -1246,6 +1942,10 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
 	dp = std::min( integrationPath[index0-1][0]-integrationPath[index0][0], ps_0-ps );
 	// dp = ps_0-ps;
       }
+      if(integrate_e && index0>0)
+        es_0 = vf[id]->GetInternalEnergyPerUnitMass(rhos_0, ps_0);
+      if(index0>0 && integrationPath[index0-1][1] != rhos_0)
+        dpdrho_0 = (integrationPath[index0-1][0] - ps_0)/(integrationPath[index0-1][1] - rhos_0);
     }
 
     double xi = (wavenumber == 1) ? u - c : u + c; // xi = u -/+ c
@@ -1261,6 +1961,7 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
     double uErr = 0.;
     double rhoErr = 0.;
     int moreSteps = 3;
+    int envelope_cuts = 0; //step cuts by the envelope (counted separately, not as RK steps)
 
     for(int i=0; i<numSteps_rarefaction*moreSteps; i++) {
       // Check if we have reached the final pressure ps
@@ -1282,10 +1983,26 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
 	break; //done!
       }
 
-      bool success = Rarefaction_OneStepRK4(wavenumber/*1 or 3*/, id,
-	  rhos_0, us_0, ps_0 /*start state*/, dp /*step size*/,
-	  rhos_1, us_1, ps_1, xi_1 /*output: end state*/,
-	  uErr, rhoErr /*output: absolute error in us*/);
+      if(envelope) { //predict the end point of this step. If it is not admissible, shrink the step
+        double rhos_pred = rhos_0 - dp/dpdrho_0;
+        if(!(rhos_pred>0.0) || ps_0 - dp <= envelope->GetMinimumPressure(id, rhos_pred)) {
+          if(++envelope_cuts > 60) //dp has underflowed relative to ps_0
+            break;
+          dp = dp/2.0;
+          i--;
+          continue;
+        }
+      }
+
+      bool success = integrate_e ?
+          Rarefaction_OneStepRK4_RhoE(wavenumber/*1 or 3*/, id,
+	    rhos_0, us_0, ps_0, es_0 /*start state*/, dp /*step size*/,
+	    rhos_1, us_1, ps_1, es_1, xi_1 /*output: end state*/,
+	    uErr, rhoErr /*output: absolute error in us*/) :
+          Rarefaction_OneStepRK4(wavenumber/*1 or 3*/, id,
+	    rhos_0, us_0, ps_0 /*start state*/, dp /*step size*/,
+	    rhos_1, us_1, ps_1, xi_1 /*output: end state*/,
+	    uErr, rhoErr /*output: absolute error in us*/);
 
       //      fprintf(stdout,"RK4 step: rhos_0 = %e, us_0 = %e, ps_0 = %e, drho = %e, rhos_1 = %e, us_1 = %e, ps_1 = %e | ps = %e | success = %d.\n",
       //              rhos_0, us_0, ps_0, drho, rhos_1, us_1, ps_1, ps, success);
@@ -1383,9 +2100,12 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
       dpTemp = std::max(dpTemp, dp_min_adaption);
       dp = std::min(dpTemp, ps_1-ps); //don't go beyond ps
 
+      if(rhos_1 != rhos_0)
+        dpdrho_0 = (ps_0 - ps_1)/(rhos_0 - rhos_1);
       rhos_0 = rhos_1;
       us_0   = us_1;
       ps_0   = ps_1;
+      es_0   = es_1;
       xi_0   = xi_1;
     }
 
@@ -1408,178 +2128,13 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
 
   else {// shock (p<=ps, rho<=rhos)
 
-    HugoniotEquation hugo(vf[id],rho,p,ps);
-
-    //find a bracketing interval
-    double f0, f1;
-    double drho = std::max(fabs(rhos0 - rhos1), 0.001*rhos0); 
-    bool found_rhos0 = false, found_rhos1 = false;
-    if(std::min(rhos0,rhos1)>=rho) {//both rhos0 and rhos1 are physically admissible
-      f0 = hugo(rhos0);
-      f1 = hugo(rhos1);
-      if(f0*f1<=0) {
-	/*found bracketing interval [rhos0, rhos1]*/
-	if(rhos0>rhos1) {
-	  std::swap(rhos0,rhos1);
-	  std::swap(f0,f1);
-	}
-	found_rhos0 = found_rhos1 = true;
-      } else {
-	rhos0 = rhos1; //this is our starting point (presumably rhos1 is closer to sol'n)
-	f0    = f1; 
-      }
-    } else { //at least, the smaller one among rhos0, rhos1 is non-physical
-      if(rhos1>rhos0) {
-	rhos0 = rhos1; 
-	f0    = hugo(rhos0);
-      }
-      if(rhos0<rho) {//this one is also non-physical
-	rhos0 = rho;
-	f0    = hugo(rhos0);
-	found_rhos0 = true;
-      } else {
-	/*rhos0 = rhos0;*/
-	f0 = hugo(rhos0);
-      }
-    } 
-
-    if(!found_rhos0 || !found_rhos1) {
-      int i = 0;
-      double factor = 1.5; 
-      double tmp, ftmp;
-      // before the search, rhos0 = rhos1 = an adimissible point > rho
-      rhos1 = rhos0;
-      f1    = f0;
-      while(!found_rhos0) {
-	if(++i>=maxIts_shock) {
-	  //          cout << "*** Error: Unable to find a bracketing interval after " << maxIts_shock 
-	  //               << " iterations (in the solution of the Hugoniot equation)." << endl;
-	  return false;
-	}
-	tmp = rhos1;
-	ftmp = f1;
-	//move to the left (towards rho)
-	rhos1 = rhos0;
-	f1    = f0;
-	rhos0 = rhos1 - factor*drho;
-	if(rhos0<=rho) {
-	  rhos0 = rho;
-	  found_rhos0 = true;
-	}
-	f0 = hugo(rhos0);
-
-	if(f0*f1<=0) {
-	  found_rhos0 = found_rhos1 = true;
-	} else {
-	  //move to the right
-	  rhos1 = tmp;
-	  f1    = ftmp;
-	  tmp   = rhos0; //don't forget the smallest point
-	  ftmp  = f0;
-	  rhos0 = rhos1;
-	  f0    = f1;
-	  rhos1 = rhos0 + factor*drho;
-	  f1 = hugo(rhos1);
-	  if(f0*f1<=0) {
-	    found_rhos0 = found_rhos1 = true;
-	  } else {
-	    rhos0 = tmp;
-	    f0    = ftmp;
-	    drho  = rhos1 - rhos0; //update drho
-	  }
-	}
-      }
-
-      if(!found_rhos1) {//keep moving to the right
-	i = 0;
-	double factor = 2.5;
-	while(!found_rhos1) {
-	  if(++i>=maxIts_shock) {
-	    //            cout << "*** Error: Unable to find a bracketing interval after " << maxIts_shock 
-	    //                 << " iterations (in the solution of the Hugoniot equation (2))." << endl;
-	    return false; //failure
-	  }
-	  rhos0 = rhos1;
-	  f0    = f1;
-	  rhos1 = rhos0 + factor*drho;
-	  f1    = hugo(rhos1);
-	  if(f0*f1<=0) {
-	    found_rhos1 = true;
-	  } else
-	    drho = rhos1 - rhos0;
-	}
-      }
-
-    }
-
-    pair<double,double> sol;
-    double loc_tol_shock = tol_shock*std::min(rhos0,rhos1);
-#ifndef WITHOUT_BOOST
-    //*******************************************************************
-    // Calling boost function for root-finding
-    // Warning: "maxit" is BOTH AN INPUT AND AN OUTPUT
-    boost::uintmax_t maxit = maxIts_shock;
-    if(f0==0.0)
-      sol.first = sol.second = rhos0;
-    else if(f1==0.0)
-      sol.first = sol.second = rhos1;
-    else {
-      sol = toms748_solve(hugo, rhos0, rhos1, f0, f1,
-	  [=](double r0, double r1){return r1-r0<std::min(loc_tol_shock,0.001*(rhos1-rhos0));}, 
-	  maxit);
-    }
-    //*******************************************************************
-#else
-    //*******************************************************************
-    // Using a hybrid (Brent) method for root-finding
-    int maxit = 0;
-    if(f0==0.0)
-      sol.first = sol.second = rhos0;
-    else if(f1==0.0)
-      sol.first = sol.second = rhos1;
-    else {
-      double rhos2 = rhos1; //rhos2 is always the latest one
-      double f2    = f1;
-      int it;
-      for(it = 0; it<maxIts_shock; it++) {
-	drho = rhos1 - rhos0;
-	rhos2 = rhos2 - f2*(rhos1 - rhos0)/(f1 - f0); //secant method
-	if(rhos2 >= rhos1 || rhos2 <= rhos0) //discard and switch to bisection
-	  rhos2 = 0.5*(rhos0+rhos1);
-	f2 = hugo(rhos2);
-	if(f2==0.0) {
-	  sol.first = sol.second = rhos2;
-	  break;
-	}
-	if(f2*f0<0) {
-	  rhos1 = rhos2;
-	  f1    = f2;
-	} else {
-	  rhos0 = rhos2;
-	  f0    = f2;
-	}
-	if(rhos1-rhos0<loc_tol_shock) {
-	  sol.first  = rhos0;
-	  sol.second = rhos1;
-	  break;
-	}
-      }
-      if(it==maxIts_shock) {
-	fprintf(stdout,"*** Error: Root-finding method failed to converge after %d iterations.\n", it);
-	return false;
-      }
-      maxit = it;
-    }
-    //*******************************************************************
-#endif
-
-
-#if PRINT_RIEMANN_SOLUTION == 1
-    cout << "  " << wavenumber << "-wave: shock, converged in " << maxit << " iterations. fun = " 
-      << hugo(0.5*(sol.first+sol.second)) << "." << endl;
-#endif
-
-    rhos = 0.5*(sol.first+sol.second);
+    // Newton's method is used only where it was measured to be faster than bracketing + toms748 (counting
+    // all the EOS calls): JWL, without an admissible initial guess.
+    bool newton = vf[id]->type == VarFcnBase::JWL && std::max(rhos0, rhos1) <= rho;
+    if(!vf[id]->SolveHugoniotDensity(rho, p, ps, rhos) && //no closed-form solution
+       !(newton && SolveHugoniotEquationNewton(id, rho, p, ps, rhos0, rhos1, rhos)) &&
+       !SolveHugoniotEquationIteratively(wavenumber, id, rho, p, ps, rhos0, rhos1, rhos))
+      return false;
 
     double du = -(ps-p)*(1.0/rhos-1.0/rho);
     if(du<0) {
@@ -1610,11 +2165,265 @@ ExactRiemannSolverBase::ComputeRhoUStar(int wavenumber /*1 or 3*/,
   return true; //yeah!
 }
 
+//----------------------------------------------------------------------------------
+//! Solve the Hugoniot equation H = e(rhos,ps) - e(rho,p) + 0.5*(p+ps)*(1/rhos - 1/rho) = 0 by Newton's method
+//! in terms of the specific volume Vs = 1/rhos, in which H is nearly linear (exactly linear for stiffened gas).
+//! dH/dVs = rhos*(dp/drho)/BigGamma + 0.5*(p+ps), where -rhos^2*(dp/drho)/(rhos*BigGamma) is de/dVs at
+//! constant p. H > 0 between the solution and 1/rho. Every iterate updates a bracketing interval [Vlo, Vhi];
+//! steps that leave it are replaced by bisection (or by expansion towards 0, if Vlo has not been found).
+  bool  //true: success  | false: failure
+ExactRiemannSolverBase::SolveHugoniotEquationNewton(int id, double rho, double p, double ps/*inputs*/,
+    double rhos0, double rhos1/*initial guesses*/, double &rhos/*output*/)
+{
+  VarFcnBase *vf_ = vf[id];
+
+  double e = vf_->GetInternalEnergyPerUnitMass(rho, p);
+  double pavg = 0.5*(p + ps);
+  double V = 1.0/rho;
+
+  // initial guess: the previous solution (if admissible). Otherwise, the acoustic approximation, limited
+  // by the strong-shock limit rho*(BigGamma+2)/BigGamma.
+  double x;
+  if(rhos1>rho)
+    x = rhos1;
+  else if(rhos0>rho)
+    x = rhos0;
+  else {
+    double c2 = vf_->ComputeSoundSpeedSquare(rho, e);
+    double Gamma = vf_->GetBigGamma(rho, e);
+    x = (c2>0) ? rho + (ps - p)/c2 : 2.0*rho;
+    if(Gamma>0)
+      x = std::min(x, rho*(Gamma + 2.0)/Gamma);
+    if(!(x>rho))
+      x = rho*(1.0 + 1.0e-6);
+  }
+  double Vs = 1.0/x;
+
+  double Vlo = 0.0, Vhi = V;
+  for(int it=0; it<maxIts_shock; it++) {
+
+    double rhos_it = 1.0/Vs;
+    double es = vf_->GetInternalEnergyPerUnitMass(rhos_it, ps);
+    double H = es - e + pavg*(Vs - V);
+    if(!std::isfinite(H))
+      return false;
+    if(H==0.0) {
+      rhos = rhos_it;
+      return true;
+    }
+    if(H>0)
+      Vhi = Vs;
+    else
+      Vlo = Vs;
+
+    double dpdrho, dpde;
+    vf_->GetPressureAndDerivatives(rhos_it, es, dpdrho, dpde);
+    double dH = rhos_it*rhos_it*dpdrho/dpde + pavg;
+    double Vs_new = Vs - H/dH;
+    if(!std::isfinite(Vs_new) || Vs_new<=Vlo || Vs_new>=Vhi) //Newton step rejected
+      Vs_new = (Vlo>0.0) ? 0.5*(Vlo + Vhi) : 0.5*Vs;
+
+    if(fabs(Vs_new - Vs) < tol_shock*Vs) {
+      rhos = 1.0/Vs_new;
+#if PRINT_RIEMANN_SOLUTION == 1
+      cout << "  shock: Newton converged in " << it+1 << " iterations." << endl;
+#endif
+      return true;
+    }
+    Vs = Vs_new;
+  }
+
+  return false; //let the caller try the bracketing method
+}
+
+//----------------------------------------------------------------------------------
+//! Solve the Hugoniot equation for rhos by bracketing and root-finding (for EOS without closed-form solution)
+  bool  //true: success  | false: failure
+ExactRiemannSolverBase::SolveHugoniotEquationIteratively([[maybe_unused]] int wavenumber /*1 or 3*/, int id,
+    double rho, double p, double ps/*inputs*/, double rhos0, double rhos1/*initial guesses*/,
+    double &rhos/*output*/)
+{
+  HugoniotEquation hugo(vf[id],rho,p,ps);
+
+  //find a bracketing interval
+  double f0, f1;
+  double drho = std::max(fabs(rhos0 - rhos1), 0.001*rhos0); 
+  bool found_rhos0 = false, found_rhos1 = false;
+  if(std::min(rhos0,rhos1)>=rho) {//both rhos0 and rhos1 are physically admissible
+    f0 = hugo(rhos0);
+    f1 = hugo(rhos1);
+    if(f0*f1<=0) {
+      /*found bracketing interval [rhos0, rhos1]*/
+      if(rhos0>rhos1) {
+        std::swap(rhos0,rhos1);
+        std::swap(f0,f1);
+      }
+      found_rhos0 = found_rhos1 = true;
+    } else {
+      rhos0 = rhos1; //this is our starting point (presumably rhos1 is closer to sol'n)
+      f0    = f1; 
+    }
+  } else { //at least, the smaller one among rhos0, rhos1 is non-physical
+    if(rhos1>rhos0) {
+      rhos0 = rhos1; 
+      f0    = hugo(rhos0);
+    }
+    if(rhos0<rho) {//this one is also non-physical
+      rhos0 = rho;
+      f0    = hugo(rhos0);
+      found_rhos0 = true;
+    } else {
+      /*rhos0 = rhos0;*/
+      f0 = hugo(rhos0);
+    }
+  } 
+
+  if(!found_rhos0 || !found_rhos1) {
+    int i = 0;
+    double factor = 1.5; 
+    double tmp, ftmp;
+    // before the search, rhos0 = rhos1 = an adimissible point > rho
+    rhos1 = rhos0;
+    f1    = f0;
+    while(!found_rhos0) {
+      if(++i>=maxIts_shock) {
+        //          cout << "*** Error: Unable to find a bracketing interval after " << maxIts_shock 
+        //               << " iterations (in the solution of the Hugoniot equation)." << endl;
+        return false;
+      }
+      tmp = rhos1;
+      ftmp = f1;
+      //move to the left (towards rho)
+      rhos1 = rhos0;
+      f1    = f0;
+      rhos0 = rhos1 - factor*drho;
+      if(rhos0<=rho) {
+        rhos0 = rho;
+        found_rhos0 = true;
+      }
+      f0 = hugo(rhos0);
+
+      if(f0*f1<=0) {
+        found_rhos0 = found_rhos1 = true;
+      } else {
+        //move to the right
+        rhos1 = tmp;
+        f1    = ftmp;
+        tmp   = rhos0; //don't forget the smallest point
+        ftmp  = f0;
+        rhos0 = rhos1;
+        f0    = f1;
+        rhos1 = rhos0 + factor*drho;
+        f1 = hugo(rhos1);
+        if(f0*f1<=0) {
+          found_rhos0 = found_rhos1 = true;
+        } else {
+          rhos0 = tmp;
+          f0    = ftmp;
+          drho  = rhos1 - rhos0; //update drho
+        }
+      }
+    }
+
+    if(!found_rhos1) {//keep moving to the right
+      i = 0;
+      double factor = 2.5;
+      while(!found_rhos1) {
+        if(++i>=maxIts_shock) {
+          //            cout << "*** Error: Unable to find a bracketing interval after " << maxIts_shock 
+          //                 << " iterations (in the solution of the Hugoniot equation (2))." << endl;
+          return false; //failure
+        }
+        rhos0 = rhos1;
+        f0    = f1;
+        rhos1 = rhos0 + factor*drho;
+        f1    = hugo(rhos1);
+        if(f0*f1<=0) {
+          found_rhos1 = true;
+        } else
+          drho = rhos1 - rhos0;
+      }
+    }
+
+  }
+
+  pair<double,double> sol;
+  double loc_tol_shock = tol_shock*std::min(rhos0,rhos1);
+#ifndef WITHOUT_BOOST
+  //*******************************************************************
+  // Calling boost function for root-finding
+  // Warning: "maxit" is BOTH AN INPUT AND AN OUTPUT
+  boost::uintmax_t maxit = maxIts_shock;
+  if(f0==0.0)
+    sol.first = sol.second = rhos0;
+  else if(f1==0.0)
+    sol.first = sol.second = rhos1;
+  else {
+    sol = toms748_solve(hugo, rhos0, rhos1, f0, f1,
+        [=](double r0, double r1){return r1-r0<std::min(loc_tol_shock,0.001*(rhos1-rhos0));}, 
+        maxit);
+  }
+  //*******************************************************************
+#else
+  //*******************************************************************
+  // Using a hybrid (Brent) method for root-finding
+  int maxit = 0;
+  if(f0==0.0)
+    sol.first = sol.second = rhos0;
+  else if(f1==0.0)
+    sol.first = sol.second = rhos1;
+  else {
+    double rhos2 = rhos1; //rhos2 is always the latest one
+    double f2    = f1;
+    int it;
+    for(it = 0; it<maxIts_shock; it++) {
+      drho = rhos1 - rhos0;
+      rhos2 = rhos2 - f2*(rhos1 - rhos0)/(f1 - f0); //secant method
+      if(rhos2 >= rhos1 || rhos2 <= rhos0) //discard and switch to bisection
+        rhos2 = 0.5*(rhos0+rhos1);
+      f2 = hugo(rhos2);
+      if(f2==0.0) {
+        sol.first = sol.second = rhos2;
+        break;
+      }
+      if(f2*f0<0) {
+        rhos1 = rhos2;
+        f1    = f2;
+      } else {
+        rhos0 = rhos2;
+        f0    = f2;
+      }
+      if(rhos1-rhos0<loc_tol_shock) {
+        sol.first  = rhos0;
+        sol.second = rhos1;
+        break;
+      }
+    }
+    if(it==maxIts_shock) {
+      fprintf(stdout,"*** Error: Root-finding method failed to converge after %d iterations.\n", it);
+      return false;
+    }
+    maxit = it;
+  }
+  //*******************************************************************
+#endif
+
+
+#if PRINT_RIEMANN_SOLUTION == 1
+  cout << "  " << wavenumber << "-wave: shock, converged in " << maxit << " iterations. fun = " 
+    << hugo(0.5*(sol.first+sol.second)) << "." << endl;
+#endif
+
+  rhos = 0.5*(sol.first+sol.second);
+
+  return true;
+}
+
 //----------------------------------------------------------------------------------
 //! Connect the left initial state with the left star state (the 1-wave) --- for one-sided Riemann problem
 //! where the solution contains a rarefaction (not a shock).
 bool  //true: success  | false: failure
-ExactRiemannSolverBase::ComputeOneSidedRarefaction(double rho, double u, double p, [[maybe_unused]] double e,
+ExactRiemannSolverBase::ComputeOneSidedRarefaction(double rho, double u, double p, double e,
     double c, int id, double us/*inputs*/,
     double &rhos, double &ps/*outputs*/, 
     bool *trans_rare, double *Vrare_x0/*filled only if found tran rf*/)
@@ -1641,7 +2450,9 @@ ExactRiemannSolverBase::ComputeOneSidedRarefaction(double rho, double u, double
   // prepare for numerical integration
   double rhos_0 = rho, us_0 = u, ps_0 = p, xi_0; //start point of each step
   double rhos_1 = rho, us_1 = u, ps_1 = p, xi_1; //end point of each step
+  double es_0 = e, es_1 = e; //only used if integrate_e == true
   double du;
+  bool integrate_e = vf[id]->HasIterativeInverse(); //if true, integrate (rho,e,u) to avoid calling e(rho,p)
 
   double xi = u - c; 
   xi_0 = xi;
@@ -1657,10 +2468,15 @@ ExactRiemannSolverBase::ComputeOneSidedRarefaction(double rho, double u, double
   double uErr(0), rhoErr(0);
   for(int i=0; i<numSteps_rarefaction*5; i++) {
 
-    bool success = Rarefaction_OneStepRK4(wavenumber/*1 or 3*/, id,
-	rhos_0, us_0, ps_0 /*start state*/, dp /*step size*/,
-	rhos_1, us_1, ps_1, xi_1 /*output: end state*/,
-	uErr, rhoErr); 
+    bool success = integrate_e ?
+        Rarefaction_OneStepRK4_RhoE(wavenumber/*1 or 3*/, id,
+	  rhos_0, us_0, ps_0, es_0 /*start state*/, dp /*step size*/,
+	  rhos_1, us_1, ps_1, es_1, xi_1 /*output: end state*/,
+	  uErr, rhoErr) :
+        Rarefaction_OneStepRK4(wavenumber/*1 or 3*/, id,
+	  rhos_0, us_0, ps_0 /*start state*/, dp /*step size*/,
+	  rhos_1, us_1, ps_1, xi_1 /*output: end state*/,
+	  uErr, rhoErr); 
 
     if(!success) {
       dp /= 2.0;
@@ -1730,6 +2546,7 @@ ExactRiemannSolverBase::ComputeOneSidedRarefaction(double rho, double u, double
     rhos_0 = rhos_1;
     us_0   = us_1;
     ps_0   = ps_1;
+    es_0   = es_1;
     xi_0   = xi_1;
 
   }
@@ -1882,6 +2699,78 @@ ExactRiemannSolverBase::Rarefaction_OneStepRK4(int wavenumber/*1 or 3*/, int id,
   return true;
 }
 
+//----------------------------------------------------------------------------------
+// Same Cash-Karp scheme as Rarefaction_OneStepRK4, with p as the independent variable. Here, e is integrated
+// together with rho and u: drho/dp = 1/c^2, de/dp = p/(rho^2 c^2) (i.e. de = p/rho^2 drho), and
+// du/dp = -/+ 1/(rho c). Each stage only requires c(rho,e), avoiding e(rho,p), which is expensive for
+// some EOS (e.g., Tillotson, ANEOS, tabulated). The end point in p is still exact.
+  bool
+ExactRiemannSolverBase::Rarefaction_OneStepRK4_RhoE(int wavenumber/*1 or 3*/, int id,
+    double rho_0, double u_0, double p_0, double e_0 /*start state*/,
+    double dp /*step*/,
+    double &rho, double &u, double &p, double &e, double &xi /*output*/,
+    double & uErr, double & rhoErr /*output*/)
+{
+  dp = -dp; // dp is positive when passed in.
+
+  // Cash-Karp coefficients
+  const double a[6][5] = {{0.0, 0.0, 0.0, 0.0, 0.0},
+                          {0.2, 0.0, 0.0, 0.0, 0.0},
+                          {3./40., 9./40., 0.0, 0.0, 0.0},
+                          {0.3, -0.9, 1.2, 0.0, 0.0},
+                          {-11./54., 2.5, -70./27., 35./27., 0.0},
+                          {1631./55296., 175./512., 575./13824., 44275./110592., 253./4096.}};
+  const double cp[6] = {0.0, 0.2, 0.3, 0.6, 1.0, 0.875};
+  const double b5[6] = {37./378., 0.0, 250./621., 125./594., 0.0, 512./1771.};
+  const double b4[6] = {2825./27648., 0.0, 18575./48384., 13525./55296., 277./14336., 0.25};
+
+  double Frho[6], Fe[6], Fu[6]; //derivatives w.r.t. p at each stage
+  for(int k=0; k<6; k++) {
+    double rho_k = rho_0, e_k = e_0;
+    for(int j=0; j<k; j++) {
+      rho_k += a[k][j]*dp*Frho[j];
+      e_k   += a[k][j]*dp*Fe[j];
+    }
+    double c_k_square = vf[id]->ComputeSoundSpeedSquare(rho_k, e_k);
+    if(rho_k<=0 || !(c_k_square>0))
+      return false;
+    double p_k = p_0 + cp[k]*dp;
+    Frho[k] = 1.0/c_k_square;
+    Fe[k]   = p_k*Frho[k]/(rho_k*rho_k);
+    Fu[k]   = 1.0/(rho_k*sqrt(c_k_square));
+  }
+
+  double drho = 0.0, drho_err = 0.0, de = 0.0, du = 0.0, du_err = 0.0;
+  for(int k=0; k<6; k++) {
+    drho     += b5[k]*Frho[k];
+    drho_err += b4[k]*Frho[k];
+    de       += b5[k]*Fe[k];
+    du       += b5[k]*Fu[k];
+    du_err   += b4[k]*Fu[k];
+  }
+  drho *= dp;  drho_err *= dp;  de *= dp;  du *= dp;  du_err *= dp;
+
+  if(!std::isfinite(drho) || !std::isfinite(de) || !std::isfinite(du) || !std::isfinite(du_err))
+    return false;
+
+  rhoErr = fabs(drho_err - drho);
+  uErr = fabs(du_err - du);
+
+  rho = rho_0 + drho;
+  e   = e_0 + de;
+  p   = p_0 + dp;
+  u   = (wavenumber == 1) ? u_0 - du : u_0 + du;
+
+  double c = vf[id]->ComputeSoundSpeedSquare(rho, e);
+  if(rho<=0 || c<0)
+    return false;
+
+  c = sqrt(c);
+  xi = (wavenumber == 1) ? u - c : u + c;
+
+  return true;
+}
+
 //-----------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------
 
@@ -1963,7 +2852,8 @@ ExactRiemannSolverBase::ComputeOneSidedRiemannSolution(double *dir/*unit normal
     double *Vm, int idl /*left state*/,
     double *Ustar, /*interface/wall velocity (3D)*/
     double *Vs, int &id, /*solution at xi = 0 (i.e. x=0), id = -1 if invalid*/
-    double *Vsm /*left 'star' solution*/)
+    double *Vsm /*left 'star' solution*/,
+    double *ps_hint /*estimate of p*, e.g., from the previous time step*/)
 {
 
   // Convert to a 1D problem (i.e. One-Dimensional Riemann)
@@ -1987,6 +2877,11 @@ ExactRiemannSolverBase::ComputeOneSidedRiemannSolution(double *dir/*unit normal
   std::vector<double> vectL{pl, rhol, ul};
   integrationPath1.push_back(vectL);
 
+#if PRINT_RIEMANN_SOLUTION == 1
+  // sol1d holds the profile of this solve only (cleared here, and before each star-state evaluation)
+  sol1d.clear();
+#endif
+
 
   // Declare variables in the "star region"
   double p0(DBL_MIN), ul0(0.0), rhol0(DBL_MIN);
@@ -2056,14 +2951,14 @@ ExactRiemannSolverBase::ComputeOneSidedRiemannSolution(double *dir/*unit normal
   //         (find initial interval [p0, p1])
   // -------------------------------
   success = FindInitialIntervalOneSided(rhol, ul, pl, el, cl, idl, ustar, /*inputs*/
-      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/);
+      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/, ps_hint);
   /* our convention is that p0 < p1 */
 
   if(!success) { //failed to find a bracketing interval. Output the state corresponding smallest "f"
 
     // get sol1d, trans_rare and Vrare_x0
 #if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
+    sol1d.clear(); //keep only the profile of the latest evaluation
 #endif
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p1, idl, rhol0, rhol0*1.1, rhol2, ul2,
 	&trans_rare, Vrare_x0/*filled only if found a trans. rarefaction*/);
@@ -2116,10 +3011,6 @@ ExactRiemannSolverBase::ComputeOneSidedRiemannSolution(double *dir/*unit normal
   p2 = p1; 
   f2 = f1;
 
-#if PRINT_RIEMANN_SOLUTION == 1
-  sol1d.clear();
-#endif
-
   for(iter=0; iter<maxIts_main; iter++) {
 
     // 2.1: Update p using the Brent method (safeguarded secant method)
@@ -2142,6 +3033,10 @@ ExactRiemannSolverBase::ComputeOneSidedRiemannSolution(double *dir/*unit normal
 
 try_again:
 
+#if PRINT_RIEMANN_SOLUTION == 1
+    sol1d.clear(); //keep only the profile of the latest evaluation
+#endif
+
     // 2.2: Calculate ul2 
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p2, idl/*inputs*/, 
 	rhol0, rhol1/*initial guesses for Hugo. eq.*/,
@@ -2190,10 +3085,6 @@ try_again:
 
     trans_rare = false; //reset
 
-#if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
-#endif
-
   }
 
 
@@ -2219,6 +3110,271 @@ try_again:
 
 }
 
+//----------------------------------------------------------------------------------
+
+int
+ExactRiemannSolverBase::ComputeRiemannSolutionJacobian(double *dir, double *Vm, int idm, double *Vp, int idp,
+                                                       double *Vs, int &id, double *Vsm, double *Vsp,
+                                                       double *dVs, double *dVsm, double *dVsp)
+{
+  double Vsm_tmp[5], Vsp_tmp[5], dVsm_tmp[50], dVsp_tmp[50];
+  if(!Vsm)
+    Vsm = Vsm_tmp;
+  if(!Vsp)
+    Vsp = Vsp_tmp;
+  if(!dVsm)
+    dVsm = dVsm_tmp;
+  if(!dVsp)
+    dVsp = dVsp_tmp;
+  for(int i=0; i<50; i++)
+    dVs[i] = dVsm[i] = dVsp[i] = 0.0;
+
+  int err = ComputeRiemannSolution(dir, Vm, idm, Vp, idp, Vs, id, Vsm, Vsp);
+  if(err==2 || err==3) //vacuum or cavitation
+    return err;
+
+  double rhol = Vm[0], pl = Vm[4];
+  double rhor = Vp[0], pr = Vp[4];
+  double rhol2 = Vsm[0], rhor2 = Vsp[0], p2 = Vsm[4];
+  double u2 = Vsm[1]*dir[0] + Vsm[2]*dir[1] + Vsm[3]*dir[2];
+
+  // derivatives w.r.t. s = (rhol, ul, pl, rhor, ur, pr), where ul and ur are normal velocities
+  double dfl[3], drhol[3], dfr[3], drhor[3];
+  if(!ComputeWaveCurveDerivatives(idm, rhol, pl, p2, rhol2, dfl, drhol) ||
+     !ComputeWaveCurveDerivatives(idp, rhor, pr, p2, rhor2, dfr, drhor) || !(dfl[0] + dfr[0] > 0.0))
+    return 1;
+
+  // ul - fl(p2; rhol, pl) = ur + fr(p2; rhor, pr)
+  double D = dfl[0] + dfr[0];
+  double dp2[6] = {-dfl[1]/D, 1.0/D, -dfl[2]/D, -dfr[1]/D, -1.0/D, -dfr[2]/D};
+  double du2[6], drhol2[6], drhor2[6];
+  for(int k=0; k<6; k++) {
+    du2[k]    = (k==1 ? 1.0 : 0.0) - dfl[0]*dp2[k] - (k==0 ? dfl[1] : (k==2 ? dfl[2] : 0.0));
+    drhol2[k] = drhol[0]*dp2[k] + (k==0 ? drhol[1] : (k==2 ? drhol[2] : 0.0));
+    drhor2[k] = drhor[0]*dp2[k] + (k==3 ? drhor[1] : (k==5 ? drhor[2] : 0.0));
+  }
+
+  // from s to (Vm, Vp): ul = Vm[1..3]*dir, ur = Vp[1..3]*dir
+  auto scatter = [&](double *ds, double *row, double scale) {
+    row[0] += ds[0]*scale;
+    row[4] += ds[2]*scale;
+    row[5] += ds[3]*scale;
+    row[9] += ds[5]*scale;
+    for(int m=0; m<3; m++) {
+      row[1+m] += ds[1]*dir[m]*scale;
+      row[6+m] += ds[4]*dir[m]*scale;
+    }
+  };
+  // tangential velocity: utan = V[1..3] - (V[1..3]*dir)*dir (col0 = 0: Vm, 5: Vp)
+  auto add_tangential = [&](double *J, int col0, double scale) {
+    for(int k=0; k<3; k++)
+      for(int m=0; m<3; m++)
+        J[(1+k)*10 + col0+1+m] += ((k==m ? 1.0 : 0.0) - dir[k]*dir[m])*scale;
+  };
+
+  // star states
+  scatter(drhol2, &dVsm[0], 1.0);
+  scatter(drhor2, &dVsp[0], 1.0);
+  scatter(dp2, &dVsm[40], 1.0);
+  scatter(dp2, &dVsp[40], 1.0);
+  for(int k=0; k<3; k++) {
+    scatter(du2, &dVsm[(1+k)*10], dir[k]);
+    scatter(du2, &dVsp[(1+k)*10], dir[k]);
+  }
+  add_tangential(dVsm, 0, 1.0);
+  add_tangential(dVsp, 5, 1.0);
+
+  // solution at xi = 0
+  bool left = last_left; //recorded by FinalizeSolution
+  SolutionRegion region = last_region;
+  double drho_s[6] = {0}, du_s[6] = {0}, dp_s[6] = {0};
+  int k0 = left ? 0 : 3; //(rho, u, p) of the upwind side
+
+  if(region == STAR_STATE) {
+    for(int k=0; k<6; k++) {
+      drho_s[k] = left ? drhol2[k] : drhor2[k];
+      du_s[k]   = du2[k];
+      dp_s[k]   = dp2[k];
+    }
+  }
+  else if(region == INITIAL_STATE) {
+    drho_s[k0]  = 1.0;
+    du_s[k0+1]  = 1.0;
+    dp_s[k0+2]  = 1.0;
+  }
+  else { //sonic point of a transonic rarefaction: u -/+ f(p) = -/+ c(rho(p), p)
+    int idK = left ? idm : idp;
+    double df[3], drho[3], dc2_drho, dc2_dp;
+    double c2 = 0.0, Gp = 0.0;
+    if(ComputeWaveCurveDerivatives(idK, left ? rhol : rhor, left ? pl : pr, Vs[4], Vs[0], df, drho))
+      c2 = ComputeSoundSpeedSquareDerivatives(idK, Vs[0], Vs[4], dc2_drho, dc2_dp);
+    double c = c2>0 ? sqrt(c2) : 0.0;
+    double sgn = left ? -1.0 : 1.0;
+    // G(ps) = u + sgn*(f(ps) + c(rho(ps), ps)) = 0
+    double dc[3] = {0.0, 0.0, 0.0};
+    if(c>0) {
+      dc[0] = 0.5*(dc2_drho*drho[0] + dc2_dp)/c;
+      dc[1] = 0.5*dc2_drho*drho[1]/c;
+      dc[2] = 0.5*dc2_drho*drho[2]/c;
+      Gp = sgn*(df[0] + dc[0]);
+    }
+    if(Gp == 0.0) {
+      for(int i=0; i<50; i++)
+        dVsm[i] = dVsp[i] = 0.0;
+      return 1;
+    }
+    double Gs[3] = {sgn*(df[1] + dc[1]), 1.0, sgn*(df[2] + dc[2])};
+    for(int j=0; j<3; j++) {
+      int k = k0 + j;
+      dp_s[k]   = -Gs[j]/Gp;
+      drho_s[k] = drho[0]*dp_s[k] + (j==0 ? drho[1] : (j==2 ? drho[2] : 0.0));
+      du_s[k]   = (j==1 ? 1.0 : 0.0) + sgn*(df[0]*dp_s[k] + (j==0 ? df[1] : (j==2 ? df[2] : 0.0)));
+    }
+  }
+
+  scatter(drho_s, &dVs[0], 1.0);
+  scatter(dp_s, &dVs[40], 1.0);
+  for(int k=0; k<3; k++)
+    scatter(du_s, &dVs[(1+k)*10], dir[k]);
+  // tangential velocity: upwinding as in FinalizeSolution
+  if(u2>0)
+    add_tangential(dVs, 0, 1.0);
+  else if(u2<0)
+    add_tangential(dVs, 5, 1.0);
+  else {
+    add_tangential(dVs, 0, 0.5);
+    add_tangential(dVs, 5, 0.5);
+  }
+
+  return err;
+}
+
+//----------------------------------------------------------------------------------
+
+bool
+ExactRiemannSolverBase::ComputeWaveCurveDerivatives(int id, double rho, double p, double ps, double rhos,
+                                                    double *df, double *drhos)
+{
+  if(ps - p > 1.0e-10*(fabs(p) + fabs(ps))) { //shock: H(rhos, ps; rho, p) = 0 (Hugoniot eq.)
+
+    // e(rho, p): de/dp = 1/(dp/de), de/drho = -(dp/drho)/(dp/de)
+    double e   = vf[id]->GetInternalEnergyPerUnitMass(rho, p);
+    double es  = vf[id]->GetInternalEnergyPerUnitMass(rhos, ps);
+    double p_rho, p_e, ps_rho, ps_e;
+    vf[id]->GetPressureAndDerivatives(rho, e, p_rho, p_e);
+    vf[id]->GetPressureAndDerivatives(rhos, es, ps_rho, ps_e);
+    if(p_e == 0.0 || ps_e == 0.0)
+      return false;
+    double e_p = 1.0/p_e, e_rho = -p_rho/p_e;
+    double es_p = 1.0/ps_e, es_rho = -ps_rho/ps_e;
+
+    double dv = 1.0/rho - 1.0/rhos;
+    double H_rhos = es_rho - 0.5*(ps + p)/(rhos*rhos);
+    double H_ps   = es_p - 0.5*dv;
+    double H_rho  = -e_rho + 0.5*(ps + p)/(rho*rho);
+    double H_p    = -e_p - 0.5*dv;
+    if(H_rhos == 0.0)
+      return false;
+    drhos[0] = -H_ps/H_rhos;
+    drhos[1] = -H_rho/H_rhos;
+    drhos[2] = -H_p/H_rhos;
+
+    // f = sqrt((ps - p)*(1/rho - 1/rhos))
+    double dp = ps - p;
+    double f = sqrt(dp*dv);
+    if(!(f>0))
+      return false;
+    double rhos2 = rhos*rhos;
+    df[0] = (dv + dp*drhos[0]/rhos2)/(2.0*f);
+    df[1] = dp*(-1.0/(rho*rho) + drhos[1]/rhos2)/(2.0*f);
+    df[2] = (-dv + dp*drhos[2]/rhos2)/(2.0*f);
+    return true;
+  }
+
+  // rarefaction (or no wave)
+  double gam, pc, b;
+  if(vf[id]->GetStiffenedGasParameters(gam, pc, b)) {
+    // isentrope: (p + pc)(1/rho - b)^gam = const. f = 2/(gam-1)*sqrt(gam*P*w)*((Ps/P)^((gam-1)/(2gam)) - 1)
+    double P = p + pc, Ps = ps + pc, w = 1.0/rho - b;
+    if(P<=0 || Ps<=0 || w<=0)
+      return false;
+    double r   = Ps/P;
+    double A   = sqrt(gam*P*w);
+    double rz  = pow(r, 0.5*(gam-1.0)/gam);
+    double f   = 2.0/(gam-1.0)*A*(rz - 1.0);
+    double ws  = w*pow(r, -1.0/gam);
+    double rhs = 1.0/(b + ws);
+    df[0] = A*rz/(gam*Ps);
+    df[1] = -f/(2.0*w*rho*rho);
+    df[2] = f/(2.0*P) - A*rz/(gam*P);
+    drhos[0] = rhs*rhs*ws/(gam*Ps);
+    drhos[1] = rhs*rhs/(rho*rho)*pow(r, -1.0/gam);
+    drhos[2] = -rhs*rhs*ws/(gam*P);
+    return true;
+  }
+
+  // General EOS: f = int_p^ps dp'/(rho*c) along the isentrope drho/dp = 1/c^2. Moving the initial state along
+  // its isentrope does not change the curve, so only the sensitivity to rho (at fixed p) needs to be integrated:
+  // eta = drho/drho0, phi = df/drho0, with deta/dp = -(dc^2/drho)/c^4*eta, dphi/dp = d(1/(rho*c))/drho*eta
+  double c2s = vf[id]->ComputeSoundSpeedSquare(rhos, vf[id]->GetInternalEnergyPerUnitMass(rhos, ps));
+  double c2  = vf[id]->ComputeSoundSpeedSquare(rho, vf[id]->GetInternalEnergyPerUnitMass(rho, p));
+  if(!(c2s>0) || !(c2>0))
+    return false;
+
+  double eta = 1.0, phi = 0.0;
+  if(ps != p) {
+    auto rhs = [&](double rho_, double p_, double eta_, double *dy) {
+      double dc2_drho, dc2_dp;
+      double c2_ = ComputeSoundSpeedSquareDerivatives(id, rho_, p_, dc2_drho, dc2_dp);
+      if(!(c2_>0))
+        return false;
+      double g = 1.0/(rho_*sqrt(c2_));
+      dy[0] = 1.0/c2_;
+      dy[1] = -dc2_drho/(c2_*c2_)*eta_;
+      dy[2] = -(g/rho_ + 0.5*g*dc2_drho/c2_)*eta_;
+      return true;
+    };
+    const int nSteps = 8; //the isentrope is smooth
+    double h = (ps - p)/nSteps, y[3] = {rho, eta, phi}, k1[3], k2[3], k3[3], k4[3];
+    for(int i=0; i<nSteps; i++) {
+      double pi = p + i*h;
+      if(!rhs(y[0], pi, y[1], k1) ||
+         !rhs(y[0] + 0.5*h*k1[0], pi + 0.5*h, y[1] + 0.5*h*k1[1], k2) ||
+         !rhs(y[0] + 0.5*h*k2[0], pi + 0.5*h, y[1] + 0.5*h*k2[1], k3) ||
+         !rhs(y[0] + h*k3[0], pi + h, y[1] + h*k3[1], k4))
+        return false;
+      for(int j=0; j<3; j++)
+        y[j] += h/6.0*(k1[j] + 2.0*k2[j] + 2.0*k3[j] + k4[j]);
+    }
+    eta = y[1];
+    phi = y[2];
+  }
+
+  df[0] = 1.0/(rhos*sqrt(c2s));
+  df[1] = phi;
+  df[2] = -1.0/(rho*sqrt(c2)) - phi/c2;
+  drhos[0] = 1.0/c2s;
+  drhos[1] = eta;
+  drhos[2] = -eta/c2;
+  return true;
+}
+
+//----------------------------------------------------------------------------------
+
+double
+ExactRiemannSolverBase::ComputeSoundSpeedSquareDerivatives(int id, double rho, double p,
+                                                           double &dc2_drho, double &dc2_dp)
+{
+  // from the derivatives w.r.t. (rho, e), with de/drho = -(dp/drho)/(dp/de) at constant p, and de/dp = 1/(dp/de)
+  double e = vf[id]->GetInternalEnergyPerUnitMass(rho, p);
+  double dpdrho, dpde, dc2_drho_e, dc2_de;
+  vf[id]->GetPressureAndDerivatives(rho, e, dpdrho, dpde);
+  double c2 = vf[id]->ComputeSoundSpeedSquareAndDerivatives(rho, e, dc2_drho_e, dc2_de);
+  dc2_drho = dc2_drho_e - dc2_de*dpdrho/dpde;
+  dc2_dp   = dc2_de/dpde;
+  return c2;
+}
+
 //----------------------------------------------------------------------------------
 /** Solves the one-dimensional Riemann problem. Extension of Kamm 2015 
  * to Two Materials. See KW's notes for details
@@ -2237,6 +3393,22 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
 {
   assert(curvature == 0.0); //the base class does not handle curvature!
 
+  return ComputeRiemannSolutionFromInterval(dir, Vm, idl, Vp, idr, Vs, id, Vsm, Vsp, NULL);
+}
+
+//----------------------------------------------------------------------------------
+
+int
+ExactRiemannSolverNonAdaptive::ComputeRiemannSolutionFromInterval(double *dir, 
+    double *Vm, int idl /*"left" state*/, 
+    double *Vp, int idr /*"right" state*/, 
+    double *Vs, int &id /*solution at xi = 0 (i.e. x=0) */,
+    double *Vsm /*left 'star' solution*/,
+    double *Vsp /*right 'star' solution*/,
+    double *interval /*p0, rhol0, rhor0, p1, rhol1, rhor1 (NULL if not available)*/,
+    bool *warm)
+{
+
   // Convert to a 1D problem (i.e. One-Dimensional Riemann)
   double rhol  = Vm[0];
   double ul    = Vm[1]*dir[0] + Vm[2]*dir[1] + Vm[3]*dir[2];
@@ -2254,6 +3426,8 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
   integrationPath3.push_back(vectR); 
 
 #if PRINT_RIEMANN_SOLUTION == 1
+  // sol1d holds the profile of this solve only (cleared here, and before each star-state evaluation)
+  sol1d.clear();
   std::cout << "Left State (rho, u, p): " << rhol << ", " << ul << ", " << pl << "." << std::endl;
   std::cout << "Right State (rho, u, p): " << rhor << ", " << ur << ", " << pr << "." << std::endl;
 #endif
@@ -2309,18 +3483,41 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
 
   // -------------------------------
   // Step 1: Initialization
-  //         (find initial interval [p0, p1])
+  //         (reuse the given interval [p0, p1] if it still brackets the root. Otherwise, find one.)
   // -------------------------------
-  success = FindInitialInterval(rhol, ul, pl, el, cl, idl, rhor, ur, pr, er, cr, idr, /*inputs*/
-      p0, rhol0, rhor0, ul0, ur0,
-      p1, rhol1, rhor1, ul1, ur1/*outputs*/);
+  bool warm_start = false;
+  if(interval && interval[0] < interval[3]) {
+    p0 = interval[0];
+    p1 = interval[3];
+    warm_start = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p0, idl, interval[1], interval[4], rhol0, ul0)
+              && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p0, idr, interval[2], interval[5], rhor0, ur0)
+              && ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p1, idl, interval[4], interval[1], rhol1, ul1)
+              && ComputeRhoUStar(3, integrationPath3, rhor, ur, pr, p1, idr, interval[5], interval[2], rhor1, ur1)
+              && (ul0-ur0)*(ul1-ur1) <= 0.0;
+
+    if(!warm_start) { //start over
+      integrationPath1.clear();
+      integrationPath3.clear();
+      integrationPath1.push_back(vectL);
+      integrationPath3.push_back(vectR); 
+    }
+  }
+  if(warm)
+    *warm = warm_start;
+
+  if(warm_start)
+    success = true;
+  else
+    success = FindInitialInterval(rhol, ul, pl, el, cl, idl, rhor, ur, pr, er, cr, idr, /*inputs*/
+        p0, rhol0, rhor0, ul0, ur0,
+        p1, rhol1, rhor1, ul1, ur1/*outputs*/);
   /* our convention is that p0 < p1 */
 
   if(!success) { //failed to find a bracketing interval. Output the state corresponding smallest "f"
 
     // get sol1d, trans_rare and Vrare_x0
 #if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
+    sol1d.clear(); //keep only the profile of the latest evaluation
 #endif
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p1, idl, rhol0, rhol0*1.1, rhol2, ul2,
 	&trans_rare, Vrare_x0/*filled only if found a trans. rarefaction*/);
@@ -2343,6 +3540,8 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
 	for(int i=0; i<5; i++)
 	  Vs[i] = Vp[i];
       }
+      last_region = INITIAL_STATE;
+      last_left = u_avg >= 0;
 
       return 1;
     }
@@ -2373,10 +3572,6 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
   p2 = p1; 
   f2 = f1;
 
-#if PRINT_RIEMANN_SOLUTION == 1
-  sol1d.clear();
-#endif
-
   for(iter=0; iter<maxIts_main; iter++) {
 
     // 2.1: Update p using the Brent method (safeguarded secant method)
@@ -2399,6 +3594,10 @@ ExactRiemannSolverNonAdaptive::ComputeRiemannSolution(double *dir,
 
 try_again:
 
+#if PRINT_RIEMANN_SOLUTION == 1
+    sol1d.clear(); //keep only the profile of the latest evaluation
+#endif
+
     // 2.2: Calculate ul2, ur2 
     success = ComputeRhoUStar(1, integrationPath1, rhol, ul, pl, p2, idl/*inputs*/, 
 	rhol0, rhol1/*initial guesses for Hugo. eq.*/,
@@ -2465,10 +3664,6 @@ try_again:
 
     trans_rare = false; //reset
 
-#if PRINT_RIEMANN_SOLUTION == 1
-    sol1d.clear();
-#endif
-
   }
 
 
@@ -2979,15 +4174,16 @@ ExactRiemannSolverNonAdaptive::Rarefaction_OneStepRK4(int wavenumber/*1 or 3*/,
   bool
 ExactRiemannSolverBase::FindInitialFeasiblePointsOneSided(double rhol, double ul, double pl, double el, 
     double cl, int idl, double ustar, double &p0, double &rhol0, double &ul0, 
-    double &p1, double &rhol1, double &ul1)
+    double &p1, double &rhol1, double &ul1, double *ps_hint)
 {
   double dp;
   int found = 0;
   bool success = true;
 
   // Method 1: Use the acoustic theory (Eqs. (20)-(22) of Kamm) to find p0, p1
+  //           (p0 is replaced by ps_hint, if available)
   found = FindInitialFeasiblePointsOneSidedByAcousticTheory(rhol, ul, pl, el, cl, idl, ustar,
-      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/);
+      p0, rhol0, ul0, p1, rhol1, ul1/*outputs*/, ps_hint);
 
   if(found==2)
     return true; //yeah
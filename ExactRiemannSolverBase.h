@@ -8,6 +8,11 @@
 
 #include <VarFcnBase.h>
 #include <vector>
+#include <string>
+
+class StarPressureAtlas;
+class EOSAdmissibilityEnvelope;
+class ExactRiemannSolverNonAdaptive;
 
 /*****************************************************************************************
  * Base class for solving one-dimensional, single- or two-material Riemann problems
@@ -16,6 +21,14 @@
 
 class ExactRiemannSolverBase {
 
+public:
+
+  //! stages of the fallback chain, in the order they are tried
+  enum SolutionStage {ADAPTIVE = 0, /*the adaptive solver (this class)*/
+                      NONADAPTIVE_WARM = 1, /*non-adaptive solver, starting from the adaptive solver's interval*/
+                      NONADAPTIVE_COLD = 2, /*non-adaptive solver, starting from scratch*/
+                      FAILED = 3, STAGE_SIZE = 4};
+
 protected:
   vector<VarFcnBase*>& vf; 
   ExactRiemannSolverData& iod_riemann;  
@@ -26,26 +39,81 @@ protected:
   double tol_shock;
   double tol_rarefaction; // non-dimensional, for rarefaction end points
   double min_pressure, failure_threshold, pressure_at_failure;
+  double acoustic_threshold; // weak jumps below this threshold are solved by the linearized solver
+  long num_solutions, num_acoustic_solutions; // statistics
+  int num_bracketing_candidates; // >= 2: speculative (multi-point) search for the initial bracketing interval
+  std::vector<std::vector<double> > bracket_samples; // work array: {p, rhol*, rhor*, ul*, ur*}
+  StarPressureAtlas *atlas; // tabulated initial guesses of p* (NULL if not used). Not owned by the solver
+  EOSAdmissibilityEnvelope *envelope; // admissible region of each EOS (NULL if not used). Not owned by the solver
   std::vector<std::vector<double> > integrationPath1; // first index: 1-pressure, 2-density, 3-velocity
   std::vector<std::vector<double> > integrationPath3;
 
+  ExactRiemannSolverNonAdaptive *fallback; // created when the adaptive solver fails for the first time, then reused
+  SolutionStage last_stage; // the stage that produced the last (two-sided) solution
+  long stage_count[STAGE_SIZE]; // statistics (the count of ADAPTIVE is derived from num_solutions)
+
   bool surface_tension; // an indicator of whether consider surface tension
 
+  int verbose; // verbosity of the warnings (0 by default)
+
 public:
 
   ExactRiemannSolverBase(std::vector<VarFcnBase*> &vf_, ExactRiemannSolverData &iod_riemann_);
 
-  virtual ~ExactRiemannSolverBase() {}
+  virtual ~ExactRiemannSolverBase();
 
   virtual double GetSurfaceTensionCoefficient();
 
   virtual int ComputeRiemannSolution(double *dir/*unit normal*/, double *Vm, int idm /*"left" state*/, 
                                      double *Vp, int idp /*"right" state*/,
                                      double *Vs, int &id /*solution at xi = 0 (i.e. x=0) */,
-                                     double *Vsm /*left 'star' solution*/,
-                                     double *Vsp /*right 'star' solution*/,
+                                     double *Vsm /*left 'star' solution (NULL if not needed)*/,
+                                     double *Vsp /*right 'star' solution (NULL if not needed)*/,
                                      double curvature = 0.0);
 
+  //! Same as ComputeRiemannSolution (without curvature), with the internal energies of the two states,
+  //! el = e(rhol,pl) and er = e(rhor,pr), given by the caller (e.g., if they have been computed already)
+  int ComputeRiemannSolutionWithEnergies(double *dir, double *Vm, int idm, double el, double *Vp, int idp, double er,
+                                         double *Vs, int &id, double *Vsm, double *Vsp);
+
+  //! p0 and p1 are initialized using the atlas (if possible), instead of the acoustic theory
+  void SetStarPressureAtlas(StarPressureAtlas *atlas_) {atlas = atlas_;}
+
+  //! star pressures and RK steps that would leave the admissible region of the EOS are rejected before calling the EOS
+  void SetAdmissibilityEnvelope(EOSAdmissibilityEnvelope *envelope_) {envelope = envelope_;}
+
+  //! verbosity of the solver's warnings (also applied to the fallback solver)
+  void SetVerbosity(int verbose_);
+
+  //! checks an input state V (primitive variables) of material id: known material, finite values, and
+  //! admissible (CheckState). The solver terminates the process if a state is not admissible, so inputs
+  //! from other codes should be checked first
+  bool IsValidInputState(const double *V, int id);
+
+  //! records n (two-sided) problems solved outside of this class (by the lock-step kernel of
+  //! ExactRiemannSolverBatch), so that the statistics below cover them. They count as ADAPTIVE
+  void CountExternalSolutions(long n) {num_solutions += n;}
+
+  //! fraction of (two-sided) Riemann problems solved by the linearized (acoustic) solver
+  double GetAcousticSolutionFraction() {
+    return num_solutions>0 ? (double)num_acoustic_solutions/num_solutions : 0.0;}
+
+  //! the stage of the fallback chain that produced the last solution, and the number of solutions per stage
+  SolutionStage GetLastSolutionStage() {return last_stage;}
+  long GetSolutionStageCount(SolutionStage stage) {
+    return stage==ADAPTIVE ? num_solutions - stage_count[NONADAPTIVE_WARM] - stage_count[NONADAPTIVE_COLD]
+                             - stage_count[FAILED] : stage_count[stage];}
+
+  //! Solves the problem (same inputs/outputs as ComputeRiemannSolution), and computes the Jacobians of the
+  //! solution at xi = 0 (dVs) and of the star states (dVsm, dVsp, can be NULL) w.r.t. the inputs, from the
+  //! converged solution: the star pressure satisfies ul*(p) = ur*(p), so its derivatives follow from those
+  //! of the two wave curves (implicit function theorem). Each Jacobian is 5x10, row-major; column j
+  //! corresponds to Vm[j] (j<5) or Vp[j-5]. Returns the error code of ComputeRiemannSolution. In the case
+  //! of vacuum or cavitation, or if the derivatives cannot be computed (returns 1), the Jacobians are zero.
+  int ComputeRiemannSolutionJacobian(double *dir, double *Vm, int idm, double *Vp, int idp,
+                                     double *Vs, int &id, double *Vsm, double *Vsp,
+                                     double *dVs, double *dVsm = NULL, double *dVsp = NULL);
+
   virtual void PrintStarRelations(double rhol, double ul, double pl, int idl,
                           double rhor, double ur, double pr, int idr,
                           double pmin, double pmax, double dp);
@@ -54,10 +122,14 @@ public:
                                              double *Vm, int idm /*left state*/,
                                              double *Ustar, /*interface/wall velocity (3D)*/
                                              double *Vs, int &id, /*solution at xi = 0 (i.e. x=0), id = -1 if invalid*/
-                                             double *Vsm /*left 'star' solution*/);
+                                             double *Vsm /*left 'star' solution*/,
+                                             double *ps_hint = NULL /*estimate of p*, e.g., from the previous time step.
+                                                                      only used for a shock, if *ps_hint > pl*/);
 
 #if PRINT_RIEMANN_SOLUTION == 1
   vector<vector<double> > sol1d;
+  std::string solution_file; //!< the 1D solution is written to this file ("": not written)
+  void SetSolutionFile(const char *filename); //!< also applied to the fallback solver
 #endif
 
 protected: //internal functions
@@ -97,6 +169,57 @@ protected: //internal functions
            double &p0, double &rhol0, double &rhor0, double &ul0, double &ur0,
            double &p1, double &rhol1, double &rhor1, double &ul1, double &ur1/*outputs*/);
 
+  virtual int FindInitialFeasiblePointsByAtlas(double rhol, double ul, double pl, double cl, int idl,
+           double rhor, double ur, double pr, double cr, int idr, /*inputs*/
+           double &p0, double &rhol0, double &rhor0, double &ul0, double &ur0,
+           double &p1, double &rhol1, double &rhor1, double &ul1, double &ur1/*outputs*/);
+
+  //! Evaluates the star relation at a vector of candidate pressures and picks the narrowest
+  //! bracketing interval. nknown: number of feasible points already stored in (p0, ...), (p1, ...)
+  bool FindInitialIntervalBySampling(double rhol, double ul, double pl, double cl, int idl,
+           double rhor, double ur, double pr, double cr, int idr, int nknown, /*inputs*/
+           double &p0, double &rhol0, double &rhor0, double &ul0, double &ur0,
+           double &p1, double &rhol1, double &rhor1, double &ul1, double &ur1/*outputs*/);
+
+  //! Linearized (acoustic) star state with a second-order correction. Returns false if the jumps
+  //! are above acoustic_threshold, or if the approximation cannot be trusted.
+  bool ComputeLinearizedStarState(double rhol, double ul, double pl, double cl, int idl,
+                                  double rhor, double ur, double pr, double cr, int idr, /*inputs*/
+                                  double &rhol2, double &rhor2, double &u2, double &p2/*outputs*/);
+
+  //! Re-solves the problem using the non-adaptive solver ("fallback"), starting from "interval" =
+  //! {p0, rhol0, rhor0, p1, rhol1, rhor1} found by this solver. Records the stage that succeeded.
+  int ComputeRiemannSolutionByFallback(double *dir, double *Vm, int idl, double *Vp, int idr,
+                                       double *Vs, int &id, double *Vsm, double *Vsp, double *interval);
+
+  //! Returns 2 (vacuum) or 3 (cavitation) if the two rarefactions cannot meet at any pressure above the
+  //! floor (see the .cpp file), in which case the states at the floor are computed. Otherwise returns 0.
+  int FindVacuumState(double rhol, double ul, double pl, double el, double cl, int idl,
+                      double rhor, double ur, double pr, double er, double cr, int idr, /*inputs*/
+                      double &pf, double &rhol2, double &ul2, double &rhor2, double &ur2,
+                      bool &trans_rare, double *Vrare_x0 /*outputs*/);
+
+  //! pressure ps at density rhos (< rho) along the isentrope through (rho, e). Returns false if it cannot be reached
+  bool ComputeIsentropicPressure(int id, double rho, double e, double rhos, double &ps);
+
+  //! Like FinalizeSolution, for a vacuum or cavitated region between ul2 and ur2 (ul2 < ur2)
+  void FinalizeVacuumSolution(double *dir, double *Vm, double *Vp,
+                              double rhol, double ul, double pl, double cl, int idl,
+                              double rhor, double ur, double pr, double cr, int idr,
+                              double rhol2, double rhor2, double ul2, double ur2, double pf,
+                              bool trans_rare, double Vrare_x0[3], /*inputs*/
+                              double *Vs, int &id, double *Vsm, double *Vsp /*outputs*/);
+
+  //! Integrates a transonic rarefaction again from the initial state (rho, u, p) to ps, and samples it at
+  //! x = 0. Returns false, leaving Vrare_x0 unchanged, if the integration fails or does not cross x = 0
+  bool ResampleTransonicRarefaction(int wavenumber, double rho, double u, double p, int id, double ps,
+                                    double rhos, double Vrare_x0[3]);
+
+  //! Returns -1 (1) if the solution at xi = 0 is provably the left (right) initial state, 0 otherwise.
+  //! Used to skip the iterations when the star states are not requested.
+  int FindUpwindInitialState(double rhol, double ul, double pl, double cl, int idl,
+                             double rhor, double ur, double pr, double cr, int idr);
+
   virtual bool ComputeRhoUStar(int wavenumber /*1 or 3*/,
 		   std::vector<std::vector<double>>& integrationPath /*3 by n, first index: 1-pressure, 2-density, 3-velocity*/,
                    double rho, double u, double p, double ps, int id/*inputs*/,
@@ -104,12 +227,32 @@ protected: //internal functions
                    double &rhos, double &us/*outputs*/,
                    bool *trans_rare = NULL, double *Vrare_x0 = NULL/*filled only if found tran rf*/);
 
+  //! Used in ComputeRhoUStar if the EOS does not provide a closed-form solution of the Hugoniot equation.
+  //! Safeguarded Newton iterations for JWL without an admissible initial guess (the only case in which
+  //! they were measured to be faster); otherwise, or if Newton fails, bracketing + root-finding.
+  bool SolveHugoniotEquationNewton(int id, double rho, double p, double ps/*inputs*/,
+                                   double rhos0, double rhos1/*initial guesses*/,
+                                   double &rhos/*output*/);
+
+  bool SolveHugoniotEquationIteratively(int wavenumber /*1 or 3*/, int id,
+                                        double rho, double p, double ps/*inputs*/,
+                                        double rhos0, double rhos1/*initial guesses*/,
+                                        double &rhos/*output*/);
+
   virtual bool Rarefaction_OneStepRK4(int wavenumber/*1 or 3*/, int id,
                             double rho_0, double u_0, double p_0 /*start state*/, 
                             double dp /*step size*/,
                             double &rho, double &u, double &p, double &xi /*output*/,
                             double & uErr, double & rhoErr /*output: absolute error in us*/);
 
+  //! Same as Rarefaction_OneStepRK4, but also integrates e along the isentrope (de = p/rho^2 drho),
+  //! so that only p(rho,e) and c(rho,e) are evaluated. Used for EOS with HasIterativeInverse() = true.
+  bool Rarefaction_OneStepRK4_RhoE(int wavenumber/*1 or 3*/, int id,
+                                   double rho_0, double u_0, double p_0, double e_0 /*start state*/,
+                                   double dp /*step size*/,
+                                   double &rho, double &u, double &p, double &e, double &xi /*output*/,
+                                   double & uErr, double & rhoErr /*output: absolute error in us*/);
+
   virtual void FinalizeSolution(double *dir, double *Vm, double *Vp,
            double rhol, double ul, double pl, int idl,
            double rhor, double ur, double pr, int idr,
@@ -122,14 +265,17 @@ protected: //internal functions
   
   //! In the case of a shock, need two initial guesses of pressure
   bool FindInitialIntervalOneSided(double rhol, double ul, double pl, double el, double cl, int idl, double ustar,
-           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/);
+           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/,
+           double *ps_hint = NULL/*if given and > pl, replaces the acoustic estimate*/);
 
   bool FindInitialFeasiblePointsOneSided(double rhol, double ul, double pl, double el, double cl, int idl, double ustar,
-           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/);
+           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/,
+           double *ps_hint = NULL/*if given and > pl, replaces the acoustic estimate*/);
 
   int FindInitialFeasiblePointsOneSidedByAcousticTheory(double rhol, double ul,
            double pl, double el, double cl, int idl, double ustar,
-           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/);
+           double &p0, double &rhol0, double &ul0, double &p1, double &rhol1, double &ul1/*outputs*/,
+           double *ps_hint = NULL/*if given and > pl, replaces the acoustic estimate*/);
 
   //! Integrate the isentropic relations to the wall velocity us.
   bool ComputeOneSidedRarefaction(double rho, double u, double p, double e,
@@ -143,6 +289,26 @@ protected: //internal functions
                                 double *Vs, int &id, double *Vsm /*outputs*/);
 
 
+  //! For sensitivities (Jacobians) and the generalized Riemann problem
+
+  //! where xi = 0 lies in the last (two-sided) solution, and on which side of the contact (last_left).
+  //! Recorded by FinalizeSolution (and wherever else Vs is set), instead of comparing Vs with the states
+  enum SolutionRegion {INITIAL_STATE = 0, STAR_STATE = 1, RAREFACTION_FAN = 2};
+  SolutionRegion last_region;
+  bool last_left;
+
+  //! Derivatives of a wave curve u* = u -/+ f(ps; rho, p) (1-wave/3-wave) and of the density rhos on it, w.r.t.
+  //! (ps, rho, p), i.e. df = {df/dps, df/drho, df/dp}, and drhos likewise. rhos (input) is the density at ps.
+  //! Shock: the Hugoniot eq. is differentiated. Rarefaction: closed form for (Noble-Abel) stiffened gas,
+  //! otherwise the sensitivity of the isentrope to the initial state is integrated (RK4).
+  bool ComputeWaveCurveDerivatives(int id, double rho, double p, double ps, double rhos,
+                                   double *df, double *drhos);
+
+  //! c^2(rho, p) and its partial derivatives, from VarFcnBase::ComputeSoundSpeedSquareAndDerivatives (exact
+  //! for EOS with a templated pressure formula, finite differences in (rho, e) otherwise, e.g., ANEOS)
+  double ComputeSoundSpeedSquareDerivatives(int id, double rho, double p, double &dc2_drho, double &dc2_dp);
+
+
 };
 
 
@@ -164,6 +330,16 @@ public:
                              double *Vsp /*right 'star' solution*/,
                              double curvature = 0.0);
 
+  //! Same as ComputeRiemannSolution, but first tries the interval [p0, p1] found by another (e.g., the
+  //! adaptive) solver, with interval = {p0, rhol0, rhor0, p1, rhol1, rhor1}. The star densities are used
+  //! as initial guesses for the Hugoniot eq. The rarefactions are integrated again by this solver (the
+  //! integration paths of the other solver are not reused). The interval is used only if p0 < p1 and it
+  //! still brackets the root with the wave curves of this solver; otherwise, the problem is solved from
+  //! scratch. *warm (if not NULL) is set to true if the interval is used.
+  int ComputeRiemannSolutionFromInterval(double *dir, double *Vm, int idm, double *Vp, int idp,
+                             double *Vs, int &id, double *Vsm, double *Vsp, double *interval,
+                             bool *warm = NULL);
+
 protected:
   bool ComputeRhoUStar(int wavenumber /*1 or 3*/,
 		   std::vector<std::vector<double>>& integrationPath /*3 by n, first index: 1-pressure, 2-density, 3-velocity*/,
@@ -0,0 +1,492 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <ExactRiemannSolverBatch.h>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+// Compile the lock-step kernel for several instruction sets; the loader picks one at runtime
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__INTEL_COMPILER)
+#define RIEMANN_SIMD_CLONES __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define RIEMANN_SIMD_CLONES
+#endif
+
+#define SIMD_WIDTH 8 //number of faces processed in lock-step (one AVX-512 or two AVX2 registers)
+
+//-----------------------------------------------------
+
+ExactRiemannSolverBatch::ExactRiemannSolverBatch(std::vector<VarFcnBase*> &vf_,
+                                                 ExactRiemannSolverData &iod_riemann,
+                                                 ExactRiemannSolverBase &riemann_)
+                       : vf(vf_), riemann(riemann_), pattern_count(SIZE, 0),
+                         num_one_sided(0), num_one_sided_duplicates(0)
+{
+  tol_main    = iod_riemann.tol_main;
+  maxIts_main = iod_riemann.maxIts_main;
+  pressure_at_failure = iod_riemann.pressure_at_failure;
+}
+
+//-----------------------------------------------------
+
+int
+ExactRiemannSolverBatch::ComputeRiemannSolutions(int N, double *dir, double *Vm, int *idm, double *Vp, int *idp,
+                                                 double *Vs, int *id, double *Vsm, double *Vsp)
+{
+  if(N<=0)
+    return 0;
+
+  int nm = vf.size();
+  int nbins = SIZE*nm*nm;
+
+  // pre-pass: classification
+  pattern.resize(N);
+  em.resize(N);
+  ep.resize(N);
+  for(int i=0; i<N; i++) {
+    pattern[i] = ClassifyWavePattern(dir+3*i, Vm+5*i, idm[i], Vp+5*i, idp[i], em[i], ep[i]);
+    pattern_count[pattern[i]]++;
+  }
+
+  // bin the faces by wave pattern and material pair (counting sort; stable)
+  auto key = [&](int i) {return (pattern[i]*nm + idm[i])*nm + idp[i];};
+  bin_offset.assign(nbins+1, 0);
+  for(int i=0; i<N; i++)
+    bin_offset[key(i)+1]++;
+  for(int b=0; b<nbins; b++)
+    bin_offset[b+1] += bin_offset[b];
+  order.resize(N);
+  for(int i=0; i<N; i++)
+    order[bin_offset[key(i)]++] = i;
+
+  // solve bin by bin (each bin is now a contiguous segment of "order")
+  int nfailed = 0;
+  for(int start=0; start<N; ) {
+    int i0 = order[start];
+    int end = start+1;
+    while(end<N && key(order[end]) == key(i0))
+      end++;
+    nfailed += SolveBin((WavePattern)pattern[i0], idm[i0], idp[i0], end-start, order.data()+start,
+                        dir, Vm, Vp, Vs, id, Vsm, Vsp);
+    start = end;
+  }
+
+  return nfailed;
+}
+
+//-----------------------------------------------------
+/** Duplicates are detected using a hash table (open addressing, linear probing) of the inputs, which
+ * are compared bitwise, as the solution is copied. The first face of each group is solved, using its
+ * estimate of p* (if given) to initialize the search for the bracketing interval in the case of a shock.
+ */
+int
+ExactRiemannSolverBatch::ComputeOneSidedRiemannSolutions(int N, double *dir, double *Vm, int *idm,
+                                                         double *Ustar, double *Vs, int *id, double *Vsm,
+                                                         double *ps_hint)
+{
+  if(N<=0)
+    return 0;
+
+  auto same = [&](int i, int j) {
+    return idm[i] == idm[j] && !memcmp(Vm+5*i, Vm+5*j, 5*sizeof(double)) &&
+           !memcmp(dir+3*i, dir+3*j, 3*sizeof(double)) && !memcmp(Ustar+3*i, Ustar+3*j, 3*sizeof(double));
+  };
+
+  int size = 1;
+  while(size < 2*N)
+    size *= 2;
+  hash_table.assign(size, -1);
+  first.resize(N);
+  for(int i=0; i<N; i++) {
+    uint64_t h = 14695981039346656037ULL ^ (uint64_t)idm[i]; //FNV-1a
+    const double *data[3] = {Vm+5*i, dir+3*i, Ustar+3*i};
+    const int len[3] = {5, 3, 3};
+    for(int a=0; a<3; a++)
+      for(int k=0; k<len[a]; k++) {
+        uint64_t bits;
+        memcpy(&bits, data[a]+k, sizeof(bits));
+        h = (h ^ bits)*1099511628211ULL;
+      }
+    int slot = (int)((h ^ (h>>32)) & (uint64_t)(size-1));
+    while(hash_table[slot]>=0 && !same(hash_table[slot], i))
+      slot = (slot+1) & (size-1);
+    if(hash_table[slot]<0)
+      hash_table[slot] = i;
+    first[i] = hash_table[slot]; //first[i] <= i
+  }
+
+  int nfailed = 0;
+  double vsm[5];
+  status.resize(N);
+  for(int i=0; i<N; i++) {
+    double *vs = Vs+5*i;
+    double *vsm_i = Vsm ? Vsm+5*i : vsm;
+    if(first[i] == i)
+      status[i] = riemann.ComputeOneSidedRiemannSolution(dir+3*i, Vm+5*i, idm[i], Ustar+3*i, vs, id[i], vsm_i,
+                                                         ps_hint ? ps_hint+i : NULL);
+    else { //copy (first[i] < i, already solved)
+      int i0 = first[i];
+      for(int k=0; k<5; k++)
+        vs[k] = Vs[5*i0+k];
+      if(Vsm)
+        for(int k=0; k<5; k++)
+          vsm_i[k] = Vsm[5*i0+k];
+      id[i] = id[i0];
+      status[i] = status[i0];
+      num_one_sided_duplicates++;
+    }
+    if(status[i])
+      nfailed++;
+  }
+  num_one_sided += N;
+
+  return nfailed;
+}
+
+//-----------------------------------------------------
+/** The pressure function f(p) = f_l(p) + f_r(p) + ur - ul is replaced by its acoustic approximation
+ * f_K(p) = (p - p_K)/(rho_K*c_K). So the tests f(pmin) > 0 and f(pmax) < 0 become comparisons
+ * between the acoustic estimate of p* and pl, pr. A rarefaction is flagged as transonic if the
+ * characteristic speed changes sign between the initial state and the (estimated) star state.
+ */
+ExactRiemannSolverBatch::WavePattern
+ExactRiemannSolverBatch::ClassifyWavePattern(double *dir, double *Vm, int idm, double *Vp, int idp,
+                                             double &el, double &er)
+{
+  double rhol = Vm[0];
+  double ul   = Vm[1]*dir[0] + Vm[2]*dir[1] + Vm[3]*dir[2];
+  double pl   = Vm[4];
+  double rhor = Vp[0];
+  double ur   = Vp[1]*dir[0] + Vp[2]*dir[1] + Vp[3]*dir[2];
+  double pr   = Vp[4];
+
+  // computed for all faces, as the scalar solver needs them anyway
+  el = vf[idm]->GetInternalEnergyPerUnitMass(rhol, pl);
+  er = vf[idp]->GetInternalEnergyPerUnitMass(rhor, pr);
+
+  if(ul == ur && pl == pr)
+    return TRIVIAL;
+
+  double cl = vf[idm]->ComputeSoundSpeedSquare(rhol, el);
+  double cr = vf[idp]->ComputeSoundSpeedSquare(rhor, er);
+  if(!(rhol>0 && rhor>0 && cl>0 && cr>0)) //let the solver handle (and report) it
+    return NEAR_VACUUM;
+  cl = sqrt(cl);
+  cr = sqrt(cr);
+
+  double Cl = rhol*cl, Cr = rhor*cr; //acoustic impedances
+  double ps = (Cr*pl + Cl*pr + Cl*Cr*(ul - ur))/(Cl + Cr);
+  double us = (Cl*ul + Cr*ur + pl - pr)/(Cl + Cr);
+
+  if(ps <= 0.0)
+    return NEAR_VACUUM;
+
+  bool left_rarefaction  = ps <= pl;
+  bool right_rarefaction = ps <= pr;
+
+  if((left_rarefaction  && ul - cl < 0.0 && us - cl > 0.0) ||
+     (right_rarefaction && ur + cr > 0.0 && us + cr < 0.0))
+    return TRANSONIC_RAREFACTION;
+
+  if(left_rarefaction)
+    return right_rarefaction ? RAREFACTION_RAREFACTION : RAREFACTION_SHOCK;
+  return right_rarefaction ? SHOCK_RAREFACTION : SHOCK_SHOCK;
+}
+
+//-----------------------------------------------------
+
+int
+ExactRiemannSolverBatch::SolveBin(WavePattern p, int idm, int idp, int nfaces, int *faces,
+                                  double *dir, double *Vm, double *Vp, double *Vs, int *id,
+                                  double *Vsm, double *Vsp)
+{
+  double gam, pc, b;
+  // Note: For stiffened gases, p* < 0 is not necessarily near vacuum (i.e. p* = -pc), which the kernel
+  // checks precisely.
+  if(p != TRIVIAL && p != TRANSONIC_RAREFACTION &&
+     vf[idm]->GetStiffenedGasParameters(gam, pc, b) && vf[idp]->GetStiffenedGasParameters(gam, pc, b))
+    return SolveBinStiffenedGas(idm, idp, nfaces, faces, dir, Vm, Vp, Vs, id, Vsm, Vsp);
+
+  int nfailed = 0;
+  for(int n=0; n<nfaces; n++) {
+    int i = faces[n];
+    if(riemann.ComputeRiemannSolutionWithEnergies(dir+3*i, Vm+5*i, idm, em[i], Vp+5*i, idp, ep[i], Vs+5*i, id[i],
+                                                  Vsm ? Vsm+5*i : NULL, Vsp ? Vsp+5*i : NULL) == 1)
+      nfailed++;
+  }
+  return nfailed;
+}
+
+//-----------------------------------------------------
+/** Lock-step Newton iterations for f(p) = f_l(p) + f_r(p) + ur - ul = 0, where (with P = p + pc,
+ * V = 1/rho, and z = (gam-1)/(2*gam))
+ *   f_K(p) = (p - pK)*sqrt(A_K/(p + B_K)),  A_K = 2(V_K - b)/(gam+1), B_K = pc + (gam-1)/(gam+1)*P_K (shock)
+ *   f_K(p) = 2*c_K*(1 - b*rho_K)/(gam-1)*((P/P_K)^z - 1)  (rarefaction)
+ * (Toro, Chapter 4, extended to NASG). f is increasing and concave, so after the first step the
+ * iterations approach the root monotonically from the left. The pressure floor of each face is the same as
+ * in ExactRiemannSolverBase::FindVacuumState: pf = max(pmin, -pc + pressure_at_failure, p(rhomin) along the
+ * isentropes). If f(pf) >= 0, the root is not above the floor (vacuum or cavitation), and the face is left
+ * to the scalar solver. The (possible) first step below pf is cut back. Each group of SIMD_WIDTH faces
+ * iterates in lock-step; converged lanes are masked. The tolerances are those of ExactRiemannSolverBase,
+ * but err_p is measured by the Newton step, instead of the width of a bracketing interval (the
+ * iterations do not maintain one). Since the convergence is quadratic, the error of the returned p is
+ * much smaller than the last step. pow is evaluated in a separate loop so that the rest of each iteration
+ * can be vectorized.
+ * status: 0 (converged), 1 (no solution above the floor, i.e. vacuum or cavitation), 2 (not converged).
+ */
+RIEMANN_SIMD_CLONES
+static void
+StiffenedGasLockStep(int n, const double *sl, const double *sr, double gl, double pcl, double bl, double rhominl,
+                     double gr, double pcr, double br, double rhominr, double pmin, double pressure_at_failure,
+                     double tol, int maxIts, double *ps, int *status)
+{
+  const int W = SIMD_WIDTH;
+  const double zl = 0.5*(gl - 1.0)/gl, zr = 0.5*(gr - 1.0)/gr;
+  // floor independent of the states: cut-off and vacuum pressures (representable, i.e. > -pc)
+  const double pfloor0 = std::max(pmin, std::max(-pcl + std::max(pressure_at_failure, 1.0e-12*pcl),
+                                                 -pcr + std::max(pressure_at_failure, 1.0e-12*pcr)));
+
+  for(int g=0; g<n; g+=W) {
+
+    // lane constants (the last group is padded with copies of its first face)
+    double ul[W], ur[W], pl[W], pr[W], PL[W], PR[W], Al[W], Ar[W], Bl[W], Br[W];
+    double Cl[W], Cr[W], Il[W], Ir[W], scale[W], cmax[W];
+    double p[W], rl[W], rr[W], pf[W];
+    int active[W], fail[W];
+
+    for(int k=0; k<W; k++) {
+      int i = g + (g+k<n ? k : 0);
+      double rhol = sl[i], cl = sl[3*n+i], rhor = sr[i], cr = sr[3*n+i];
+      ul[k] = sl[n+i];  pl[k] = sl[2*n+i];
+      ur[k] = sr[n+i];  pr[k] = sr[2*n+i];
+      PL[k] = pl[k] + pcl;
+      PR[k] = pr[k] + pcr;
+      Al[k] = 2.0*(1.0/rhol - bl)/(gl + 1.0);
+      Ar[k] = 2.0*(1.0/rhor - br)/(gr + 1.0);
+      Bl[k] = pcl + (gl - 1.0)/(gl + 1.0)*PL[k];
+      Br[k] = pcr + (gr - 1.0)/(gr + 1.0)*PR[k];
+      Cl[k] = 2.0*cl*(1.0 - bl*rhol)/(gl - 1.0);
+      Cr[k] = 2.0*cr*(1.0 - br*rhor)/(gr - 1.0);
+      Il[k] = 1.0/(rhol*cl);
+      Ir[k] = 1.0/(rhor*cr);
+      scale[k] = std::max(fabs(pl[k] + 0.5*rhol*ul[k]*ul[k]), fabs(pr[k] + 0.5*rhor*ur[k]*ur[k]));
+      cmax[k] = std::max(cl, cr);
+      // floor: also the pressure at the density cut-off along the isentropes
+      pf[k] = pfloor0;
+      if(rhominl>0.0 && rhominl<rhol)
+        pf[k] = std::max(pf[k], -pcl + PL[k]*pow((1.0/rhol - bl)/(1.0/rhominl - bl), gl));
+      if(rhominr>0.0 && rhominr<rhor)
+        pf[k] = std::max(pf[k], -pcr + PR[k]*pow((1.0/rhor - br)/(1.0/rhominr - br), gr));
+      // initial guess: acoustic theory
+      double p_ac = (pl[k]/Il[k] + pr[k]/Ir[k] + (ul[k] - ur[k])/(Il[k]*Ir[k]))*Il[k]*Ir[k]/(Il[k] + Ir[k]);
+      p[k] = std::max(p_ac, pf[k] + 1.0e-3*fabs(std::max(pl[k], pr[k]) - pf[k]));
+      active[k] = g+k<n;
+      fail[k] = 0;
+    }
+
+    // a root exists above the floor iff f(pf) < 0. Otherwise, a vacuum (or cavitation) forms.
+    for(int k=0; k<W; k++) {
+      rl[k] = pow((pf[k] + pcl)/PL[k], zl);
+      rr[k] = pow((pf[k] + pcr)/PR[k], zr);
+    }
+    for(int k=0; k<W; k++) {
+      double fl = pf[k] > pl[k] ? (pf[k] - pl[k])*sqrt(Al[k]/(pf[k] + Bl[k])) : Cl[k]*(rl[k] - 1.0);
+      double fr = pf[k] > pr[k] ? (pf[k] - pr[k])*sqrt(Ar[k]/(pf[k] + Br[k])) : Cr[k]*(rr[k] - 1.0);
+      int vacuum = fl + fr + ur[k] - ul[k] >= 0.0;
+      fail[k]   = vacuum;
+      active[k] = active[k] & !vacuum;
+    }
+
+    for(int it=0; it<maxIts; it++) {
+
+      int nactive = 0;
+      for(int k=0; k<W; k++)
+        nactive += active[k];
+      if(nactive==0)
+        break;
+
+      for(int k=0; k<W; k++) {
+        rl[k] = pow((p[k] + pcl)/PL[k], zl);
+        rr[k] = pow((p[k] + pcr)/PR[k], zr);
+      }
+
+      for(int k=0; k<W; k++) {
+        // left wave
+        double sq = sqrt(Al[k]/(p[k] + Bl[k]));
+        bool shock = p[k] > pl[k];
+        double fl  = shock ? (p[k] - pl[k])*sq : Cl[k]*(rl[k] - 1.0);
+        double dfl = shock ? sq*(1.0 - 0.5*(p[k] - pl[k])/(p[k] + Bl[k])) : Il[k]*rl[k]*PL[k]/(p[k] + pcl);
+        // right wave
+        sq = sqrt(Ar[k]/(p[k] + Br[k]));
+        shock = p[k] > pr[k];
+        double fr  = shock ? (p[k] - pr[k])*sq : Cr[k]*(rr[k] - 1.0);
+        double dfr = shock ? sq*(1.0 - 0.5*(p[k] - pr[k])/(p[k] + Br[k])) : Ir[k]*rr[k]*PR[k]/(p[k] + pcr);
+
+        double f  = fl + fr + ur[k] - ul[k];
+        double pn = p[k] - f/(dfl + dfr);
+        pn = pn > pf[k] ? pn : 0.5*(p[k] + pf[k]);
+
+        double err_p = fabs(pn - p[k])/scale[k];
+        double err_u = fabs(f)/cmax[k];
+        // (bitwise operators avoid branches, to allow vectorization)
+        int converged = ((err_p < tol) & (err_u < tol)) | (err_p < tol*1.0e-3) | (err_u < tol*1.0e-3);
+
+        p[k] = active[k] ? pn : p[k];
+        active[k] = active[k] & !converged;
+      }
+    }
+
+    for(int k=0; k<W && g+k<n; k++) {
+      ps[g+k] = p[k];
+      status[g+k] = fail[k] ? fail[k] : (active[k] ? 2 : 0);
+    }
+  }
+}
+
+//-----------------------------------------------------
+
+int
+ExactRiemannSolverBatch::SolveBinStiffenedGas(int idm, int idp, int nfaces, int *faces, double *dir,
+                                              double *Vm, double *Vp, double *Vs, int *id,
+                                              double *Vsm, double *Vsp)
+{
+  double gl, pcl, bl, gr, pcr, br;
+  vf[idm]->GetStiffenedGasParameters(gl, pcl, bl);
+  vf[idp]->GetStiffenedGasParameters(gr, pcr, br);
+
+  // gather (SoA)
+  sl.resize(4*nfaces);
+  sr.resize(4*nfaces);
+  ps.resize(nfaces);
+  status.resize(nfaces);
+  for(int n=0; n<nfaces; n++) {
+    int i = faces[n];
+    double *d = dir+3*i, *vm = Vm+5*i, *vp = Vp+5*i;
+    sl[n]          = vm[0];
+    sl[nfaces+n]   = vm[1]*d[0] + vm[2]*d[1] + vm[3]*d[2];
+    sl[2*nfaces+n] = vm[4];
+    sl[3*nfaces+n] = sqrt(gl*(vm[4] + pcl)/(vm[0]*(1.0 - bl*vm[0])));
+    sr[n]          = vp[0];
+    sr[nfaces+n]   = vp[1]*d[0] + vp[2]*d[1] + vp[3]*d[2];
+    sr[2*nfaces+n] = vp[4];
+    sr[3*nfaces+n] = sqrt(gr*(vp[4] + pcr)/(vp[0]*(1.0 - br*vp[0])));
+  }
+
+  StiffenedGasLockStep(nfaces, sl.data(), sr.data(), gl, pcl, bl, vf[idm]->rhomin, gr, pcr, br, vf[idp]->rhomin,
+                       std::max(vf[idm]->pmin, vf[idp]->pmin), pressure_at_failure, tol_main, maxIts_main,
+                       ps.data(), status.data());
+
+  // star states and the solution at xi = 0 (same logic as ExactRiemannSolverBase::FinalizeSolution)
+  int nfailed = 0, nsolved = 0;
+  for(int n=0; n<nfaces; n++) {
+
+    int i = faces[n];
+    double *d = dir+3*i, *vm = Vm+5*i, *vp = Vp+5*i;
+    double *vsm = Vsm ? Vsm+5*i : NULL, *vsp = Vsp ? Vsp+5*i : NULL;
+
+    if(status[n]) {
+      if(riemann.ComputeRiemannSolutionWithEnergies(d, vm, idm, em[i], vp, idp, ep[i], Vs+5*i, id[i], vsm, vsp) == 1)
+        nfailed++;
+      continue;
+    }
+
+    double rhol = sl[n], ul = sl[nfaces+n], pl = sl[2*nfaces+n], cl = sl[3*nfaces+n];
+    double rhor = sr[n], ur = sr[nfaces+n], pr = sr[2*nfaces+n], cr = sr[3*nfaces+n];
+    double p2 = ps[n];
+
+    // left: shock (Hugoniot, linear in V) or rarefaction (isentrope (p+pc)(V-b)^gam = const)
+    double Vl = 1.0/rhol, Vl2, ul2;
+    if(p2 > pl) {
+      Vl2 = Vl - (p2 - pl)*(Vl - bl)/(p2 + gl*pcl + 0.5*(gl - 1.0)*(pl + p2));
+      ul2 = ul - sqrt((p2 - pl)*(Vl - Vl2));
+    } else {
+      double r = (pl + pcl)/(p2 + pcl);
+      Vl2 = bl + (Vl - bl)*pow(r, 1.0/gl);
+      ul2 = ul - 2.0*cl*(1.0 - bl*rhol)/(gl - 1.0)*(pow(r, -0.5*(gl - 1.0)/gl) - 1.0);
+    }
+    double Vr = 1.0/rhor, Vr2, ur2;
+    if(p2 > pr) {
+      Vr2 = Vr - (p2 - pr)*(Vr - br)/(p2 + gr*pcr + 0.5*(gr - 1.0)*(pr + p2));
+      ur2 = ur + sqrt((p2 - pr)*(Vr - Vr2));
+    } else {
+      double r = (pr + pcr)/(p2 + pcr);
+      Vr2 = br + (Vr - br)*pow(r, 1.0/gr);
+      ur2 = ur + 2.0*cr*(1.0 - br*rhor)/(gr - 1.0)*(pow(r, -0.5*(gr - 1.0)/gr) - 1.0);
+    }
+    double rhol2 = 1.0/Vl2, rhor2 = 1.0/Vr2, u2 = 0.5*(ul2 + ur2);
+    double cl2 = sqrt(gl*(p2 + pcl)*Vl2*Vl2/(Vl2 - bl));
+    double cr2 = sqrt(gr*(p2 + pcr)*Vr2*Vr2/(Vr2 - br));
+
+    // transonic rarefaction: leave it to the scalar solver
+    if((p2 <= pl && ul - cl < 0.0 && u2 - cl2 > 0.0) || (p2 <= pr && ur + cr > 0.0 && u2 + cr2 < 0.0) ||
+       !std::isfinite(rhol2) || !std::isfinite(rhor2) || rhol2 <= 0.0 || rhor2 <= 0.0) {
+      if(riemann.ComputeRiemannSolutionWithEnergies(d, vm, idm, em[i], vp, idp, ep[i], Vs+5*i, id[i], vsm, vsp) == 1)
+        nfailed++;
+      continue;
+    }
+
+    double utanl[3] = {vm[1]-ul*d[0], vm[2]-ul*d[1], vm[3]-ul*d[2]};
+    double utanr[3] = {vp[1]-ur*d[0], vp[2]-ur*d[1], vp[3]-ur*d[2]};
+
+    double *vs = Vs+5*i;
+    double rho0, u0, p0;
+    if(u2>=0) { //either Vl or Vlstar --- check the 1-wave
+      id[i] = idm;
+      bool is_star_state = (p2 <= pl) ? (u2 - cl2 <= 0) : ((rhol2*u2 - rhol*ul)/(rhol2 - rhol) <= 0);
+      rho0 = is_star_state ? rhol2 : rhol;
+      u0   = is_star_state ? u2 : ul;
+      p0   = is_star_state ? p2 : pl;
+    } else { //either Vr or Vrstar --- check the 3-wave
+      id[i] = idp;
+      bool is_star_state = (p2 <= pr) ? (u2 - cr2 >= 0) : ((rhor2*u2 - rhor*ur)/(rhor2 - rhor) >= 0);
+      rho0 = is_star_state ? rhor2 : rhor;
+      u0   = is_star_state ? u2 : ur;
+      p0   = is_star_state ? p2 : pr;
+    }
+    vs[0] = rho0;
+    vs[4] = p0;
+    for(int j=1; j<=3; j++)
+      vs[j] = u0*d[j-1] + (u2>0 ? utanl[j-1] : (u2<0 ? utanr[j-1] : 0.5*(utanl[j-1]+utanr[j-1])));
+
+    if(vsm) {
+      vsm[0] = rhol2;
+      vsm[4] = p2;
+      for(int j=1; j<=3; j++)
+        vsm[j] = utanl[j-1] + u2*d[j-1];
+    }
+    if(vsp) {
+      vsp[0] = rhor2;
+      vsp[4] = p2;
+      for(int j=1; j<=3; j++)
+        vsp[j] = utanr[j-1] + u2*d[j-1];
+    }
+    nsolved++;
+  }
+
+  riemann.CountExternalSolutions(nsolved); //the faces passed to the scalar solver are counted there
+  return nfailed;
+}
+
+//-----------------------------------------------------
+
+const char*
+ExactRiemannSolverBatch::GetPatternName(WavePattern p)
+{
+  switch (p) {
+    case TRIVIAL :                 return "Trivial";
+    case RAREFACTION_RAREFACTION : return "Rarefaction-Rarefaction";
+    case SHOCK_RAREFACTION :       return "Shock-Rarefaction";
+    case RAREFACTION_SHOCK :       return "Rarefaction-Shock";
+    case SHOCK_SHOCK :             return "Shock-Shock";
+    case TRANSONIC_RAREFACTION :   return "Transonic Rarefaction";
+    case NEAR_VACUUM :             return "Near Vacuum";
+    default :                      return "Unknown";
+  }
+}
+
+//-----------------------------------------------------
+
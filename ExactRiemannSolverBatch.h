@@ -0,0 +1,118 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _EXACT_RIEMANN_SOLVER_BATCH_H_
+#define _EXACT_RIEMANN_SOLVER_BATCH_H_
+
+#include <ExactRiemannSolverBase.h>
+#include <vector>
+
+/*****************************************************************************************
+ * Class ExactRiemannSolverBatch solves many (two-sided) Riemann problems at once, e.g., all
+ * the faces of a mesh. A pre-pass classifies the wave pattern of each face using the
+ * acoustic (linearized) pressure function, generalizing the test of Toro (Section 4.3.1)
+ * f(pmin) > 0: rarefaction-rarefaction; f(pmax) < 0: shock-shock; otherwise shock-rarefaction.
+ * Then, the faces are binned by wave pattern and material pair, and each bin is passed to
+ * SolveBin (a "kernel"). This way, faces following the same code path are solved together.
+ * The results are written to the original positions of the faces in the output arrays.
+ * The internal energies of the initial states, computed in the pre-pass, are passed on to the
+ * scalar solver (ComputeRiemannSolutionWithEnergies), so e(rho,p) is evaluated once per state.
+ *
+ * For pairs of stiffened gas and/or Noble-Abel stiffened gas (NASG) materials, the wave curves are
+ * known in closed form, and the bins are solved by a lock-step (Newton) kernel that processes
+ * SIMD_WIDTH faces at a time, with per-lane convergence masks. The kernel is compiled for AVX-512,
+ * AVX2, and generic x86-64, and the version is selected at runtime. Faces that fail in the kernel
+ * (including those without a solution above the pressure floor, i.e. vacuum or cavitation), or involve
+ * a transonic rarefaction, are passed to the scalar solver. The kernel does not use the linearized
+ * (acoustic) solver for weak jumps; the faces it solves are added to the solution count of the scalar
+ * solver (so GetAcousticSolutionFraction and GetSolutionStageCount refer to all the faces).
+ * All the other EOS, and pairs of a (NASG) stiffened gas with another EOS, are solved face by face by
+ * the scalar solver, which still benefits from the binning and the energies computed in the pre-pass.
+ *
+ * Inputs/outputs have the same meaning as in ExactRiemannSolverBase::ComputeRiemannSolution,
+ * stored contiguously: dir (3N), Vm, Vp, Vs, Vsm, Vsp (5N), idm, idp, id (N). Vsm and Vsp
+ * can be NULL (if only Vs is needed).
+ *
+ * One-sided (wall/interface) problems are solved by ComputeOneSidedRiemannSolutions, with the
+ * inputs/outputs of ExactRiemannSolverBase::ComputeOneSidedRiemannSolution stored in the same way
+ * (Ustar: 3N). Faces with identical inputs (state, material id, normal, and wall velocity) are solved
+ * only once. Optionally, estimates of p* (e.g., from the previous time step) can be provided. They are
+ * only used in the case of a shock (and only if p* > pl), where they replace the acoustic estimate that
+ * initializes the search for a bracketing interval. A rarefaction is integrated to the wall velocity
+ * directly (no iterations), which does not need an estimate.
+ *****************************************************************************************/
+
+class ExactRiemannSolverBatch {
+
+public:
+
+  enum WavePattern {TRIVIAL = 0, RAREFACTION_RAREFACTION = 1, SHOCK_RAREFACTION = 2,
+                    RAREFACTION_SHOCK = 3, SHOCK_SHOCK = 4, TRANSONIC_RAREFACTION = 5,
+                    NEAR_VACUUM = 6, SIZE = 7};
+
+protected:
+
+  std::vector<VarFcnBase*> &vf;
+  ExactRiemannSolverBase &riemann; //!< the (scalar) solver for individual faces
+
+  double tol_main;
+  int maxIts_main;
+  double pressure_at_failure; //!< offset of the vacuum pressure (as in ExactRiemannSolverBase)
+
+  //! work arrays (reused across calls)
+  std::vector<int> pattern;
+  std::vector<double> em, ep; //!< internal energies of the left and right states (from the pre-pass)
+  std::vector<int> order; //!< faces sorted by bin
+  std::vector<int> bin_offset;
+  std::vector<double> sl, sr, ps; //!< SoA copies of left/right states (rho, u, p, c) and p*
+  std::vector<int> status;
+  std::vector<int> hash_table; //!< one-sided problems: face indices, hashed by the inputs
+  std::vector<int> first; //!< one-sided problems: the first face with the same inputs
+
+  //! statistics (accumulated over all calls)
+  std::vector<long> pattern_count;
+  long num_one_sided, num_one_sided_duplicates;
+
+public:
+
+  ExactRiemannSolverBatch(std::vector<VarFcnBase*> &vf_, ExactRiemannSolverData &iod_riemann,
+                          ExactRiemannSolverBase &riemann_);
+  virtual ~ExactRiemannSolverBatch() {}
+
+  //! returns the number of faces for which the Riemann solver failed (error code 1). Vacuum and
+  //! cavitation (error codes 2 and 3) are valid solutions, and not counted
+  int ComputeRiemannSolutions(int N, double *dir, double *Vm, int *idm, double *Vp, int *idp,
+                              double *Vs, int *id, double *Vsm, double *Vsp);
+
+  //! ps_hint (N) can be NULL. Returns the number of faces for which the Riemann solver reported an error
+  int ComputeOneSidedRiemannSolutions(int N, double *dir, double *Vm, int *idm, double *Ustar,
+                                      double *Vs, int *id, double *Vsm, double *ps_hint = NULL);
+
+  //! classifies the wave pattern (approximately; only used for grouping the faces). The internal
+  //! energies of the two states are returned in el and er
+  WavePattern ClassifyWavePattern(double *dir, double *Vm, int idm, double *Vp, int idp, double &el, double &er);
+
+  long GetPatternCount(WavePattern p) {return pattern_count[p];}
+
+  //! fraction of one-sided problems that were copied from another face in the same batch
+  double GetOneSidedDuplicateFraction() {
+    return num_one_sided>0 ? (double)num_one_sided_duplicates/num_one_sided : 0.0;}
+
+  static const char* GetPatternName(WavePattern p);
+
+protected:
+
+  //! solves the faces in "faces", which share the same wave pattern and material pair.
+  //! The default kernel calls the scalar solver face by face. Returns the number of failures (error code 1).
+  virtual int SolveBin(WavePattern p, int idm, int idp, int nfaces, int *faces,
+                       double *dir, double *Vm, double *Vp, double *Vs, int *id, double *Vsm, double *Vsp);
+
+  //! lock-step kernel for stiffened gas and NASG materials (see above). Returns the number of failures.
+  int SolveBinStiffenedGas(int idm, int idp, int nfaces, int *faces, double *dir, double *Vm,
+                           double *Vp, double *Vs, int *id, double *Vsm, double *Vsp);
+
+};
+
+#endif
@@ -0,0 +1,125 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <ExactRiemannSolverGRP.h>
+#include <cmath>
+
+//-----------------------------------------------------
+
+int
+ExactRiemannSolverGRP::ComputeGeneralizedRiemannSolution(double *dir, double *Vm, double *dVm, int idm,
+                                                         double *Vp, double *dVp, int idp,
+                                                         double *Vs, int &id, double *dVs,
+                                                         double *Vsm, double *Vsp)
+{
+  double Vsm_tmp[5], Vsp_tmp[5];
+  if(!Vsm)
+    Vsm = Vsm_tmp;
+  if(!Vsp)
+    Vsp = Vsp_tmp;
+
+  int err = ComputeRiemannSolution(dir, Vm, idm, Vp, idp, Vs, id, Vsm, Vsp);
+
+  for(int i=0; i<5; i++)
+    dVs[i] = 0.0;
+  if(err==2 || err==3) //vacuum or cavitation
+    return err;
+
+  // normal velocities and their slopes
+  double ul  = Vm[1]*dir[0]  + Vm[2]*dir[1]  + Vm[3]*dir[2];
+  double ur  = Vp[1]*dir[0]  + Vp[2]*dir[1]  + Vp[3]*dir[2];
+  double dul = dVm[1]*dir[0] + dVm[2]*dir[1] + dVm[3]*dir[2];
+  double dur = dVp[1]*dir[0] + dVp[2]*dir[1] + dVp[3]*dir[2];
+  double u2  = Vsm[1]*dir[0] + Vsm[2]*dir[1] + Vsm[3]*dir[2];
+  double us  = Vs[1]*dir[0]  + Vs[2]*dir[1]  + Vs[3]*dir[2];
+
+  double cl2 = ComputeSoundSpeed(idm, Vsm[0], Vsm[4]);
+  double cr2 = ComputeSoundSpeed(idp, Vsp[0], Vsp[4]);
+  if(cl2<=0 || cr2<=0)
+    return err;
+  double Zl2 = Vsm[0]*cl2, Zr2 = Vsp[0]*cr2;
+
+  // slopes of the incoming Riemann invariants (p + Z*u from the left, p - Z*u from the right), and
+  // the material derivatives of u and p along the contact discontinuity
+  double sigl = dVm[4] + Zl2*dul;
+  double sigr = dVp[4] - Zr2*dur;
+  double Du = -(cl2*sigl + cr2*sigr)/(Zl2 + Zr2);
+  double Dp = (-Zr2*cl2*sigl + Zl2*cr2*sigr)/(Zl2 + Zr2);
+
+  // find the state at xi = 0 and the slopes of p + Z*u, p - Z*u, and p - c^2*rho there
+  bool left = last_left; //recorded by FinalizeSolution
+  SolutionRegion region = last_region;
+  double *V0 = left ? Vm : Vp, *dV0 = left ? dVm : dVp, *V2 = left ? Vsm : Vsp;
+  double du0 = left ? dul : dur;
+  double rho, u, c, Z, dwp, dwm;
+
+  // the slopes belong to the upwind initial state, so p - c^2*rho is differentiated there
+  double c0 = ComputeSoundSpeed(left ? idm : idp, V0[0], V0[4]);
+  if(c0<=0)
+    return err;
+
+  if(region == STAR_STATE) { //star state: one invariant comes from the contact
+    rho = V2[0];
+    u   = u2;
+    c   = left ? cl2 : cr2;
+    Z   = rho*c;
+    if(left) {
+      dwp = sigl;
+      dwm = (Dp - Z*Du)/c;
+    } else {
+      dwp = -(Dp + Z*Du)/c;
+      dwm = sigr;
+    }
+  }
+  else if(region == INITIAL_STATE) { //initial state (-A*dV/dx)
+    rho = V0[0];
+    u   = left ? ul : ur;
+    c   = c0;
+    Z   = rho*c;
+    dwp = dV0[4] + Z*du0;
+    dwm = dV0[4] - Z*du0;
+  }
+  else { //inside a transonic rarefaction: sonic state (Vrare_x0) sampled by FinalizeSolution
+    rho = Vs[0];
+    u   = us;
+    c   = ComputeSoundSpeed(left ? idm : idp, rho, Vs[4]);
+    if(c<=0)
+      return err;
+    Z   = rho*c;
+    dwp = left ? dV0[4] + Z*du0 : 0.0;
+    dwm = left ? 0.0 : dV0[4] - Z*du0;
+  }
+  double ds = dV0[4] - c0*c0*dV0[0]; //entropy is carried by the flow from the upwind side
+
+  double dwp_dt = -(u + c)*dwp;
+  double dwm_dt = -(u - c)*dwm;
+  double ds_dt  = -u*ds;
+
+  double dp_dt = 0.5*(dwp_dt + dwm_dt);
+  double du_dt = 0.5*(dwp_dt - dwm_dt)/Z;
+  dVs[0] = (dp_dt - ds_dt)/(c*c);
+  dVs[4] = dp_dt;
+
+  // tangential velocity: advected, upwinding as in FinalizeSolution
+  double dutanl[3] = {dVm[1]-dul*dir[0], dVm[2]-dul*dir[1], dVm[3]-dul*dir[2]};
+  double dutanr[3] = {dVp[1]-dur*dir[0], dVp[2]-dur*dir[1], dVp[3]-dur*dir[2]};
+  for(int i=0; i<3; i++) {
+    double dutan = u2>0 ? dutanl[i] : (u2<0 ? dutanr[i] : 0.5*(dutanl[i] + dutanr[i]));
+    dVs[i+1] = du_dt*dir[i] - us*dutan;
+  }
+
+  return err;
+}
+
+//-----------------------------------------------------
+
+double
+ExactRiemannSolverGRP::ComputeSoundSpeed(int id, double rho, double p)
+{
+  double c2 = vf[id]->ComputeSoundSpeedSquare(rho, vf[id]->GetInternalEnergyPerUnitMass(rho, p));
+  return c2>0 ? sqrt(c2) : -1.0;
+}
+
+//-----------------------------------------------------
@@ -0,0 +1,56 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _EXACT_RIEMANN_SOLVER_GRP_H_
+#define _EXACT_RIEMANN_SOLVER_GRP_H_
+
+#include <ExactRiemannSolverBase.h>
+
+/*****************************************************************************************
+ * Class ExactRiemannSolverGRP solves the generalized Riemann problem (GRP), i.e. a Riemann problem
+ * with piecewise linear initial data V(x,0) = Vm + x*dVm (x<0), Vp + x*dVp (x>0), where x is the
+ * coordinate along dir. It returns the solution at xi = x = 0 (the same as ComputeRiemannSolution),
+ * together with its time derivative (dV/dt)(0, 0+). The state at x = 0 at t = dt/2, i.e.
+ * Vs + 0.5*dt*dVs, gives a second-order (in time and space) flux in a single stage (GRP/ADER-type
+ * schemes), instead of one Riemann problem per Runge-Kutta stage.
+ *
+ * The leading term is the exact solution (ExactRiemannSolverBase). The time derivative is obtained from
+ * the derivative Riemann problem, linearized about the exact solution (the "acoustic" GRP of Ben-Artzi
+ * and Falcovitz; see also Toro, Section 19.4): the slopes of the Riemann invariants p +/- rho*c*u and of
+ * the entropy p - c^2*rho are transported along the characteristics of the exact solution, with the
+ * sound speed c^2 = dp/drho + p/rho^2*dp/de (ComputeSoundSpeedSquare) evaluated at the star (or sonic)
+ * states. The entropy slope is formed with c^2 of the upwind initial state, to which the slopes belong. The material derivatives of u and p along the contact discontinuity are found from the two
+ * incoming characteristics, as in the GRP. This is exact for linear data without jumps, and second-order
+ * accurate in smooth regions.
+ *
+ * The position of xi = 0 in the wave structure (initial state, star state, or inside a transonic
+ * rarefaction) is the one recorded by FinalizeSolution (last_region, last_left). In the transonic case, the derivatives are
+ * evaluated at the sonic state at x = 0, where the characteristic u -/+ c = 0 does not contribute.
+ * In the case of vacuum or cavitation, the time derivative is set to zero (i.e. first order).
+ *****************************************************************************************/
+
+class ExactRiemannSolverGRP : public ExactRiemannSolverBase {
+
+public:
+
+  ExactRiemannSolverGRP(std::vector<VarFcnBase*> &vf_, ExactRiemannSolverData &iod_riemann_)
+      : ExactRiemannSolverBase(vf_, iod_riemann_) {}
+  ~ExactRiemannSolverGRP() {}
+
+  //! dVm, dVp: slopes of the primitive variables along dir (dV/dx). dVs: time derivative of the solution at
+  //! xi = 0. Vsm and Vsp can be NULL. Returns the error code of ComputeRiemannSolution
+  int ComputeGeneralizedRiemannSolution(double *dir, double *Vm, double *dVm, int idm,
+                                        double *Vp, double *dVp, int idp,
+                                        double *Vs, int &id, double *dVs,
+                                        double *Vsm = NULL, double *Vsp = NULL);
+
+protected:
+
+  //! sound speed from the EOS derivatives (-1 if c^2 <= 0)
+  double ComputeSoundSpeed(int id, double rho, double p);
+
+};
+
+#endif
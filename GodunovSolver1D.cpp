@@ -0,0 +1,544 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <GodunovSolver1D.h>
+#include <VarFcnFactory.h>
+#include <Utils.h>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cmath>
+
+//-----------------------------------------------------
+
+GodunovSolver1D::GodunovSolver1D(std::vector<VarFcnBase*> &vf_, IoData &iod_,
+                                 EOSAdmissibilityEnvelope *envelope_, StarPressureAtlas *atlas_,
+                                 int verbose_)
+               : vf(vf_), iod(iod_), envelope(envelope_), atlas(atlas_), verbose(verbose_),
+                 num_exact(0), num_failed(0), num_faces(0)
+{
+  flux = iod.schemes.ns.flux;
+  if(flux == SchemeData::ROE) {
+    print("Warning: The Roe flux is not available in the 1D solver. Using the HLLC flux.\n");
+    flux = SchemeData::HLLC;
+  }
+  interface_flux = iod.multiphase.flux;
+}
+
+//-----------------------------------------------------
+
+int
+GodunovSolver1D::Run()
+{
+  if(SetupMeshAndInitialCondition())
+    return 1;
+
+  TsData &ts(iod.ts);
+  if(ts.maxIts == INT_MAX && ts.maxTime >= 1.0e10) {
+    print_error("*** Error: Time.MaxTime and/or Time.MaxIts must be specified for the 1D solver.\n");
+    return 1;
+  }
+
+  int nThreads = ts.num_threads>0 ? ts.num_threads : std::max(1, (int)std::thread::hardware_concurrency());
+  nThreads = std::max(1, std::min(nThreads, Nx/256)); //not worth it for small meshes
+#if PRINT_RIEMANN_SOLUTION == 1
+  if(nThreads>1) { //the solver prints traces for every face, which would be interleaved
+    print("Warning: The 1D solver uses 1 thread when compiled with PRINT_RIEMANN_SOLUTION.\n");
+    nThreads = 1;
+  }
+#endif
+
+  print("- Solving the 1D problem on [%e, %e] with %d cells and %d material interface(s), using %d thread(s).\n",
+        x0, x0 + Nx*dx, Nx, (int)interfaces.size(), nThreads);
+  fflush(stdout);
+
+  // each thread has its own VarFcn objects (except the first one), solvers, and work arrays
+  std::vector<std::vector<VarFcnBase*> > vf_threads(nThreads);
+  std::vector<ExactRiemannSolverBase*> riemann(nThreads, NULL);
+  std::vector<ExactRiemannSolverBatch*> batch(nThreads, NULL);
+  std::vector<Batch> work(nThreads);
+  std::vector<int> f0(nThreads+1);
+  for(int t=0; t<nThreads; t++) {
+    vf_threads[t] = t==0 ? vf : CopyMaterialVarFcns(vf, iod.eqs.materials, verbose);
+    riemann[t] = new ExactRiemannSolverBase(vf_threads[t], iod.exact_riemann);
+    riemann[t]->SetVerbosity(verbose);
+    if(envelope)
+      riemann[t]->SetAdmissibilityEnvelope(envelope);
+    if(atlas)
+      riemann[t]->SetStarPressureAtlas(atlas);
+#if PRINT_RIEMANN_SOLUTION == 1
+    riemann[t]->SetSolutionFile(""); //do not write the solution of each face
+#endif
+    batch[t] = new ExactRiemannSolverBatch(vf_threads[t], iod.exact_riemann, *riemann[t]);
+    f0[t] = (long)(Nx+1)*t/nThreads;
+  }
+  f0[nThreads] = Nx+1;
+
+  auto parallel = [&](std::function<void(int)> fun) {
+    std::vector<std::thread> threads;
+    for(int t=1; t<nThreads; t++)
+      threads.push_back(std::thread(fun, t));
+    fun(0);
+    for(auto &th : threads)
+      th.join();
+  };
+
+  std::vector<double> smax(nThreads);
+  std::vector<long> nexact(nThreads, 0), nfailed(nThreads, 0);
+  std::vector<int> bad(nThreads);
+
+  double t = 0.0, dt = 0.0;
+  int it = 0, k = 0;
+  double t_next = ts.maxTime;
+  if(iod.output.frequency_dt>0)
+    t_next = std::min(iod.output.frequency_dt, ts.maxTime);
+
+  int err = WriteSnapshot(k++, it, t);
+
+  double flux_time = 0.0;
+  auto start = std::chrono::steady_clock::now();
+
+  while(!err && it<ts.maxIts && t<ts.maxTime) {
+
+    auto flux_start = std::chrono::steady_clock::now();
+    parallel([&](int p) {
+      smax[p] = ComputeFluxes(f0[p], f0[p+1], vf_threads[p], *batch[p], work[p], nexact[p], nfailed[p]);
+    });
+    flux_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - flux_start).count();
+
+    if(ts.timestep>0)
+      dt = ts.timestep;
+    else {
+      double s = *std::max_element(smax.begin(), smax.end());
+      dt = s>0 ? ts.cfl*dx/s : ts.maxTime - t;
+    }
+    bool hit = dt >= t_next - t; //reaching an output time, or MaxTime
+    if(hit)
+      dt = t_next - t;
+
+    parallel([&](int p) {
+      bad[p] = UpdateCells(f0[p], std::min(f0[p+1], Nx), dt, vf_threads[p]);
+    });
+    for(int p=0; p<nThreads; p++)
+      if(bad[p]>=0) {
+        int i = bad[p];
+        print_error("*** Error: Detected invalid state in cell %d (x = %e, material %d) at time step %d: "
+                    "rho = %e, p = %e.\n", i, x[i], id[i], it+1, V[5*i], V[5*i+4]);
+        err = 1;
+        break;
+      }
+    if(err)
+      break;
+
+    MoveInterfaces(dt);
+
+    t = hit ? t_next : t + dt;
+    it++;
+    num_faces += Nx+1;
+
+    bool output = false;
+    if(t >= t_next) {
+      output = iod.output.frequency_dt>0;
+      t_next = std::min(t_next + iod.output.frequency_dt, ts.maxTime);
+    }
+    else if(iod.output.frequency_dt<=0 && iod.output.frequency>0 && it%iod.output.frequency==0)
+      output = true;
+    bool last = it>=ts.maxIts || t>=ts.maxTime;
+
+    if(verbose>=1 || output || last)
+      print("Step %d: t = %e, dt = %e, %d material interface(s).\n", it, t, dt, (int)interfaces.size());
+    if(output || last)
+      err = WriteSnapshot(k++, it, t);
+  }
+
+  double total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  for(int p=0; p<nThreads; p++) {
+    num_exact  += nexact[p];
+    num_failed += nfailed[p];
+    delete batch[p];
+    delete riemann[p];
+    if(p>0)
+      for(auto &v : vf_threads[p])
+        delete v;
+  }
+
+  if(err)
+    return 1;
+
+  print("- Completed %d time step(s) (t = %e). Computed %ld face fluxes, including %ld exact Riemann "
+        "solutions.\n", it, t, num_faces, num_exact);
+  if(num_failed)
+    print("Warning: The Riemann solver failed (and returned an approximate solution) "
+          "at %ld face(s).\n", num_failed);
+  if(flux_time>0 && total_time>0)
+    print("- Flux computation: %e sec. (%e faces per second). Total: %e sec. (%e cell updates per second).\n",
+          flux_time, num_faces/flux_time, total_time, (double)Nx*it/total_time);
+
+  return 0;
+}
+
+//-----------------------------------------------------
+
+int
+GodunovSolver1D::SetupMeshAndInitialCondition()
+{
+  MeshData &mesh(iod.mesh);
+  Nx = mesh.Nx;
+  x0 = mesh.x0;
+  if(Nx<1 || !(mesh.xmax>mesh.x0)) {
+    print_error("*** Error: Detected invalid 1D mesh (X0 = %e, Xmax = %e, NumberOfCellsX = %d).\n",
+                mesh.x0, mesh.xmax, Nx);
+    return 1;
+  }
+  dx = (mesh.xmax - mesh.x0)/Nx;
+
+  x.resize(Nx);
+  V.resize(5*Nx);
+  id.resize(Nx);
+  Fm.resize(5*(Nx+1));
+  Fp.resize(5*(Nx+1));
+  Vsm.resize(5*(Nx+1));
+  Vsp.resize(5*(Nx+1));
+
+  auto &planes(iod.ic.multiInitialConditions.planeMap.dataMap);
+  for(int i=0; i<Nx; i++) {
+    x[i] = x0 + (i+0.5)*dx;
+    StateVariable *s = &iod.ic.default_ic;
+    for(auto it = planes.begin(); it != planes.end(); it++)
+      if((x[i] - it->second->cen_x)*it->second->nx > 0.0)
+        s = &it->second->initialConditions;
+    double *v = &V[5*i];
+    v[0] = s->density;
+    v[1] = s->velocity_x;
+    v[2] = s->velocity_y;
+    v[3] = s->velocity_z;
+    v[4] = s->pressure;
+    id[i] = s->materialid;
+    if(id[i]<0 || id[i]>=(int)vf.size() || vf[id[i]]->CheckState(v[0], v[4], true)) {
+      print_error("*** Error: Detected invalid initial state at x = %e (material %d): rho = %e, p = %e.\n",
+                  x[i], id[i], v[0], v[4]);
+      return 1;
+    }
+  }
+
+  // boundary states (assigned to the material of the adjacent cell)
+  for(int f=0; f<=Nx; f+=Nx) {
+    double Vg[5];
+    GetBoundaryState(f, Vg);
+    int idg = id[f==0 ? 0 : Nx-1];
+    if(vf[idg]->CheckState(Vg[0], Vg[4], true)) {
+      print_error("*** Error: Detected invalid boundary state at x = %e (material %d): rho = %e, p = %e.\n",
+                  x0 + f*dx, idg, Vg[0], Vg[4]);
+      return 1;
+    }
+  }
+
+  // material interfaces (located at the planes, if possible)
+  interfaces.clear();
+  for(int f=1; f<Nx; f++)
+    if(id[f-1] != id[f]) {
+      Interface I = {f, x0 + f*dx};
+      for(auto it = planes.begin(); it != planes.end(); it++)
+        if(it->second->cen_x > x[f-1] && it->second->cen_x < x[f])
+          I.x = it->second->cen_x;
+      interfaces.push_back(I);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------
+
+void
+GodunovSolver1D::GetBoundaryState(int f, double *Vg)
+{
+  MeshData::BcType type = f==0 ? iod.mesh.bc_x0 : iod.mesh.bc_xmax;
+  double *v = f==0 ? &V[0] : &V[5*(Nx-1)];
+
+  if(type == MeshData::INLET || type == MeshData::OUTLET) {
+    StateVariable &s(type == MeshData::INLET ? iod.bc.inlet : iod.bc.outlet);
+    Vg[0] = s.density;
+    Vg[1] = s.velocity_x;
+    Vg[2] = s.velocity_y;
+    Vg[3] = s.velocity_z;
+    Vg[4] = s.pressure;
+    return;
+  }
+
+  for(int j=0; j<5; j++)
+    Vg[j] = v[j];
+
+  if(type == MeshData::SLIPWALL || type == MeshData::SYMMETRY)
+    Vg[1] = -v[1];
+  else if(type == MeshData::STICKWALL) {
+    Vg[1] = -v[1];
+    Vg[2] = -v[2];
+    Vg[3] = -v[3];
+  }
+}
+
+//-----------------------------------------------------
+
+double
+GodunovSolver1D::ComputeFluxes(int f0, int f1, std::vector<VarFcnBase*> &vf_, ExactRiemannSolverBatch &batch,
+                               Batch &b, long &nexact, long &nfailed)
+{
+  b.face.clear();
+  b.dir.clear();
+  b.Vm.clear();
+  b.Vp.clear();
+  b.idm.clear();
+  b.idp.clear();
+
+  // faces that do not need the exact Riemann solver are done right away
+  double Vg[5];
+  for(int f=f0; f<f1; f++) {
+    double *Vl, *Vr;
+    int idl, idr;
+    if(f==0) {
+      GetBoundaryState(f, Vg);
+      Vl = Vg;
+      idl = idr = id[0];
+      Vr = &V[0];
+    } else if(f==Nx) {
+      GetBoundaryState(f, Vg);
+      Vr = Vg;
+      idl = idr = id[Nx-1];
+      Vl = &V[5*(Nx-1)];
+    } else {
+      Vl = &V[5*(f-1)];
+      Vr = &V[5*f];
+      idl = id[f-1];
+      idr = id[f];
+    }
+
+    if(idl == idr && flux != SchemeData::GODUNOV) {
+      ComputeNumericalFlux(flux, vf_[idl], Vl, Vr, &Fm[5*f]);
+      for(int j=0; j<5; j++)
+        Fp[5*f+j] = Fm[5*f+j];
+      continue;
+    }
+
+    b.face.push_back(f);
+    b.dir.push_back(1.0);
+    b.dir.push_back(0.0);
+    b.dir.push_back(0.0);
+    b.Vm.insert(b.Vm.end(), Vl, Vl+5);
+    b.Vp.insert(b.Vp.end(), Vr, Vr+5);
+    b.idm.push_back(idl);
+    b.idp.push_back(idr);
+  }
+
+  // exact Riemann problems
+  int N = b.face.size();
+  if(N>0) {
+    b.Vs.resize(5*N);
+    b.Vsm.resize(5*N);
+    b.Vsp.resize(5*N);
+    b.id.resize(N);
+    nfailed += batch.ComputeRiemannSolutions(N, b.dir.data(), b.Vm.data(), b.idm.data(), b.Vp.data(),
+                                             b.idp.data(), b.Vs.data(), b.id.data(), b.Vsm.data(), b.Vsp.data());
+    nexact += N;
+  }
+
+  for(int k=0; k<N; k++) {
+    int f = b.face[k];
+    int idl = b.idm[k], idr = b.idp[k];
+    double *vs = &b.Vs[5*k], *vsm = &b.Vsm[5*k], *vsp = &b.Vsp[5*k];
+
+    if(idl == idr) { //Godunov flux
+      ComputePhysicalFlux(vf_[idl], vs, &Fm[5*f]);
+      for(int j=0; j<5; j++)
+        Fp[5*f+j] = Fm[5*f+j];
+      continue;
+    }
+
+    for(int j=0; j<5; j++) {
+      Vsm[5*f+j] = vsm[j];
+      Vsp[5*f+j] = vsp[j];
+    }
+
+    if(interface_flux == MultiPhaseData::EXACT || flux == SchemeData::GODUNOV) {
+      ComputePhysicalFlux(vf_[idl], b.id[k]==idl ? vs : vsm, &Fm[5*f]);
+      ComputePhysicalFlux(vf_[idr], b.id[k]==idr ? vs : vsp, &Fp[5*f]);
+    } else {
+      SchemeData::Flux type = interface_flux == MultiPhaseData::LOCAL_LAX_FRIEDRICHS ?
+                              SchemeData::LOCAL_LAX_FRIEDRICHS : flux;
+      ComputeNumericalFlux(type, vf_[idl], &b.Vm[5*k], vsm, &Fm[5*f]);
+      ComputeNumericalFlux(type, vf_[idr], vsp, &b.Vp[5*k], &Fp[5*f]);
+    }
+  }
+
+  // max. wave speed (for the time step)
+  double smax = 0.0;
+  for(int i=f0; i<std::min(f1,Nx); i++) {
+    double *v = &V[5*i];
+    double e = vf_[id[i]]->GetInternalEnergyPerUnitMass(v[0], v[4]);
+    double c2 = vf_[id[i]]->ComputeSoundSpeedSquare(v[0], e);
+    smax = std::max(smax, fabs(v[1]) + sqrt(std::max(c2, 0.0)));
+  }
+
+  return smax;
+}
+
+//-----------------------------------------------------
+
+int
+GodunovSolver1D::UpdateCells(int i0, int i1, double dt, std::vector<VarFcnBase*> &vf_)
+{
+  double U[5];
+  double a = dt/dx;
+  for(int i=i0; i<i1; i++) {
+    double *v = &V[5*i];
+    VarFcnBase *vfi = vf_[id[i]];
+    vfi->PrimitiveToConservative(v, U);
+    for(int j=0; j<5; j++)
+      U[j] -= a*(Fm[5*(i+1)+j] - Fp[5*i+j]);
+    if(!(U[0]>0.0)) {
+      v[0] = U[0];
+      return i;
+    }
+    vfi->ConservativeToPrimitive(U, v);
+    vfi->ClipDensityAndPressure(v);
+    if(vfi->CheckState(v[0], v[4], true))
+      return i;
+  }
+  return -1;
+}
+
+//-----------------------------------------------------
+
+void
+GodunovSolver1D::MoveInterfaces(double dt)
+{
+  // when an interface passes a cell center, the cell takes the star state of the other material
+  std::map<int, double> xi;
+  for(auto &I : interfaces) {
+    int f = I.face;
+    double xnew = I.x + dt*Vsm[5*f+1];
+    if(xnew > x[f]) {
+      id[f] = id[f-1];
+      for(int j=0; j<5; j++)
+        V[5*f+j] = Vsm[5*f+j];
+      f++;
+    } else if(xnew < x[f-1]) {
+      id[f-1] = id[f];
+      for(int j=0; j<5; j++)
+        V[5*(f-1)+j] = Vsp[5*f+j];
+      f--;
+    }
+    xi[f] = xnew;
+  }
+
+  // the interfaces that reached the boundary or merged with another one are removed
+  interfaces.clear();
+  for(int f=1; f<Nx; f++)
+    if(id[f-1] != id[f]) {
+      Interface I = {f, x0 + f*dx};
+      auto it = xi.find(f);
+      if(it != xi.end())
+        I.x = std::min(std::max(it->second, x[f-1]), x[f]);
+      interfaces.push_back(I);
+    }
+}
+
+//-----------------------------------------------------
+
+void
+GodunovSolver1D::ComputePhysicalFlux(VarFcnBase *vf_, double *V_, double *F)
+{
+  double E = V_[0]*(vf_->GetInternalEnergyPerUnitMass(V_[0], V_[4])
+                    + 0.5*(V_[1]*V_[1] + V_[2]*V_[2] + V_[3]*V_[3]));
+  double m = V_[0]*V_[1];
+  F[0] = m;
+  F[1] = m*V_[1] + V_[4];
+  F[2] = m*V_[2];
+  F[3] = m*V_[3];
+  F[4] = (E + V_[4])*V_[1];
+}
+
+//-----------------------------------------------------
+
+void
+GodunovSolver1D::ComputeNumericalFlux(SchemeData::Flux type, VarFcnBase *vf_, double *Vl, double *Vr,
+                                      double *F)
+{
+  double Ul[5], Ur[5], Fl[5], Fr[5];
+  vf_->PrimitiveToConservative(Vl, Ul);
+  vf_->PrimitiveToConservative(Vr, Ur);
+  ComputePhysicalFlux(vf_, Vl, Fl);
+  ComputePhysicalFlux(vf_, Vr, Fr);
+
+  double el = (Ul[4] - 0.5*Vl[0]*(Vl[1]*Vl[1] + Vl[2]*Vl[2] + Vl[3]*Vl[3]))/Vl[0];
+  double er = (Ur[4] - 0.5*Vr[0]*(Vr[1]*Vr[1] + Vr[2]*Vr[2] + Vr[3]*Vr[3]))/Vr[0];
+  double cl = sqrt(std::max(vf_->ComputeSoundSpeedSquare(Vl[0], el), 0.0));
+  double cr = sqrt(std::max(vf_->ComputeSoundSpeedSquare(Vr[0], er), 0.0));
+
+  if(type == SchemeData::LOCAL_LAX_FRIEDRICHS) {
+    double a = std::max(fabs(Vl[1]) + cl, fabs(Vr[1]) + cr);
+    for(int j=0; j<5; j++)
+      F[j] = 0.5*(Fl[j] + Fr[j]) - 0.5*a*(Ur[j] - Ul[j]);
+    return;
+  }
+
+  // HLLC (Toro, Section 10.4), with the wave speed estimates of Davis
+  double Sl = std::min(Vl[1] - cl, Vr[1] - cr);
+  double Sr = std::max(Vl[1] + cl, Vr[1] + cr);
+  if(Sl >= 0.0) {
+    for(int j=0; j<5; j++)
+      F[j] = Fl[j];
+    return;
+  }
+  if(Sr <= 0.0) {
+    for(int j=0; j<5; j++)
+      F[j] = Fr[j];
+    return;
+  }
+
+  double ml = Vl[0]*(Sl - Vl[1]), mr = Vr[0]*(Sr - Vr[1]);
+  double Ss = (Vr[4] - Vl[4] + ml*Vl[1] - mr*Vr[1])/(ml - mr);
+
+  bool left = Ss >= 0.0;
+  double S = left ? Sl : Sr, *Vk = left ? Vl : Vr, *Uk = left ? Ul : Ur, *Fk = left ? Fl : Fr;
+  double coeff = Vk[0]*(S - Vk[1])/(S - Ss);
+  double Us[5] = {coeff, coeff*Ss, coeff*Vk[2], coeff*Vk[3],
+                  coeff*(Uk[4]/Vk[0] + (Ss - Vk[1])*(Ss + Vk[4]/(Vk[0]*(S - Vk[1]))))};
+  for(int j=0; j<5; j++)
+    F[j] = Fk[j] + S*(Us[j] - Uk[j]);
+}
+
+//-----------------------------------------------------
+
+int
+GodunovSolver1D::WriteSnapshot(int k, int time_step, double t)
+{
+  std::string filename = std::string(iod.output.prefix) + iod.output.solution_filename_base + "_"
+                       + std::to_string(k) + ".bin";
+  FILE *file = fopen(filename.c_str(), "wb");
+  if(!file) {
+    print_error("*** Error: Cannot open file %s for output.\n", filename.c_str());
+    return 1;
+  }
+
+  fwrite(&Nx, sizeof(int), 1, file);
+  fwrite(&time_step, sizeof(int), 1, file);
+  fwrite(&t, sizeof(double), 1, file);
+  fwrite(x.data(), sizeof(double), Nx, file);
+  fwrite(id.data(), sizeof(int), Nx, file);
+  fwrite(V.data(), sizeof(double), 5*Nx, file);
+  fclose(file);
+
+  if(verbose>=1)
+    print("- Wrote snapshot %s (time step %d, t = %e).\n", filename.c_str(), time_step, t);
+  return 0;
+}
+
+//-----------------------------------------------------
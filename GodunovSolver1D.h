@@ -0,0 +1,119 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _GODUNOV_SOLVER_1D_H_
+#define _GODUNOV_SOLVER_1D_H_
+
+#include <ExactRiemannSolverBatch.h>
+#include <vector>
+
+/*****************************************************************************************
+ * Class GodunovSolver1D solves the 1D (multi-material) Euler equations on a uniform mesh
+ * (Mesh: X0, Xmax, NumberOfCellsX), using a first-order finite volume method and forward Euler time integration.
+ * It is activated by specifying NumberOfCellsX in the input file, and is meant as a validation tool for the
+ * Riemann solver (the solution can be compared with RiemannSolution.txt) and as a benchmark.
+ *
+ * - Initial condition: DefaultInitialState, overridden by the planes in GeometricEntities (on the side
+ *   of each plane pointed to by its normal).
+ * - Boundary conditions (Mesh.BoundaryConditionX0/Xmax): Inlet (Farfield0) and Outlet (Farfield1)
+ *   impose the states in BoundaryConditions, walls and symmetry impose reflection, and None is a
+ *   transmissive (zero-gradient) boundary. The boundary states share the material of the adjacent cell.
+ * - Faces inside a material: Space.NavierStokes.Flux = LocalLaxFriedrichs, HLLC, or Godunov (exact
+ *   Riemann solver). (Roe is replaced by HLLC.)
+ * - Faces between different materials: the exact (two-material) Riemann problem is solved. With
+ *   MultiPhase.Flux = Exact (or Space.NavierStokes.Flux = Godunov), each side receives the exact flux of
+ *   its own material at the face, i.e. the flux of the solution at x/t = 0 if it belongs to this material,
+ *   otherwise the flux of its star state (ghost fluid). With MultiPhase.Flux = Numerical (LocalLaxFriedrichs),
+ *   the numerical (LLF) flux between the cell state and its star state is used instead.
+ *   The interfaces are tracked as points moving with the star velocity.
+ *   When an interface passes a cell center, the cell changes material and takes the star state
+ *   of the new material (MultiPhase.PhaseChange = RiemannSolution).
+ *
+ * In each time step, all the faces that need the exact Riemann solver are solved together, in a
+ * batch (ExactRiemannSolverBatch) per thread. The faces and cells are divided among the threads
+ * (Time.NumThreads). Each thread has its own Riemann solver and VarFcn objects.
+ *
+ * Output: Binary snapshots <Output.Prefix><Output.Solution>_<k>.bin, k = 0, 1, ..., written at the
+ * beginning, at the end, and every Output.Frequency steps (or every Output.TimeInterval, if specified).
+ * Each snapshot contains (native byte order)
+ *   int32 Nx, int32 time step, float64 time, float64 x[Nx], int32 materialid[Nx], float64 V[5*Nx]
+ * where V stores the primitive state (rho, vx, vy, vz, p) of each cell consecutively.
+ *****************************************************************************************/
+
+class GodunovSolver1D {
+
+  //! a material interface located between the centers of the two cells of "face"
+  struct Interface {
+    int face;
+    double x;
+  };
+
+  //! the exact Riemann problems of one thread (reused in all time steps)
+  struct Batch {
+    std::vector<int> face;
+    std::vector<double> dir, Vm, Vp, Vs, Vsm, Vsp;
+    std::vector<int> idm, idp, id;
+  };
+
+  std::vector<VarFcnBase*> &vf; //!< used by the first thread
+  IoData &iod;
+
+  EOSAdmissibilityEnvelope *envelope; //!< can be NULL
+  StarPressureAtlas *atlas; //!< can be NULL
+
+  int verbose;
+
+  SchemeData::Flux flux; //!< faces inside a material
+  MultiPhaseData::Flux interface_flux; //!< faces between materials
+
+  int Nx;
+  double x0, dx;
+  std::vector<double> x; //!< cell centers
+
+  std::vector<double> V; //!< primitive state of the cells (5*Nx)
+  std::vector<int> id; //!< material id of the cells
+
+  std::vector<double> Fm, Fp; //!< flux at each face (5*(Nx+1)), into the left and the right cell
+  std::vector<double> Vsm, Vsp; //!< star states at the faces between materials (5*(Nx+1))
+
+  std::vector<Interface> interfaces;
+
+  //! statistics
+  long num_exact, num_failed, num_faces;
+
+public:
+
+  GodunovSolver1D(std::vector<VarFcnBase*> &vf_, IoData &iod_, EOSAdmissibilityEnvelope *envelope_,
+                  StarPressureAtlas *atlas_, int verbose_);
+  ~GodunovSolver1D() {}
+
+  //! returns 0 if successful
+  int Run();
+
+private:
+
+  int SetupMeshAndInitialCondition();
+
+  //! boundary (ghost) state of face f (0 or Nx)
+  void GetBoundaryState(int f, double *Vg);
+
+  //! computes the fluxes at faces [f0, f1), and returns the max. wave speed in cells [f0, min(f1,Nx))
+  double ComputeFluxes(int f0, int f1, std::vector<VarFcnBase*> &vf_, ExactRiemannSolverBatch &batch,
+                       Batch &b, long &nexact, long &nfailed);
+
+  //! returns the index of the first invalid cell in [i0, i1), or -1
+  int UpdateCells(int i0, int i1, double dt, std::vector<VarFcnBase*> &vf_);
+
+  void MoveInterfaces(double dt);
+
+  void ComputeNumericalFlux(SchemeData::Flux type, VarFcnBase *vf_, double *Vl, double *Vr, double *F);
+
+  void ComputePhysicalFlux(VarFcnBase *vf_, double *V_, double *F);
+
+  int WriteSnapshot(int k, int time_step, double t);
+
+};
+
+#endif
@@ -985,6 +985,48 @@ void ANEOSBirchMurnaghanDebyeModelData::setup(const char *name, ClassAssigner *f
 
 //------------------------------------------------------------------------------
 
+TabulationModelData::TabulationModelData()
+{
+  type = NONE;
+  rho_min = 0.0;
+  rho_max = 0.0;
+  e_min = 0.0;
+  e_max = 0.0;
+  Nrho = 200;
+  Ne = 200;
+  temperature = NO;
+  out_of_range = FALLBACK;
+}
+
+//------------------------------------------------------------------------------
+
+void TabulationModelData::setup(const char *name, ClassAssigner *father)
+{
+
+  ClassAssigner *ca = new ClassAssigner(name, 9, father);
+
+  new ClassToken<TabulationModelData> (ca, "Type", this,
+        reinterpret_cast<int TabulationModelData::*>(&TabulationModelData::type), 2,
+        "None", 0, "Bicubic", 1);
+
+  new ClassDouble<TabulationModelData>(ca, "DensityMin", this, &TabulationModelData::rho_min);
+  new ClassDouble<TabulationModelData>(ca, "DensityMax", this, &TabulationModelData::rho_max);
+  new ClassDouble<TabulationModelData>(ca, "InternalEnergyPerUnitMassMin", this, &TabulationModelData::e_min);
+  new ClassDouble<TabulationModelData>(ca, "InternalEnergyPerUnitMassMax", this, &TabulationModelData::e_max);
+  new ClassInt<TabulationModelData>(ca, "NumberOfPointsDensity", this, &TabulationModelData::Nrho);
+  new ClassInt<TabulationModelData>(ca, "NumberOfPointsInternalEnergy", this, &TabulationModelData::Ne);
+
+  new ClassToken<TabulationModelData> (ca, "Temperature", this,
+        reinterpret_cast<int TabulationModelData::*>(&TabulationModelData::temperature), 2,
+        "No", 0, "Yes", 1);
+
+  new ClassToken<TabulationModelData> (ca, "OutOfRange", this,
+        reinterpret_cast<int TabulationModelData::*>(&TabulationModelData::out_of_range), 2,
+        "Fallback", 0, "Clip", 1);
+}
+
+//------------------------------------------------------------------------------
+
 HyperelasticityModelData::HyperelasticityModelData()
 {
   type = NONE;
@@ -1032,7 +1074,7 @@ MaterialModelData::MaterialModelData()
 Assigner *MaterialModelData::getAssigner()
 {
 
-  ClassAssigner *ca = new ClassAssigner("normal", 16, nullAssigner);
+  ClassAssigner *ca = new ClassAssigner("normal", 17, nullAssigner);
 
   new ClassToken<MaterialModelData>(ca, "EquationOfState", this,
                                  reinterpret_cast<int MaterialModelData::*>(&MaterialModelData::eos), 7,
@@ -1058,6 +1100,8 @@ Assigner *MaterialModelData::getAssigner()
   jwlModel.setup("JonesWilkinsLeeModel", ca);
   abmdModel.setup("ANEOSBirchMurnaghanDebyeModel", ca);
 
+  tabulation.setup("TabulationModel", ca);
+
   viscosity.setup("ViscosityModel", ca);
   
   heat_diffusion.setup("HeatDiffusionModel", ca);
@@ -1546,6 +1590,96 @@ void SchemesData::setup(const char *name, ClassAssigner *father)
 
 //------------------------------------------------------------------------------
 
+StarPressureAtlasPairData::StarPressureAtlasPairData()
+{
+  materialid_left = materialid_right = 0;
+  density_left = density_right = 1.0;
+  pressure = 1.0;
+}
+
+//------------------------------------------------------------------------------
+
+Assigner *StarPressureAtlasPairData::getAssigner()
+{
+  ClassAssigner *ca = new ClassAssigner("normal", 5, nullAssigner);
+
+  new ClassInt<StarPressureAtlasPairData>(ca, "MaterialIDLeft", this, 
+                                          &StarPressureAtlasPairData::materialid_left);
+  new ClassInt<StarPressureAtlasPairData>(ca, "MaterialIDRight", this, 
+                                          &StarPressureAtlasPairData::materialid_right);
+  new ClassDouble<StarPressureAtlasPairData>(ca, "ReferenceDensityLeft", this,
+                                             &StarPressureAtlasPairData::density_left);
+  new ClassDouble<StarPressureAtlasPairData>(ca, "ReferenceDensityRight", this,
+                                             &StarPressureAtlasPairData::density_right);
+  new ClassDouble<StarPressureAtlasPairData>(ca, "ReferencePressure", this,
+                                             &StarPressureAtlasPairData::pressure);
+  return ca;
+}
+
+//------------------------------------------------------------------------------
+
+StarPressureAtlasData::StarPressureAtlasData()
+{
+  filename = "";
+  pressure_ratio_max = 1.0e3;
+  density_ratio_max = 1.0e2;
+  velocity_jump_max = 2.0;
+  Np = 13;
+  Nrho = 9;
+  Nu = 17;
+}
+
+//------------------------------------------------------------------------------
+
+void StarPressureAtlasData::setup(const char *name, ClassAssigner *father)
+{
+  ClassAssigner *ca = new ClassAssigner(name, 8, father);
+
+  new ClassStr<StarPressureAtlasData>(ca, "File", this, &StarPressureAtlasData::filename);
+
+  new ClassDouble<StarPressureAtlasData>(ca, "MaxPressureRatio", this,
+                                         &StarPressureAtlasData::pressure_ratio_max);
+  new ClassDouble<StarPressureAtlasData>(ca, "MaxDensityRatio", this,
+                                         &StarPressureAtlasData::density_ratio_max);
+  new ClassDouble<StarPressureAtlasData>(ca, "MaxVelocityJump", this,
+                                         &StarPressureAtlasData::velocity_jump_max);
+
+  new ClassInt<StarPressureAtlasData>(ca, "NumberOfPointsPressureRatio", this, &StarPressureAtlasData::Np);
+  new ClassInt<StarPressureAtlasData>(ca, "NumberOfPointsDensityRatio", this, &StarPressureAtlasData::Nrho);
+  new ClassInt<StarPressureAtlasData>(ca, "NumberOfPointsVelocityJump", this, &StarPressureAtlasData::Nu);
+
+  pairMap.setup("MaterialPair", ca);
+}
+
+//------------------------------------------------------------------------------
+
+AdmissibilityEnvelopeData::AdmissibilityEnvelopeData()
+{
+  enabled = NO;
+  density_min = 1.0e-6;
+  density_max = 1.0e5;
+  N = 221;
+}
+
+//------------------------------------------------------------------------------
+
+void AdmissibilityEnvelopeData::setup(const char *name, ClassAssigner *father)
+{
+  ClassAssigner *ca = new ClassAssigner(name, 4, father);
+
+  new ClassToken<AdmissibilityEnvelopeData>(ca, "Enabled", this,
+                                            reinterpret_cast<int AdmissibilityEnvelopeData::*>
+                                            (&AdmissibilityEnvelopeData::enabled), 2,
+                                            "No", 0, "Yes", 1);
+
+  new ClassDouble<AdmissibilityEnvelopeData>(ca, "MinDensity", this, &AdmissibilityEnvelopeData::density_min);
+  new ClassDouble<AdmissibilityEnvelopeData>(ca, "MaxDensity", this, &AdmissibilityEnvelopeData::density_max);
+
+  new ClassInt<AdmissibilityEnvelopeData>(ca, "NumberOfPoints", this, &AdmissibilityEnvelopeData::N);
+}
+
+//------------------------------------------------------------------------------
+
 ExactRiemannSolverData::ExactRiemannSolverData()
 {
   maxIts_main = 200;
@@ -1558,6 +1692,8 @@ ExactRiemannSolverData::ExactRiemannSolverData()
   min_pressure = -1.0e8;
   failure_threshold = 0.2;
   pressure_at_failure = 1.0e-8;
+  acoustic_threshold = 0.0;
+  bracketing_candidates = 0;
 
   // Experimental
   surface_tension = NO;
@@ -1570,7 +1706,7 @@ ExactRiemannSolverData::ExactRiemannSolverData()
 void ExactRiemannSolverData::setup(const char *name, ClassAssigner *father)
 {
 
-  ClassAssigner *ca = new ClassAssigner(name, 13, father);
+  ClassAssigner *ca = new ClassAssigner(name, 17, father);
 
   new ClassInt<ExactRiemannSolverData>(ca, "MaxIts", this, 
                                        &ExactRiemannSolverData::maxIts_main);
@@ -1602,6 +1738,16 @@ void ExactRiemannSolverData::setup(const char *name, ClassAssigner *father)
   new ClassDouble<ExactRiemannSolverData>(ca, "PrescribedPressureUponFailure", this,
                                           &ExactRiemannSolverData::pressure_at_failure);
 
+  new ClassDouble<ExactRiemannSolverData>(ca, "AcousticThreshold", this,
+                                          &ExactRiemannSolverData::acoustic_threshold);
+
+  new ClassInt<ExactRiemannSolverData>(ca, "BracketingCandidates", this,
+                                       &ExactRiemannSolverData::bracketing_candidates);
+
+  atlas.setup("StarPressureAtlas", ca);
+
+  envelope.setup("AdmissibilityEnvelope", ca);
+
   // Experimental 
   
   new ClassToken<ExactRiemannSolverData>(ca, "SurfaceTension", this,
@@ -1618,6 +1764,61 @@ void ExactRiemannSolverData::setup(const char *name, ClassAssigner *father)
 
 //------------------------------------------------------------------------------
 
+RiemannCaseData::RiemannCaseData()
+{
+  name = "";
+  normal_x = 1.0;
+  normal_y = 0.0;
+  normal_z = 0.0;
+  one_sided = NO;
+}
+
+//------------------------------------------------------------------------------
+
+Assigner *RiemannCaseData::getAssigner()
+{
+  ClassAssigner *ca = new ClassAssigner("normal", 7, nullAssigner);
+
+  new ClassStr<RiemannCaseData>(ca, "Name", this, &RiemannCaseData::name);
+
+  left.setup("LeftState", ca);
+  right.setup("RightState", ca);
+
+  new ClassDouble<RiemannCaseData>(ca, "NormalX", this, &RiemannCaseData::normal_x);
+  new ClassDouble<RiemannCaseData>(ca, "NormalY", this, &RiemannCaseData::normal_y);
+  new ClassDouble<RiemannCaseData>(ca, "NormalZ", this, &RiemannCaseData::normal_z);
+
+  new ClassToken<RiemannCaseData> (ca, "OneSided", this,
+     reinterpret_cast<int RiemannCaseData::*>(&RiemannCaseData::one_sided), 2,
+     "No", 0, "Yes", 1);
+
+  return ca;
+}
+
+//------------------------------------------------------------------------------
+
+RiemannCasesData::RiemannCasesData()
+{
+  result_file = "RiemannCases.txt";
+  solution_prefix = "";
+  num_threads = 0;
+}
+
+//------------------------------------------------------------------------------
+
+void RiemannCasesData::setup(const char *name, ClassAssigner *father)
+{
+  ClassAssigner *ca = new ClassAssigner(name, 4, father);
+
+  caseMap.setup("Case", ca);
+
+  new ClassStr<RiemannCasesData>(ca, "ResultFile", this, &RiemannCasesData::result_file);
+  new ClassStr<RiemannCasesData>(ca, "SolutionFilePrefix", this, &RiemannCasesData::solution_prefix);
+  new ClassInt<RiemannCasesData>(ca, "NumberOfThreads", this, &RiemannCasesData::num_threads);
+}
+
+//------------------------------------------------------------------------------
+
 MultiPhaseData::MultiPhaseData()
 {
   flux = NUMERICAL;
@@ -1723,6 +1924,8 @@ TsData::TsData()
   convergence_tolerance = -1.0; //!< activated only for steady-state computations
   local_dt = NO;
 
+  num_threads = 0;
+
 }
 
 //------------------------------------------------------------------------------
@@ -1730,7 +1933,7 @@ TsData::TsData()
 void TsData::setup(const char *name, ClassAssigner *father)
 {
 
-  ClassAssigner *ca = new ClassAssigner(name, 8, father);
+  ClassAssigner *ca = new ClassAssigner(name, 9, father);
 
   new ClassToken<TsData>(ca, "Type", this,
                          reinterpret_cast<int TsData::*>(&TsData::type), 2,
@@ -1745,6 +1948,7 @@ void TsData::setup(const char *name, ClassAssigner *father)
                          reinterpret_cast<int TsData::*>(&TsData::local_dt), 2,
                          "Off", 0, "On", 1);
 
+  new ClassInt<TsData>(ca, "NumThreads", this, &TsData::num_threads);
 
   expl.setup("Explicit", ca);
 }
@@ -3469,13 +3673,15 @@ EOSTabulationData::EOSTabulationData()
   yvar = SPECIFIC_INTERNAL_ENERGY;
   x0 = xmax = y0 = ymax = 1.0;
   Nx = Ny = 100;
+  num_threads = 0;
+  restart = NO;
 }
 
 //------------------------------------------------------------------------------
 
 Assigner *EOSTabulationData::getAssigner()
 {
-  ClassAssigner *ca = new ClassAssigner("normal", 11, nullAssigner);
+  ClassAssigner *ca = new ClassAssigner("normal", 13, nullAssigner);
 
   new ClassInt<EOSTabulationData>(ca, "MaterialID", this, &EOSTabulationData::materialid);
 
@@ -3511,74 +3717,62 @@ Assigner *EOSTabulationData::getAssigner()
   new ClassInt<EOSTabulationData>(ca, "NumberOfPointsX", this, &EOSTabulationData::Nx);
   new ClassInt<EOSTabulationData>(ca, "NumberOfPointsY", this, &EOSTabulationData::Ny);
 
+  new ClassInt<EOSTabulationData>(ca, "NumberOfThreads", this, &EOSTabulationData::num_threads);
+
+  new ClassToken<EOSTabulationData> (ca, "Restart", this,
+          reinterpret_cast<int EOSTabulationData::*>(&EOSTabulationData::restart), 2,
+          "No", 0, "Yes", 1);
+
   return ca;
 }
 
 //------------------------------------------------------------------------------
 
-SpecialToolsData::SpecialToolsData()
+RiemannSolverServiceData::RiemannSolverServiceData()
 {
-  type = NONE;
+  source = STANDARD_INPUT;
+  socket = "";
+  format = TEXT;
 }
 
 //------------------------------------------------------------------------------
 
-void SpecialToolsData::setup(const char *name, ClassAssigner *father)
+void RiemannSolverServiceData::setup(const char *name, ClassAssigner *father)
 {
   ClassAssigner *ca = new ClassAssigner(name, 3, father);
 
-  new ClassToken<SpecialToolsData> (ca, "Type", this,
-     reinterpret_cast<int SpecialToolsData::*>(&SpecialToolsData::type), 3,
-     "None", 0, "DynamicLoadCalculation", 1, "EquationOfStateTabulation", 2);
-
-  transient_input.setup("TransientInputData");
-  eos_tabulationMap.setup("EquationOfStateTable", ca);
-} 
+  new ClassToken<RiemannSolverServiceData> (ca, "Source", this,
+     reinterpret_cast<int RiemannSolverServiceData::*>(&RiemannSolverServiceData::source), 2,
+     "StandardInput", 0, "UnixSocket", 1);
 
-//------------------------------------------------------------------------------
+  new ClassStr<RiemannSolverServiceData>(ca, "Socket", this, &RiemannSolverServiceData::socket);
 
-IoData::IoData(int argc, char** argv)
-{
-  //Should NOT call functions in Utils (e.g., print(), exit_mpi()) because the
-  //M2C communicator may have not been properly set up.
-  readCmdLine(argc, argv);
-  readCmdFile();
+  new ClassToken<RiemannSolverServiceData> (ca, "Format", this,
+     reinterpret_cast<int RiemannSolverServiceData::*>(&RiemannSolverServiceData::format), 2,
+     "Text", 0, "Binary", 1);
 }
 
 //------------------------------------------------------------------------------
 
-void IoData::readCmdLine(int argc, char** argv)
+SpecialToolsData::SpecialToolsData()
 {
-  if(argc==1) {
-    fprintf(stdout,"\033[0;31m*** Error: Input file not provided!\n\033[0m");
-    exit(-1);
-  }
-  cmdFileName = argv[1];
+  type = NONE;
 }
 
 //------------------------------------------------------------------------------
 
-void IoData::readCmdFile()
+void SpecialToolsData::setup(const char *name, ClassAssigner *father)
 {
-  extern FILE *yyCmdfin;
-  extern int yyCmdfparse();
-
-  setupCmdFileVariables();
-//  cmdFilePtr = freopen(cmdFileName, "r", stdin);
-  yyCmdfin = cmdFilePtr = fopen(cmdFileName, "r");
+  ClassAssigner *ca = new ClassAssigner(name, 4, father);
 
-  if (!cmdFilePtr) {
-    fprintf(stdout,"\033[0;31m*** Error: could not open \'%s\'\n\033[0m", cmdFileName);
-    exit(-1);
-  }
+  new ClassToken<SpecialToolsData> (ca, "Type", this,
+     reinterpret_cast<int SpecialToolsData::*>(&SpecialToolsData::type), 4,
+     "None", 0, "DynamicLoadCalculation", 1, "EquationOfStateTabulation", 2, "RiemannSolverService", 3);
 
-  int error = yyCmdfparse();
-  if (error) {
-    fprintf(stdout,"\033[0;31m*** Error: command file contained parsing errors.\n\033[0m");
-    exit(error);
-  }
-  fclose(cmdFilePtr);
-}
+  transient_input.setup("TransientInputData");
+  eos_tabulationMap.setup("EquationOfStateTable", ca);
+  service.setup("RiemannSolverService", ca);
+} 
 
 //------------------------------------------------------------------------------
 // This function is supposed to be called after creating M2C communicator. So, 
@@ -3647,6 +3841,8 @@ void IoData::setupCmdFileVariables()
 
   exact_riemann.setup("ExactRiemannSolution");
 
+  riemann_cases.setup("RiemannProblems");
+
   laser.setup("Laser");
 
   ion.setup("Ionization");
@@ -470,6 +470,30 @@ struct ANEOSBirchMurnaghanDebyeModelData {
 
 //------------------------------------------------------------------------------
 
+struct TabulationModelData {
+
+  //! If type = BICUBIC, the EOS specified for this material is sampled on a uniform (rho,e) 
+  //! grid at the beginning of the simulation. The table (not the original EOS) is used afterwards.
+  enum Type {NONE = 0, BICUBIC = 1} type;
+
+  double rho_min, rho_max; //!< density range of the table
+  double e_min, e_max; //!< internal energy (per unit mass) range of the table
+  int Nrho, Ne; //!< number of grid points in each direction
+
+  enum Temperature {NO = 0, YES = 1} temperature; //!< whether T(rho,e) is also tabulated
+
+  //! outside the table, the original EOS is called (FALLBACK) or the state is clipped (CLIP)
+  enum OutOfRange {FALLBACK = 0, CLIP = 1} out_of_range;
+
+  TabulationModelData();
+  ~TabulationModelData() {}
+
+  void setup(const char *, ClassAssigner * = 0);
+
+};
+
+//------------------------------------------------------------------------------
+
 struct ViscosityModelData {
 
   enum Type {NONE = 0, CONSTANT = 1, SUTHERLAND = 2, ARTIFICIAL_RODIONOV = 3} type;
@@ -551,6 +575,8 @@ struct MaterialModelData {
   JonesWilkinsLeeModelData          jwlModel;
   ANEOSBirchMurnaghanDebyeModelData abmdModel;
 
+  TabulationModelData tabulation;
+
   ViscosityModelData viscosity;
 
   HeatDiffusionModelData heat_diffusion;
@@ -798,6 +824,63 @@ struct SchemesData {
 
 //------------------------------------------------------------------------------
 
+struct StarPressureAtlasPairData {
+
+  int materialid_left, materialid_right;
+
+  //! reference state: left (density_left, pressure), right (density_right). The ratios in the atlas
+  //! are relative to this state
+  double density_left, density_right;
+  double pressure;
+
+  StarPressureAtlasPairData();
+  ~StarPressureAtlasPairData() {}
+
+  Assigner *getAssigner();
+};
+
+//------------------------------------------------------------------------------
+
+struct StarPressureAtlasData {
+
+  //! if specified, the atlas is read from this file if it exists and matches the settings below.
+  //! Otherwise, it is built at startup and written to this file
+  const char *filename;
+
+  //! the star pressure is tabulated as a function of log10(pr/pl) in [-log10(pressure_ratio_max),
+  //! log10(pressure_ratio_max)], the normalized density ratio log10((rhor/rhor_ref)/(rhol/rhol_ref)) 
+  //! in [-log10(density_ratio_max), log10(density_ratio_max)], and (ul-ur)/(cl+cr) in
+  //! [-velocity_jump_max, velocity_jump_max]
+  double pressure_ratio_max, density_ratio_max, velocity_jump_max;
+  int Np, Nrho, Nu; //!< number of grid points in each direction
+
+  ObjectMap<StarPressureAtlasPairData> pairMap;
+
+  StarPressureAtlasData();
+  ~StarPressureAtlasData() {}
+
+  void setup(const char *, ClassAssigner * = 0);
+};
+
+//------------------------------------------------------------------------------
+
+struct AdmissibilityEnvelopeData {
+
+  enum YesNo {NO = 0, YES = 1} enabled; //!< if YES, the envelope is built at startup (for all materials)
+
+  //! the minimum admissible pressure is tabulated as a function of log10(rho) in [density_min, density_max].
+  //! (density_min should be below the densities reached in rarefactions.)
+  double density_min, density_max;
+  int N; //!< number of grid points
+
+  AdmissibilityEnvelopeData();
+  ~AdmissibilityEnvelopeData() {}
+
+  void setup(const char *, ClassAssigner * = 0);
+};
+
+//------------------------------------------------------------------------------
+
 struct ExactRiemannSolverData {
 
   int maxIts_main;
@@ -816,6 +899,16 @@ struct ExactRiemannSolverData {
                               //!< find a bracketing interval and the best approximation obtained is poor.
                               //!< this is the last resort. Usually it can be set to a very low but physical pressure
 
+  double acoustic_threshold; //!< if |dp|/(rho*c^2) and |du|/c are below this value, the linearized (acoustic)
+                             //!< solution is used, with a second-order correction. (0: always solve exactly)
+
+  int bracketing_candidates; //!< if >= 2, the initial bracketing interval is found by evaluating the star relation at
+                             //!< this many (log-spaced) candidate pressures at once (0: serial search)
+
+  StarPressureAtlasData atlas; //!< tabulated initial guesses of the star pressure (optional)
+
+  AdmissibilityEnvelopeData envelope; //!< tabulated admissible region of each EOS, used to bound the search (optional)
+
 
   // ---------------------------------------------------------------------------------------------
   //! Experimental (Wentao): Extended Exact Riemann solver w/ pressure jump due to surface tension
@@ -834,6 +927,42 @@ struct ExactRiemannSolverData {
 
 //------------------------------------------------------------------------------
 
+struct RiemannCaseData {
+
+  const char *name; //!< used in the output (default: the index of the case)
+
+  StateVariable left, right; //!< density, velocity, pressure, and material id of the two states
+
+  double normal_x, normal_y, normal_z; //!< direction of the problem (from left to right; normalized)
+
+  enum YesNo {NO = 0, YES = 1} one_sided; //!< if YES, "right" only provides the wall/interface velocity
+
+  RiemannCaseData();
+  ~RiemannCaseData() {}
+
+  Assigner *getAssigner();
+};
+
+//------------------------------------------------------------------------------
+
+struct RiemannCasesData {
+
+  ObjectMap<RiemannCaseData> caseMap; //!< if not empty, these cases are solved (instead of bc.inlet/outlet)
+
+  const char *result_file; //!< one line per case (solution at x = 0 and star states)
+  const char *solution_prefix; //!< if specified, the solution of each case is written to <prefix><name>.txt
+                               //!< (same format as RiemannSolution.txt; requires PRINT_RIEMANN_SOLUTION)
+
+  int num_threads; //!< 0: use all the available hardware threads (always 1 with PRINT_RIEMANN_SOLUTION)
+
+  RiemannCasesData();
+  ~RiemannCasesData() {}
+
+  void setup(const char *, ClassAssigner * = 0);
+};
+
+//------------------------------------------------------------------------------
+
 struct MultiPhaseData {
 
   enum Flux {EXACT = 0, NUMERICAL = 1, LOCAL_LAX_FRIEDRICHS = 2} flux;
@@ -895,6 +1024,8 @@ struct TsData {
   double convergence_tolerance; //!< tolerance for residual.
   enum YesNo {NO = 0, YES = 1} local_dt; //!< each control volume applies its own time step size
 
+  int num_threads; //!< threads used by the 1D solver (GodunovSolver1D). 0: number of hardware threads
+
   ExplicitData expl;
 
   TsData();
@@ -1598,6 +1729,10 @@ struct EOSTabulationData {
   double x0, xmax, y0, ymax; //!< setting x0==xmax or y0==ymax will generate 1D data
   int Nx, Ny;
 
+  int num_threads; //!< 0: use all the available hardware threads
+
+  enum Restart {NO = 0, YES = 1} restart; //!< continue from an incomplete output file with the same header
+
   EOSTabulationData();
   ~EOSTabulationData() {}
 
@@ -1606,14 +1741,34 @@ struct EOSTabulationData {
 
 //------------------------------------------------------------------------------
 
+struct RiemannSolverServiceData {
+
+  //! requests are read from stdin (responses written to stdout), or from connections to a Unix-domain socket
+  enum Source {STANDARD_INPUT = 0, UNIX_SOCKET = 1} source;
+  const char *socket; //!< path of the socket (created by the service)
+
+  //! text: one request/response per line; binary: fixed-size records of doubles (native byte order)
+  enum Format {TEXT = 0, BINARY = 1} format;
+
+  RiemannSolverServiceData();
+  ~RiemannSolverServiceData() {}
+
+  void setup(const char *, ClassAssigner * = 0);
+};
+
+//------------------------------------------------------------------------------
+
 struct SpecialToolsData {
 
-  enum Type {NONE = 0, DYNAMIC_LOAD_CALCULATION = 1, EOS_TABULATION = 2, SIZE = 3} type;
+  enum Type {NONE = 0, DYNAMIC_LOAD_CALCULATION = 1, EOS_TABULATION = 2, RIEMANN_SOLVER_SERVICE = 3,
+             SIZE = 4} type;
   
   TransientInputData transient_input;
 
   ObjectMap<EOSTabulationData> eos_tabulationMap;
 
+  RiemannSolverServiceData service;
+
   SpecialToolsData();
   ~SpecialToolsData() {}
 
@@ -1643,6 +1798,8 @@ public:
 
   ExactRiemannSolverData exact_riemann;
 
+  RiemannCasesData riemann_cases;
+
   MultiPhaseData multiphase;
 
   LaserData laser;
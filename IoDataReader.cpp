@@ -0,0 +1,59 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <IoData.h>
+#include <cstdio>
+#include <cstdlib>
+
+//------------------------------------------------------------------------------
+// Reading the input file (uses the flex/bison parser in parser/). Kept apart from
+// IoData.cpp, so that the data structures can be used without the parser (e.g., by
+// the riemann_core library).
+//------------------------------------------------------------------------------
+
+IoData::IoData(int argc, char** argv)
+{
+  //Should NOT call functions in Utils (e.g., print(), exit_mpi()) because the
+  //M2C communicator may have not been properly set up.
+  readCmdLine(argc, argv);
+  readCmdFile();
+}
+
+//------------------------------------------------------------------------------
+
+void IoData::readCmdLine(int argc, char** argv)
+{
+  if(argc==1) {
+    fprintf(stdout,"\033[0;31m*** Error: Input file not provided!\n\033[0m");
+    exit(-1);
+  }
+  cmdFileName = argv[1];
+}
+
+//------------------------------------------------------------------------------
+
+void IoData::readCmdFile()
+{
+  extern FILE *yyCmdfin;
+  extern int yyCmdfparse();
+
+  setupCmdFileVariables();
+//  cmdFilePtr = freopen(cmdFileName, "r", stdin);
+  yyCmdfin = cmdFilePtr = fopen(cmdFileName, "r");
+
+  if (!cmdFilePtr) {
+    fprintf(stdout,"\033[0;31m*** Error: could not open \'%s\'\n\033[0m", cmdFileName);
+    exit(-1);
+  }
+
+  int error = yyCmdfparse();
+  if (error) {
+    fprintf(stdout,"\033[0;31m*** Error: command file contained parsing errors.\n\033[0m");
+    exit(error);
+  }
+  fclose(cmdFilePtr);
+}
+
+//------------------------------------------------------------------------------
@@ -6,18 +6,24 @@
 #include <time.h>
 #include <Utils.h>
 #include <IoData.h>
-#include <VarFcnSG.h>
-#include <VarFcnNASG.h>
-#include <VarFcnMG.h>
-#include <VarFcnMGExt.h>
-#include <VarFcnTillot.h>
-#include <VarFcnJWL.h>
-#include <VarFcnANEOSEx1.h>
-#include <VarFcnDummy.h>
+#include <VarFcnFactory.h>
 #include <ExactRiemannSolverBase.h>
+#include <StarPressureAtlas.h>
+#include <EOSAdmissibilityEnvelope.h>
+#include <RiemannSolverService.h>
+#include <RiemannCaseRunner.h>
+#include <GodunovSolver1D.h>
 #include <set>
+#include <cstring>
+#include <EOSTabulator.h>
+#include <thread>
 using std::cout;
 using std::endl;
+
+int RunEOSTabulation(IoData &iod);
+int Terminate(int err, std::vector<VarFcnBase*> &vf, EOSAdmissibilityEnvelope *envelope, StarPressureAtlas *atlas,
+              clock_t start_time);
+
 /*************************************
  * Main Function
  ************************************/
@@ -26,16 +32,21 @@ int main(int argc, char* argv[])
 {
   clock_t start_time = clock(); //for timing purpose only
 
+  //! Read user's input file
+  IoData iod(argc, argv);
+
+  //! Riemann solver service on stdin: stdout is reserved for the responses (the log goes to stderr)
+  int service_fd = -1;
+  if(iod.special_tools.type == SpecialToolsData::RIEMANN_SOLVER_SERVICE &&
+     iod.special_tools.service.source == RiemannSolverServiceData::STANDARD_INPUT)
+    service_fd = RiemannSolverService::ReserveStandardOutput();
+
   //! Initialize PETSc and MPI 
   print("\033[0;32m==========================================\033[0m\n");
   print("\033[0;32m                 START                    \033[0m\n"); 
   print("\033[0;32m==========================================\033[0m\n");
   print("\n");
 
-
-  //! Read user's input file
-  IoData iod(argc, argv);
-
   verbose = iod.output.verbose;
 
   //! Initialize VarFcn (EOS, etc.) 
@@ -50,29 +61,66 @@ int main(int argc, char* argv[])
       print_error("*** Error: Detected error in the specification of material indices (id = %d).\n", matid);
       exit_mpi();
     }
-    if(it->second->eos == MaterialModelData::STIFFENED_GAS)
-      vf[matid] = new VarFcnSG(*it->second);
-    else if(it->second->eos == MaterialModelData::NOBLE_ABEL_STIFFENED_GAS)
-      vf[matid] = new VarFcnNASG(*it->second);
-    else if(it->second->eos == MaterialModelData::MIE_GRUNEISEN)
-      vf[matid] = new VarFcnMG(*it->second);
-    else if(it->second->eos == MaterialModelData::EXTENDED_MIE_GRUNEISEN)
-      vf[matid] = new VarFcnMGExt(*it->second);
-    else if(it->second->eos == MaterialModelData::TILLOTSON)
-      vf[matid] = new VarFcnTillot(*it->second);
-    else if(it->second->eos == MaterialModelData::JWL)
-      vf[matid] = new VarFcnJWL(*it->second);
-    else if(it->second->eos == MaterialModelData::ANEOS_BIRCH_MURNAGHAN_DEBYE)
-      vf[matid] = new VarFcnANEOSEx1(*it->second);
-    else {
+    vf[matid] = CreateVarFcn(*it->second, verbose);
+    if(!vf[matid]) {
       print_error("*** Error: Unable to initialize variable functions (VarFcn) for the specified material model.\n");
       exit_mpi();
     }
+
+    if(it->second->tabulation.type == TabulationModelData::BICUBIC) {
+      print("- Tabulating the EOS of material %d.\n", matid);
+      vf[matid] = CreateTabulatedVarFcn(vf[matid], *it->second); //the original VarFcn is owned by the table
+    }
   }
 
 
+  //! Special tool: EOS tabulation (no Riemann problem is solved)
+  if(iod.special_tools.type == SpecialToolsData::EOS_TABULATION) {
+    int err = RunEOSTabulation(iod);
+    return Terminate(err, vf, NULL, NULL, start_time);
+  }
+
   ExactRiemannSolverBase riemann(vf, iod.exact_riemann);
-  
+  riemann.SetVerbosity(verbose);
+
+  //! Admissibility envelope of each EOS (bounds the pressure search of the exact Riemann solver)
+  EOSAdmissibilityEnvelope *envelope = NULL;
+  if(iod.exact_riemann.envelope.enabled == AdmissibilityEnvelopeData::YES) {
+    envelope = new EOSAdmissibilityEnvelope(vf, iod.exact_riemann.envelope);
+    envelope->Setup();
+    riemann.SetAdmissibilityEnvelope(envelope);
+  }
+
+  //! Star pressure atlas (initial guesses for the exact Riemann solver)
+  StarPressureAtlas *atlas = NULL;
+  if(strcmp(iod.exact_riemann.atlas.filename, "")) {
+    atlas = new StarPressureAtlas(vf, iod.exact_riemann.atlas);
+    if(atlas->Setup(riemann))
+      exit_mpi();
+    riemann.SetStarPressureAtlas(atlas);
+  }
+
+  //! Special tool: Riemann solver service (materials and solver are set up once for a stream of requests)
+  if(iod.special_tools.type == SpecialToolsData::RIEMANN_SOLVER_SERVICE) {
+    RiemannSolverService service(vf, riemann, iod.special_tools.service, service_fd);
+    int err = service.Run();
+    return Terminate(err, vf, envelope, atlas, start_time);
+  }
+
+  //! Multiple Riemann problems specified in the input file (solved in parallel)
+  if(!iod.riemann_cases.caseMap.dataMap.empty()) {
+    RiemannCaseRunner runner(vf, iod, envelope, atlas, verbose);
+    int err = runner.Run();
+    return Terminate(err, vf, envelope, atlas, start_time);
+  }
+
+  //! 1D (multi-material) flow problem on a mesh, solved by a Godunov-type finite volume method
+  if(iod.mesh.Nx>0) {
+    GodunovSolver1D solver(vf, iod, envelope, atlas, verbose);
+    int err = solver.Run();
+    return Terminate(err, vf, envelope, atlas, start_time);
+  }
+
   double Vm[5], Vp[5], V[5];
   int idm, idp;
   Vm[0] = iod.bc.inlet.density;
@@ -114,9 +162,17 @@ int main(int argc, char* argv[])
   if(idp>=0) {
     int err = riemann.ComputeRiemannSolution(dir, Vm, idm, Vp, idp, V, id, Vsm, Vsp);
 
-    if(err) {
+    if(err==2) {
+      print("Warning: The solution contains a vacuum.\n");
+    } else if(err==3) {
+      print("Warning: The solution contains a cavitated region (the pressure reaches the cut-off).\n");
+    } else if(err) {
       print("Warning: Riemann solver failed to find an initial bracketing interval or to converge. "
             "Providing an approximate solution.\n");
+    } else if(riemann.GetLastSolutionStage() != ExactRiemannSolverBase::ADAPTIVE) {
+      print("Warning: Adaptive Riemann solver failed. Solved by the non-adaptive version (%s).\n",
+            riemann.GetLastSolutionStage() == ExactRiemannSolverBase::NONADAPTIVE_WARM ?
+            "reusing the bracketing interval" : "from scratch");
     }
 
     print("\n");
@@ -124,6 +180,8 @@ int main(int argc, char* argv[])
     print("  V   = %e %e %e %e %e (id = %d).\n", V[0], V[1], V[2], V[3], V[4], id);
     print("  Vsm = %e %e %e %e %e.\n", Vsm[0], Vsm[1], Vsm[2], Vsm[3], Vsm[4]);
     print("  Vsp = %e %e %e %e %e.\n", Vsp[0], Vsp[1], Vsp[2], Vsp[3], Vsp[4]);
+    if(iod.exact_riemann.acoustic_threshold>0.0)
+      print("  Fraction solved by the linearized solver: %.2f%%.\n", 100.0*riemann.GetAcousticSolutionFraction());
   }
   else {
     double Ustar[3] = {Vp[1], Vp[2], Vp[3]};
@@ -140,6 +198,27 @@ int main(int argc, char* argv[])
     print("  Vsm = %e %e %e %e %e.\n", Vsm[0], Vsm[1], Vsm[2], Vsm[3], Vsm[4]);
   }
 
+  return Terminate(0, vf, envelope, atlas, start_time);
+}
+
+//--------------------------------------------------------------
+//! Frees the solver's data. If err is nonzero, terminates the process; otherwise prints the
+//! termination banner (and the total computation time) and returns 0
+
+int Terminate(int err, std::vector<VarFcnBase*> &vf, EOSAdmissibilityEnvelope *envelope, StarPressureAtlas *atlas,
+              clock_t start_time)
+{
+  if(atlas)
+    delete atlas;
+  if(envelope)
+    delete envelope;
+
+  for(int i=0; i<(int)vf.size(); i++)
+    delete vf[i];
+
+  if(err)
+    exit_mpi();
+
   print("\n");
   print("\033[0;32m==========================================\033[0m\n");
   print("\033[0;32m           NORMAL TERMINATION             \033[0m\n"); 
@@ -147,10 +226,43 @@ int main(int argc, char* argv[])
   print("Total Computation Time: %f sec.\n", ((double)(clock()-start_time))/CLOCKS_PER_SEC);
   print("\n");
 
-  for(int i=0; i<(int)vf.size(); i++)
-    delete vf[i];
-
   return 0;
 }
 
 //--------------------------------------------------------------
+
+int RunEOSTabulation(IoData &iod)
+{
+  int err = 0;
+  for(auto it = iod.special_tools.eos_tabulationMap.dataMap.begin();
+      it != iod.special_tools.eos_tabulationMap.dataMap.end(); it++) {
+
+    EOSTabulationData &tab(*it->second);
+    auto mat = iod.eqs.materials.dataMap.find(tab.materialid);
+    if(mat == iod.eqs.materials.dataMap.end()) {
+      print_error("*** Error: Cannot tabulate EOS for material %d (not defined).\n", tab.materialid);
+      err++;
+      continue;
+    }
+
+    // each thread gets its own VarFcn (some of them are not thread-safe)
+    int nThreads = tab.num_threads>0 ? tab.num_threads : std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<VarFcnBase*> vf_threads;
+    for(int t=0; t<nThreads; t++)
+      vf_threads.push_back(CreateVarFcn(*mat->second, verbose));
+    if(!vf_threads[0]) {
+      print_error("*** Error: Cannot tabulate EOS for material %d (EOS not supported).\n", tab.materialid);
+      err++;
+      continue;
+    }
+
+    EOSTabulator tabulator(vf_threads);
+    err += tabulator.Tabulate(tab);
+
+    for(auto &v : vf_threads)
+      delete v;
+  }
+  return err;
+}
+
+//--------------------------------------------------------------
@@ -0,0 +1,159 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#pragma once
+#include<cmath>
+#include<type_traits>
+
+namespace MathTools {
+
+// The dual-number type and its functions are in a nested namespace, so that the overloads of exp, log, etc.
+// (found by argument-dependent lookup) do not hide the standard ones in the rest of MathTools.
+namespace AutoDiff {
+
+/****************************************************************************
+ * Dual number for forward-mode automatic differentiation: x = v + sum_i d[i]*eps_i,
+ * with eps_i*eps_j = 0. A function evaluated with dual-number arguments returns its
+ * value and its derivatives w.r.t. the N independent variables (exact up to round-off),
+ * in one pass.
+ * Usage: write the formula as a template over the scalar type (e.g., p(rho,e)), and call it
+ *   with DualNumber<2> rho(rho0, 0), e(e0, 1);  ==> p.v = p(rho0,e0), p.d = {dp/drho, dp/de}.
+ * The value type T can itself be a dual number, which gives second derivatives: with
+ *   DualNumber<2,DualNumber<2> > rho(DualNumber<2>(rho0,0), 0), e(DualNumber<2>(e0,1), 1);
+ *   ==> p.v.v = p, p.d[i].v = dp/dx_i, and p.d[i].d[j] = d2p/(dx_i dx_j).
+ * Comparison operators only compare the values (v), so that branches in the formula
+ * (piecewise definitions) are taken in the same way as for double.
+ ***************************************************************************/
+template<int N, typename T = double>
+struct DualNumber {
+
+  typedef T value_type;
+
+  T v; //!< value
+  T d[N]; //!< derivatives
+
+  DualNumber() : v(0.0) {for(int i=0; i<N; i++) d[i] = 0.0;}
+  DualNumber(const T &v_) : v(v_) {for(int i=0; i<N; i++) d[i] = 0.0;}
+  //! a constant (e.g., a literal), if T is itself a dual number
+  template<typename S, typename = typename std::enable_if<std::is_arithmetic<S>::value &&
+                                                          !std::is_same<S,T>::value>::type>
+  DualNumber(S v_) : v(v_) {for(int i=0; i<N; i++) d[i] = 0.0;}
+  //! the i-th independent variable
+  DualNumber(const T &v_, int i) : v(v_) {for(int j=0; j<N; j++) d[j] = 0.0; d[i] = 1.0;}
+
+  inline DualNumber& operator+=(const DualNumber &y) {v += y.v; for(int i=0; i<N; i++) d[i] += y.d[i]; return *this;}
+  inline DualNumber& operator-=(const DualNumber &y) {v -= y.v; for(int i=0; i<N; i++) d[i] -= y.d[i]; return *this;}
+  inline DualNumber& operator*=(const DualNumber &y) {
+    for(int i=0; i<N; i++) d[i] = d[i]*y.v + v*y.d[i];
+    v *= y.v; return *this;}
+  inline DualNumber& operator/=(const DualNumber &y) {
+    T inv = 1.0/y.v;
+    v *= inv;
+    for(int i=0; i<N; i++) d[i] = (d[i] - v*y.d[i])*inv;
+    return *this;}
+
+  inline DualNumber& operator+=(double y) {v += y; return *this;}
+  inline DualNumber& operator-=(double y) {v -= y; return *this;}
+  inline DualNumber& operator*=(double y) {v *= y; for(int i=0; i<N; i++) d[i] *= y; return *this;}
+  inline DualNumber& operator/=(double y) {double inv = 1.0/y; return (*this) *= inv;}
+
+};
+
+//! f(x), given f(x.v) and f'(x.v) (chain rule). Extends any (elementary or special) function to dual numbers
+template<int N, typename T>
+inline DualNumber<N,T> chain_rule(const DualNumber<N,T> &x, const typename DualNumber<N,T>::value_type &f,
+                                  const typename DualNumber<N,T>::value_type &dfdx) {
+  DualNumber<N,T> y(f);
+  for(int i=0; i<N; i++) y.d[i] = dfdx*x.d[i];
+  return y;
+}
+
+//! value of a double or a dual number
+inline double real_part(double x) {return x;}
+template<int N, typename T>
+inline double real_part(const DualNumber<N,T> &x) {return real_part(x.v);}
+
+//----------------------------------------------------------------------------
+// Arithmetic operators
+//----------------------------------------------------------------------------
+template<int N, typename T>
+inline DualNumber<N,T> operator-(const DualNumber<N,T> &x) {DualNumber<N,T> y(x); y *= -1.0; return y;}
+
+template<int N, typename T>
+inline DualNumber<N,T> operator+(DualNumber<N,T> x, const DualNumber<N,T> &y) {return x += y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator+(DualNumber<N,T> x, double y) {return x += y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator+(double x, DualNumber<N,T> y) {return y += x;}
+
+template<int N, typename T>
+inline DualNumber<N,T> operator-(DualNumber<N,T> x, const DualNumber<N,T> &y) {return x -= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator-(DualNumber<N,T> x, double y) {return x -= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator-(double x, const DualNumber<N,T> &y) {DualNumber<N,T> z(-y); return z += x;}
+
+template<int N, typename T>
+inline DualNumber<N,T> operator*(DualNumber<N,T> x, const DualNumber<N,T> &y) {return x *= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator*(DualNumber<N,T> x, double y) {return x *= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator*(double x, DualNumber<N,T> y) {return y *= x;}
+
+template<int N, typename T>
+inline DualNumber<N,T> operator/(DualNumber<N,T> x, const DualNumber<N,T> &y) {return x /= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator/(DualNumber<N,T> x, double y) {return x /= y;}
+template<int N, typename T>
+inline DualNumber<N,T> operator/(double x, const DualNumber<N,T> &y) {
+  T inv = 1.0/y.v;
+  return chain_rule(y, x*inv, -x*inv*inv);
+}
+
+//----------------------------------------------------------------------------
+// Comparison operators (values only)
+//----------------------------------------------------------------------------
+#define DUAL_NUMBER_COMPARISON(OP) \
+  template<int N, typename T> inline bool operator OP(const DualNumber<N,T> &x, const DualNumber<N,T> &y) {return x.v OP y.v;} \
+  template<int N, typename T> inline bool operator OP(const DualNumber<N,T> &x, double y) {return x.v OP y;} \
+  template<int N, typename T> inline bool operator OP(double x, const DualNumber<N,T> &y) {return x OP y.v;}
+
+DUAL_NUMBER_COMPARISON(<)
+DUAL_NUMBER_COMPARISON(>)
+DUAL_NUMBER_COMPARISON(<=)
+DUAL_NUMBER_COMPARISON(>=)
+DUAL_NUMBER_COMPARISON(==)
+DUAL_NUMBER_COMPARISON(!=)
+
+#undef DUAL_NUMBER_COMPARISON
+
+//----------------------------------------------------------------------------
+// Elementary functions (found by argument-dependent lookup in templated code). The value is passed
+// to the standard function, or (if T is a dual number) to the overload below.
+//----------------------------------------------------------------------------
+template<int N, typename T>
+inline DualNumber<N,T> exp(const DualNumber<N,T> &x) {using std::exp; T f = exp(x.v); return chain_rule(x, f, f);}
+
+template<int N, typename T>
+inline DualNumber<N,T> log(const DualNumber<N,T> &x) {using std::log; return chain_rule(x, log(x.v), 1.0/x.v);}
+
+template<int N, typename T>
+inline DualNumber<N,T> sqrt(const DualNumber<N,T> &x) {using std::sqrt; T f = sqrt(x.v); return chain_rule(x, f, 0.5/f);}
+
+template<int N, typename T>
+inline DualNumber<N,T> pow(const DualNumber<N,T> &x, double a) {
+  using std::pow;
+  return chain_rule(x, pow(x.v, a), a*pow(x.v, a-1.0));}
+
+template<int N, typename T>
+inline DualNumber<N,T> fabs(const DualNumber<N,T> &x) {return x.v<0.0 ? -x : x;}
+
+} //end of namespace AutoDiff
+
+using AutoDiff::DualNumber;
+using AutoDiff::chain_rule;
+using AutoDiff::real_part;
+
+}
@@ -409,6 +409,326 @@ END_OF_LOOP_RKF45 :
 
 //------------------------------------------------------------------------
 
+/****************************************************************************
+ * Fixed-size versions of the Runge-Kutta solvers above. The size of U is a template
+ * parameter (e.g., MathTools::runge_kutta_4<1>(...)), and all the intermediate
+ * states are stored on the stack. No memory is allocated, so these can be called
+ * frequently (e.g., within the exact Riemann solver) with little overhead.
+ *
+ * Instead of storing the entire trajectory, the caller can pass in an "observer",
+ * which is called after each accepted step with the dense output of this step
+ * (RKDenseOutput), i.e. a cubic Hermite interpolant between the start and the end
+ * of the step. The observer can evaluate U at any t within the step, or simply
+ * copy the end state. The slopes F used for interpolation are already available,
+ * as F(U1,t1) is the first stage of the next step (FSAL).
+ *   - "observer" must be of type "void observer(const MathTools::RKDenseOutput<dim>&)"
+ ***************************************************************************/
+
+template<int dim>
+struct RKDenseOutput {
+
+  double t0, t1; //!< start and end of the step
+  double U0[dim], U1[dim]; //!< solution at t0 and t1
+  double F0[dim], F1[dim]; //!< F(U,t) at t0 and t1
+
+  //! Evaluates U(t) by cubic Hermite interpolation. t should be within [t0,t1] (or [t1,t0])
+  inline void Evaluate(double t, double *U) const {
+    double h = t1 - t0;
+    double theta = (h==0.0) ? 1.0 : (t - t0)/h;
+    double theta2 = theta*theta, theta3 = theta2*theta;
+    double h00 = 2.0*theta3 - 3.0*theta2 + 1.0, h01 = 1.0 - h00;
+    double h10 = (theta3 - 2.0*theta2 + theta)*h, h11 = (theta3 - theta2)*h;
+    for(int j=0; j<dim; j++)
+      U[j] = h00*U0[j] + h01*U1[j] + h10*F0[j] + h11*F1[j];
+  }
+
+};
+
+//! Default observer (does nothing)
+struct RKNoObserver {
+  template<int dim>
+  inline void operator()(const RKDenseOutput<dim> &) const {}
+};
+
+//------------------------------------------------------------------------
+
+template<int dim, typename Functor1, typename Functor2, typename Functor3 = RKNoObserver>
+int runge_kutta_4(Functor1 fun, double t0, double* U0, double dt, double tf,
+                  double* U, //U: computed solution at tf
+                  Functor2 check_state, //state checker (If not needed, set it to "[](double*){return false;}"
+                  Functor3 observer = Functor3(), //called after each step (optional)
+                  double* last_dt = NULL) // last time step (may not be dt!)
+{
+  static_assert(dim>0, "runge_kutta_4: dim must be positive.");
+
+  if(tf==t0) { //trivial
+    for(int j=0; j<dim; j++)
+      U[j] = U0[j];
+    if(last_dt) *last_dt = 0.0;
+    return 0;
+  }
+
+  if(dt==0.0)
+    return -1;
+
+  int N = floor((tf-t0)/dt);
+  if(!std::isfinite(N) || N<0)
+    return -1;
+
+  double t = t0;
+  for(int j=0; j<dim; j++) {
+    U[j] = U0[j];
+    if(!std::isfinite(U[j])) return -1;
+  }
+  if(check_state(U)) return -1;
+
+  RKDenseOutput<dim> step;
+  double Utmp[dim], k2[dim], k3[dim], k4[dim];
+  double *k1 = step.F0;
+
+  double one_sixth = 1.0/6.0;
+  double one_third = 1.0/3.0;
+
+  fun(U, t, step.F1); //becomes k1 of the first step
+
+  bool finished = false;
+  while(!finished) {
+    double half_dt = 0.5*dt;
+    for(int i=0; i<N; i++) {
+
+      step.t0 = t;
+      for(int j=0; j<dim; j++) {
+        step.U0[j] = U[j];
+        k1[j] = step.F1[j]; //F(U,t) has been computed at the end of the previous step
+      }
+
+      for(int j=0; j<dim; j++) {
+        Utmp[j] = U[j] + half_dt*k1[j];
+        if(!std::isfinite(Utmp[j]))
+          return 1;
+      }
+      if(check_state(Utmp))
+        return 1;
+      fun(Utmp, t+half_dt, k2);
+
+      for(int j=0; j<dim; j++) {
+        Utmp[j] = U[j] + half_dt*k2[j];
+        if(!std::isfinite(Utmp[j]))
+          return 1;
+      }
+      if(check_state(Utmp))
+        return 1;
+      fun(Utmp, t+half_dt, k3);
+
+      for(int j=0; j<dim; j++) {
+        Utmp[j] = U[j] + dt*k3[j];
+        if(!std::isfinite(Utmp[j]))
+          return 1;
+      }
+      if(check_state(Utmp))
+        return 1;
+      fun(Utmp, t+dt, k4);
+
+      for(int j=0; j<dim; j++) {
+        U[j] += dt*(one_sixth*(k1[j]+k4[j]) + one_third*(k2[j]+k3[j]));
+        if(!std::isfinite(U[j]))
+          return 1;
+      }
+      if(check_state(U))
+        return 1;
+
+      t += dt;
+
+      fun(U, t, step.F1);
+      step.t1 = t;
+      for(int j=0; j<dim; j++)
+        step.U1[j] = U[j];
+      observer(static_cast<const RKDenseOutput<dim>&>(step));
+    }
+
+    if((dt>=0 && t-tf>=-1e-9*dt) ||
+       (dt<0  && t-tf<=-1e-9*dt)) {
+      finished = true;
+      if(last_dt) *last_dt = dt;
+    } else { //run one more step.
+      N = 1;
+      dt = tf-t;
+    }
+  }
+
+  return 0;
+}
+
+//------------------------------------------------------------------------
+
+/****************************************************************************
+ * Fixed-size version of runge_kutta_45 (see above). Besides the observer, there are
+ * two differences from the general version: (1) k1 is not recomputed when a step is
+ * rejected, and (2) the step size is updated only once per step (the general version
+ * multiplies dt by "ratio" twice after an accepted step, which may overshoot tf).
+ ***************************************************************************/
+
+template<int dim, typename Functor1, typename Functor2, typename Functor3 = RKNoObserver>
+int runge_kutta_45(Functor1 fun, double t0, double* U0, double dt0, double tf,
+                   double* U, //U: computed solution at tf
+                   Functor2 check_state, //state checker (If not needed, set it to "[](double*){return false;}"
+                   double tol = 1.0e-8, int Nmax = 1e7, //Max. number of time steps
+                   Functor3 observer = Functor3()) //called after each accepted step (optional)
+{
+  static_assert(dim>0, "runge_kutta_45: dim must be positive.");
+
+  if(tf==t0) { //trivial
+    for(int j=0; j<dim; j++)
+      U[j] = U0[j];
+    return 0;
+  }
+
+  if(dt0==0.0 || tol<=0.0)
+    return -1;
+
+  int N = floor((tf-t0)/dt0);
+  if(!std::isfinite(N) || N<=0.0)
+    return -1;
+
+  // Coefficients
+  const double c2 = 0.2, c3 = 0.3, c4 = 0.6, c5 = 1.0, c6 = 0.875;
+  const double p2_1 = 0.2, p3_1 = 3.0/40.0, p3_2 = 9.0/40.0, p4_1 = 0.3, p4_2 = -0.9, p4_3 = 1.2;
+  const double p5_1 = -11.0/54.0, p5_2 = 2.5, p5_3 = -70.0/27.0, p5_4 = 35.0/27.0;
+  const double p6_1 = 1631.0/55296.0, p6_2 = 175.0/512.0, p6_3 = 575.0/13824.0, p6_4 = 44275.0/110592.0,
+               p6_5 = 253.0/4096.0;
+  const double o4_1 = 2825.0/27648.0, o4_3 = 18575.0/48384.0, o4_4 = 13525.0/55296.0, o4_5 = 277.0/14336.0,
+               o4_6 = 0.25;
+  const double o5_1 = 37.0/378.0, o5_3 = 250.0/621.0, o5_4 = 125.0/594.0, o5_6 = 512.0/1771.0;
+
+  // Set initial time and solution
+  double t = t0;
+  for(int j=0; j<dim; j++) {
+    U[j] = U0[j];
+    if(!std::isfinite(U[j])) return -1;
+  }
+  if(check_state(U)) return -1;
+
+  RKDenseOutput<dim> step;
+  double Utmp[dim], Utmp2[dim], k2[dim], k3[dim], k4[dim], k5[dim], k6[dim];
+  double *k1 = step.F0;
+
+  double dt = dt0; //initial step size
+  if((dt>=0 && t+dt>tf) || (dt<0 && t+dt<tf))
+    dt = tf-t;
+  const double safety = 0.9, alpha_1 = -0.2, alpha_2 = -0.25, err0 = 1.0e-30; //params in adaptation
+  const double max_increase = 10.0, max_decrease = 0.2;
+  double ratio, rel_error;
+
+  fun(U, t, k1);
+
+  for(int i=0; i<Nmax; i++) {
+
+    for(int j=0; j<dim; j++) {
+      Utmp[j] = U[j] + dt*p2_1*k1[j];
+      if(!std::isfinite(Utmp[j]))
+        return 1;
+    }
+    if(check_state(Utmp))
+      return 1;
+    fun(Utmp, t+c2*dt, k2);
+
+    for(int j=0; j<dim; j++) {
+      Utmp[j] = U[j] + dt*(p3_1*k1[j] + p3_2*k2[j]);
+      if(!std::isfinite(Utmp[j]))
+        return 1;
+    }
+    if(check_state(Utmp))
+      return 1;
+    fun(Utmp, t+c3*dt, k3);
+
+    for(int j=0; j<dim; j++) {
+      Utmp[j] = U[j] + dt*(p4_1*k1[j] + p4_2*k2[j] + p4_3*k3[j]);
+      if(!std::isfinite(Utmp[j]))
+        return 1;
+    }
+    if(check_state(Utmp))
+      return 1;
+    fun(Utmp, t+c4*dt, k4);
+
+    for(int j=0; j<dim; j++) {
+      Utmp[j] = U[j] + dt*(p5_1*k1[j] + p5_2*k2[j] + p5_3*k3[j] + p5_4*k4[j]);
+      if(!std::isfinite(Utmp[j]))
+        return 1;
+    }
+    if(check_state(Utmp))
+      return 1;
+    fun(Utmp, t+c5*dt, k5);
+
+    for(int j=0; j<dim; j++) {
+      Utmp[j] = U[j] + dt*(p6_1*k1[j] + p6_2*k2[j] + p6_3*k3[j] + p6_4*k4[j] + p6_5*k5[j]);
+      if(!std::isfinite(Utmp[j]))
+        return 1;
+    }
+    if(check_state(Utmp))
+      return 1;
+    fun(Utmp, t+c6*dt, k6);
+
+    //4th and 5th order approximations
+    for(int j=0; j<dim; j++) {
+      Utmp[j]  = U[j] + dt*(o4_1*k1[j] + o4_3*k3[j] + o4_4*k4[j] + o4_5*k5[j] + o4_6*k6[j]); //4th order
+      Utmp2[j] = U[j] + dt*(o5_1*k1[j] + o5_3*k3[j] + o5_4*k4[j] + o5_6*k6[j]); //5th order
+      if(!std::isfinite(Utmp[j]) || !std::isfinite(Utmp2[j]))
+        return 1;
+    }
+    if(check_state(Utmp) || check_state(Utmp2))
+      return 1;
+
+    //Check relative error to determine (1) whether we should repeat the step and (2) the new dt
+    ratio = max_increase;
+    for(int j=0; j<dim; j++) {
+      rel_error = std::max(fabs(Utmp[j]), fabs(Utmp2[j]));
+      if(rel_error!=0.0)
+        rel_error = fabs((Utmp[j] - Utmp2[j])/rel_error + err0)/tol;
+      else
+        rel_error = err0/tol;
+
+      if(rel_error>1.0) // Should decrease dt
+        ratio = std::min(ratio, safety*pow(rel_error, alpha_2));
+      else // this component (j) wants to increase dt
+        ratio = std::min(ratio, safety*pow(rel_error, alpha_1));
+    }
+    ratio = std::max(ratio, max_decrease); //cannot decrease by more than max_decrease
+
+    if(ratio<1.0) { //repeat the same step with a smaller dt (k1 is unchanged)
+      dt *= ratio;
+      continue;
+    }
+
+    // accept the step
+    step.t0 = t;
+    for(int j=0; j<dim; j++)
+      step.U0[j] = U[j];
+
+    t += dt;
+    for(int j=0; j<dim; j++)
+      U[j] = step.U1[j] = Utmp2[j];
+    step.t1 = t;
+    fun(U, t, step.F1);
+    observer(static_cast<const RKDenseOutput<dim>&>(step));
+
+    if((dt>=0 && t-tf>=-1e-9*dt) || //marching forward
+       (dt<0  && t-tf<=-1e-9*dt))   //marching backward
+      return 0; //DONE!
+
+    for(int j=0; j<dim; j++)
+      k1[j] = step.F1[j]; //k1 of the next step
+
+    dt *= ratio;
+    if((dt>=0 && t+dt-tf>=1e-9*dt) || //next step should be at tf exactly
+       (dt<0  && t+dt-tf<=1e-9*dt))
+      dt = tf-t;
+  }
+
+  return 2; //it has exhaused Nmax iterations w/o reaching tf.
+}
+
+//------------------------------------------------------------------------
+
 
 
 
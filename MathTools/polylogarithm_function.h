@@ -45,10 +45,16 @@ double polylogarithm_function(int s, double z, int kmax, double rel_tol = 0.0)
 
   double numerator = z;
   double res = z; //the first term
-  double term(0.0);
+  double term(0.0), ks;
   for(int k=2; k<=kmax; k++) {
     numerator *= z;
-    term = numerator/pow(k,s);
+    if(s>0) { //k^s by multiplication (avoids pow)
+      ks = k;
+      for(int i=1; i<s; i++)
+        ks *= k;
+      term = numerator/ks;
+    } else
+      term = numerator/pow(k,s);
     res += term;
     if(res!=0.0 && fabs(term/res)<=rel_tol)
       break;
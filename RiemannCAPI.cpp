@@ -0,0 +1,366 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <RiemannCAPI.h>
+#include <VarFcnFactory.h>
+#include <ExactRiemannSolverBase.h>
+#include <ExactRiemannSolverBatch.h>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+struct riemann_materials {
+  std::vector<MaterialModelData> data;
+  std::vector<VarFcnBase*> vf;
+};
+
+struct riemann_solver {
+  riemann_materials *materials; //!< not owned
+  ExactRiemannSolverData iod_riemann; //!< the solver keeps a reference to it
+  ExactRiemannSolverBase *riemann;
+  ExactRiemannSolverBatch *batch; //!< created at the first batch call
+};
+
+//-----------------------------------------------------
+// Conversion between riemann_material_params and MaterialModelData
+//-----------------------------------------------------
+
+static void
+CopyMaterialParameters(const MaterialModelData &data, riemann_material_params &p)
+{
+  p.eos = (int)data.eos;
+  p.rhomin = data.rhomin;  p.pmin = data.pmin;
+  p.rhomax = data.rhomax;  p.pmax = data.pmax;
+  p.failsafe_density = data.failsafe_density;
+
+  const StiffenedGasModelData &sg(data.sgModel);
+  p.sg.specificHeatRatio = sg.specificHeatRatio;
+  p.sg.pressureConstant  = sg.pressureConstant;
+  p.sg.enthalpyConstant  = sg.enthalpyConstant;
+  p.sg.cv = sg.cv;  p.sg.T0 = sg.T0;  p.sg.e0 = sg.e0;
+  p.sg.cp = sg.cp;  p.sg.h0 = sg.h0;  p.sg.rho0 = sg.rho0;
+
+  const NobleAbelStiffenedGasModelData &nasg(data.nasgModel);
+  p.nasg.specificHeatRatio = nasg.specificHeatRatio;
+  p.nasg.pressureConstant  = nasg.pressureConstant;
+  p.nasg.volumeConstant    = nasg.volumeConstant;
+  p.nasg.energyConstant    = nasg.energyConstant;
+  p.nasg.entropyConstant   = nasg.entropyConstant;
+  p.nasg.cv = nasg.cv;
+
+  const MieGruneisenModelData &mg(data.mgModel);
+  p.mg.rho0 = mg.rho0;  p.mg.c0 = mg.c0;  p.mg.Gamma0 = mg.Gamma0;  p.mg.s = mg.s;  p.mg.e0 = mg.e0;
+  p.mg.cv = mg.cv;  p.mg.T0 = mg.T0;  p.mg.cp = mg.cp;  p.mg.h0 = mg.h0;
+
+  const ExtendedMieGruneisenModelData &mgext(data.mgextModel);
+  p.mgext.rho0 = mgext.rho0;  p.mgext.c0 = mgext.c0;  p.mgext.Gamma0 = mgext.Gamma0;
+  p.mgext.s = mgext.s;  p.mgext.e0 = mgext.e0;
+  p.mgext.eta_min = mgext.eta_min;
+  p.mgext.Tlaw = (int)mgext.Tlaw;
+  p.mgext.cv = mgext.cv;  p.mgext.T0 = mgext.T0;  p.mgext.cp = mgext.cp;  p.mgext.h0 = mgext.h0;
+
+  const TillotsonModelData &till(data.tillotModel);
+  p.tillotson.rho0 = till.rho0;  p.tillotson.e0 = till.e0;
+  p.tillotson.a = till.a;  p.tillotson.b = till.b;  p.tillotson.A = till.A;  p.tillotson.B = till.B;
+  p.tillotson.alpha = till.alpha;  p.tillotson.beta = till.beta;
+  p.tillotson.rhoIV = till.rhoIV;  p.tillotson.eIV = till.eIV;  p.tillotson.eCV = till.eCV;
+  p.tillotson.cv = till.cv;
+  p.tillotson.temperature_depends_on_density = (int)till.temperature_depends_on_density;
+  p.tillotson.T0 = till.T0;  p.tillotson.cp = till.cp;  p.tillotson.h0 = till.h0;
+
+  const JonesWilkinsLeeModelData &jwl(data.jwlModel);
+  p.jwl.omega = jwl.omega;  p.jwl.A1 = jwl.A1;  p.jwl.A2 = jwl.A2;
+  p.jwl.R1 = jwl.R1;  p.jwl.R2 = jwl.R2;  p.jwl.rho0 = jwl.rho0;
+
+  const ANEOSBirchMurnaghanDebyeModelData &aneos(data.abmdModel);
+  p.aneos.zeroKelvinDensity = aneos.zeroKelvinDensity;
+  p.aneos.b0 = aneos.b0;  p.aneos.b0prime = aneos.b0prime;  p.aneos.delta_e = aneos.delta_e;
+  p.aneos.molar_mass = aneos.molar_mass;  p.aneos.T0 = aneos.T0;  p.aneos.e0 = aneos.e0;
+  p.aneos.Gamma0 = aneos.Gamma0;  p.aneos.rho0 = aneos.rho0;
+  p.aneos.boltzmann_constant = aneos.boltzmann_constant;
+  p.aneos.debye_evaluation = (int)aneos.debye_evaluation;
+}
+
+//-----------------------------------------------------
+
+static void
+CopyMaterialParameters(const riemann_material_params &p, MaterialModelData &data)
+{
+  data.eos = (MaterialModelData::EOS)p.eos;
+  data.rhomin = p.rhomin;  data.pmin = p.pmin;
+  data.rhomax = p.rhomax;  data.pmax = p.pmax;
+  data.failsafe_density = p.failsafe_density;
+
+  StiffenedGasModelData &sg(data.sgModel);
+  sg.specificHeatRatio = p.sg.specificHeatRatio;
+  sg.pressureConstant  = p.sg.pressureConstant;
+  sg.enthalpyConstant  = p.sg.enthalpyConstant;
+  sg.cv = p.sg.cv;  sg.T0 = p.sg.T0;  sg.e0 = p.sg.e0;
+  sg.cp = p.sg.cp;  sg.h0 = p.sg.h0;  sg.rho0 = p.sg.rho0;
+
+  NobleAbelStiffenedGasModelData &nasg(data.nasgModel);
+  nasg.specificHeatRatio = p.nasg.specificHeatRatio;
+  nasg.pressureConstant  = p.nasg.pressureConstant;
+  nasg.volumeConstant    = p.nasg.volumeConstant;
+  nasg.energyConstant    = p.nasg.energyConstant;
+  nasg.entropyConstant   = p.nasg.entropyConstant;
+  nasg.cv = p.nasg.cv;
+
+  MieGruneisenModelData &mg(data.mgModel);
+  mg.rho0 = p.mg.rho0;  mg.c0 = p.mg.c0;  mg.Gamma0 = p.mg.Gamma0;  mg.s = p.mg.s;  mg.e0 = p.mg.e0;
+  mg.cv = p.mg.cv;  mg.T0 = p.mg.T0;  mg.cp = p.mg.cp;  mg.h0 = p.mg.h0;
+
+  ExtendedMieGruneisenModelData &mgext(data.mgextModel);
+  mgext.rho0 = p.mgext.rho0;  mgext.c0 = p.mgext.c0;  mgext.Gamma0 = p.mgext.Gamma0;
+  mgext.s = p.mgext.s;  mgext.e0 = p.mgext.e0;
+  mgext.eta_min = p.mgext.eta_min;
+  mgext.Tlaw = (ExtendedMieGruneisenModelData::TemperatureLaw)p.mgext.Tlaw;
+  mgext.cv = p.mgext.cv;  mgext.T0 = p.mgext.T0;  mgext.cp = p.mgext.cp;  mgext.h0 = p.mgext.h0;
+
+  TillotsonModelData &till(data.tillotModel);
+  till.rho0 = p.tillotson.rho0;  till.e0 = p.tillotson.e0;
+  till.a = p.tillotson.a;  till.b = p.tillotson.b;  till.A = p.tillotson.A;  till.B = p.tillotson.B;
+  till.alpha = p.tillotson.alpha;  till.beta = p.tillotson.beta;
+  till.rhoIV = p.tillotson.rhoIV;  till.eIV = p.tillotson.eIV;  till.eCV = p.tillotson.eCV;
+  till.cv = p.tillotson.cv;
+  till.temperature_depends_on_density = (TillotsonModelData::YesNo)p.tillotson.temperature_depends_on_density;
+  till.T0 = p.tillotson.T0;  till.cp = p.tillotson.cp;  till.h0 = p.tillotson.h0;
+
+  JonesWilkinsLeeModelData &jwl(data.jwlModel);
+  jwl.omega = p.jwl.omega;  jwl.A1 = p.jwl.A1;  jwl.A2 = p.jwl.A2;
+  jwl.R1 = p.jwl.R1;  jwl.R2 = p.jwl.R2;  jwl.rho0 = p.jwl.rho0;
+
+  ANEOSBirchMurnaghanDebyeModelData &aneos(data.abmdModel);
+  aneos.zeroKelvinDensity = p.aneos.zeroKelvinDensity;
+  aneos.b0 = p.aneos.b0;  aneos.b0prime = p.aneos.b0prime;  aneos.delta_e = p.aneos.delta_e;
+  aneos.molar_mass = p.aneos.molar_mass;  aneos.T0 = p.aneos.T0;  aneos.e0 = p.aneos.e0;
+  aneos.Gamma0 = p.aneos.Gamma0;  aneos.rho0 = p.aneos.rho0;
+  aneos.boltzmann_constant = p.aneos.boltzmann_constant;
+  aneos.debye_evaluation = (ANEOSBirchMurnaghanDebyeModelData::DebyeFunctionEvaluation)p.aneos.debye_evaluation;
+}
+
+//-----------------------------------------------------
+
+void riemann_material_params_init(riemann_material_params *params, int eos)
+{
+  MaterialModelData data;
+  CopyMaterialParameters(data, *params);
+  params->eos = eos;
+  params->verbose = 0;
+}
+
+//-----------------------------------------------------
+
+//! The EOS constructors terminate the process if the parameters are invalid. So, they are checked here
+//! (the same conditions as in the constructors)
+
+static int
+CheckMaterialParameters(const MaterialModelData &data)
+{
+  switch(data.eos) {
+    case MaterialModelData::STIFFENED_GAS :
+    case MaterialModelData::NOBLE_ABEL_STIFFENED_GAS :
+    case MaterialModelData::JWL :
+    case MaterialModelData::ANEOS_BIRCH_MURNAGHAN_DEBYE :
+      return RIEMANN_MATERIALS_OK;
+    case MaterialModelData::MIE_GRUNEISEN : {
+      const MieGruneisenModelData &mg(data.mgModel);
+      return mg.rho0>0.0 && mg.c0>0.0 && mg.Gamma0>0.0 && mg.s>0.0 ?
+             RIEMANN_MATERIALS_OK : RIEMANN_MATERIALS_INVALID_PARAMETERS;
+    }
+    case MaterialModelData::EXTENDED_MIE_GRUNEISEN : {
+      const ExtendedMieGruneisenModelData &mg(data.mgextModel);
+      return mg.rho0>0.0 && mg.c0>0.0 && mg.Gamma0>0.0 && mg.s>0.0 && mg.eta_min<0.0 ?
+             RIEMANN_MATERIALS_OK : RIEMANN_MATERIALS_INVALID_PARAMETERS;
+    }
+    case MaterialModelData::TILLOTSON : {
+      const TillotsonModelData &t(data.tillotModel);
+      return t.eCV>t.eIV && t.rhoIV>0.0 && t.rhoIV<t.rho0 && t.e0>0.0 ?
+             RIEMANN_MATERIALS_OK : RIEMANN_MATERIALS_INVALID_PARAMETERS;
+    }
+    default :
+      return RIEMANN_MATERIALS_UNSUPPORTED_EOS;
+  }
+}
+
+//-----------------------------------------------------
+
+riemann_materials* riemann_materials_create(int n, const riemann_material_params *params, int *err)
+{
+  int dummy;
+  if(!err)
+    err = &dummy;
+
+  *err = RIEMANN_MATERIALS_INVALID_ARGUMENT;
+  if(n<=0 || !params)
+    return NULL;
+
+  riemann_materials *materials = new riemann_materials;
+  materials->data.resize(n);
+  for(int i=0; i<n; i++)
+    CopyMaterialParameters(params[i], materials->data[i]);
+
+  // check all the materials before creating any of them
+  for(int i=0; i<n; i++) {
+    *err = CheckMaterialParameters(materials->data[i]);
+    if(*err != RIEMANN_MATERIALS_OK) {
+      if(params[i].verbose>=1)
+        fprintf(stdout, "\033[0;31m*** Error: Material %d (EOS %d) is not supported, or has invalid "
+                "parameters.\033[0m\n", i, params[i].eos);
+      delete materials;
+      return NULL;
+    }
+  }
+
+  for(int i=0; i<n; i++) {
+    VarFcnBase *vf = CreateVarFcn(materials->data[i], params[i].verbose);
+    assert(vf); //the EOS has been checked above
+    materials->vf.push_back(vf);
+  }
+  *err = RIEMANN_MATERIALS_OK;
+  return materials;
+}
+
+//-----------------------------------------------------
+
+void riemann_materials_free(riemann_materials *materials)
+{
+  if(!materials)
+    return;
+  for(auto &vf : materials->vf)
+    delete vf;
+  delete materials;
+}
+
+//-----------------------------------------------------
+
+void riemann_solver_params_init(riemann_solver_params *params)
+{
+  ExactRiemannSolverData data;
+  params->maxIts_main           = data.maxIts_main;
+  params->maxIts_bracket        = data.maxIts_bracket;
+  params->maxIts_shock          = data.maxIts_shock;
+  params->numSteps_rarefaction  = data.numSteps_rarefaction;
+  params->tol_main              = data.tol_main;
+  params->tol_shock             = data.tol_shock;
+  params->tol_rarefaction       = data.tol_rarefaction;
+  params->min_pressure          = data.min_pressure;
+  params->failure_threshold     = data.failure_threshold;
+  params->pressure_at_failure   = data.pressure_at_failure;
+  params->acoustic_threshold    = data.acoustic_threshold;
+  params->bracketing_candidates = data.bracketing_candidates;
+  params->verbose = 0;
+}
+
+//-----------------------------------------------------
+
+riemann_solver* riemann_solver_create(riemann_materials *materials, const riemann_solver_params *params)
+{
+  if(!materials)
+    return NULL;
+
+  riemann_solver_params p;
+  if(params)
+    p = *params;
+  else
+    riemann_solver_params_init(&p);
+
+  riemann_solver *solver = new riemann_solver;
+  solver->materials = materials;
+
+  ExactRiemannSolverData &iod(solver->iod_riemann);
+  iod.maxIts_main           = p.maxIts_main;
+  iod.maxIts_bracket        = p.maxIts_bracket;
+  iod.maxIts_shock          = p.maxIts_shock;
+  iod.numSteps_rarefaction  = p.numSteps_rarefaction;
+  iod.tol_main              = p.tol_main;
+  iod.tol_shock             = p.tol_shock;
+  iod.tol_rarefaction       = p.tol_rarefaction;
+  iod.min_pressure          = p.min_pressure;
+  iod.failure_threshold     = p.failure_threshold;
+  iod.pressure_at_failure   = p.pressure_at_failure;
+  iod.acoustic_threshold    = p.acoustic_threshold;
+  iod.bracketing_candidates = p.bracketing_candidates;
+
+  solver->riemann = new ExactRiemannSolverBase(materials->vf, iod);
+  solver->riemann->SetVerbosity(p.verbose);
+  solver->batch = NULL;
+  return solver;
+}
+
+//-----------------------------------------------------
+
+void riemann_solver_free(riemann_solver *solver)
+{
+  if(!solver)
+    return;
+  if(solver->batch)
+    delete solver->batch;
+  delete solver->riemann;
+  delete solver;
+}
+
+//-----------------------------------------------------
+// The solver does not modify its inputs (hence the const_casts below)
+//-----------------------------------------------------
+
+int riemann_solve(riemann_solver *solver, const double *dir, const double *Vm, int idm,
+                  const double *Vp, int idp, double *Vs, int *id, double *Vsm, double *Vsp)
+{
+  if(!solver->riemann->IsValidInputState(Vm, idm) || !solver->riemann->IsValidInputState(Vp, idp))
+    return -1;
+
+  return solver->riemann->ComputeRiemannSolution(const_cast<double*>(dir), const_cast<double*>(Vm), idm,
+                                                 const_cast<double*>(Vp), idp, Vs, *id, Vsm, Vsp);
+}
+
+//-----------------------------------------------------
+
+int riemann_solve_batch(riemann_solver *solver, int N, const double *dir, const double *Vm, const int *idm,
+                        const double *Vp, const int *idp, double *Vs, int *id, double *Vsm, double *Vsp)
+{
+  for(int i=0; i<N; i++)
+    if(!solver->riemann->IsValidInputState(&Vm[5*i], idm[i]) || !solver->riemann->IsValidInputState(&Vp[5*i], idp[i]))
+      return -1;
+
+  if(!solver->batch)
+    solver->batch = new ExactRiemannSolverBatch(solver->materials->vf, solver->iod_riemann, *solver->riemann);
+
+  return solver->batch->ComputeRiemannSolutions(N, const_cast<double*>(dir), const_cast<double*>(Vm),
+                                                const_cast<int*>(idm), const_cast<double*>(Vp),
+                                                const_cast<int*>(idp), Vs, id, Vsm, Vsp);
+}
+
+//-----------------------------------------------------
+
+int riemann_solve_one_sided(riemann_solver *solver, const double *dir, const double *Vm, int idm,
+                            const double *Ustar, double *Vs, int *id, double *Vsm)
+{
+  if(!solver->riemann->IsValidInputState(Vm, idm))
+    return -1;
+
+  return solver->riemann->ComputeOneSidedRiemannSolution(const_cast<double*>(dir), const_cast<double*>(Vm), idm,
+                                                         const_cast<double*>(Ustar), Vs, *id, Vsm);
+}
+
+//-----------------------------------------------------
+
+int riemann_solve_one_sided_batch(riemann_solver *solver, int N, const double *dir, const double *Vm,
+                                  const int *idm, const double *Ustar, double *Vs, int *id, double *Vsm,
+                                  const double *ps_hint)
+{
+  for(int i=0; i<N; i++)
+    if(!solver->riemann->IsValidInputState(&Vm[5*i], idm[i]))
+      return -1;
+
+  if(!solver->batch)
+    solver->batch = new ExactRiemannSolverBatch(solver->materials->vf, solver->iod_riemann, *solver->riemann);
+
+  return solver->batch->ComputeOneSidedRiemannSolutions(N, const_cast<double*>(dir), const_cast<double*>(Vm),
+                                                        const_cast<int*>(idm), const_cast<double*>(Ustar),
+                                                        Vs, id, Vsm, const_cast<double*>(ps_hint));
+}
+
+//-----------------------------------------------------
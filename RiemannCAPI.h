@@ -0,0 +1,157 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _RIEMANN_C_API_H_
+#define _RIEMANN_C_API_H_
+
+/*****************************************************************************************
+ * C interface of the exact Riemann solver (library riemann_core), for calling the solver
+ * in-process from other codes (C, C++, Fortran via ISO_C_BINDING, Python via ctypes, etc.).
+ *
+ * Usage:
+ *   1. Fill a riemann_material_params for each material (start from riemann_material_params_init,
+ *      which sets the same defaults as the input file), and call riemann_materials_create.
+ *   2. Create one or more solvers with riemann_solver_create (NULL params: default settings).
+ *   3. Call riemann_solve, riemann_solve_batch, riemann_solve_one_sided, riemann_solve_one_sided_batch.
+ *   4. Free the solvers, then the materials.
+ *
+ * States are primitive: V = (rho, u, v, w, p), and dir is the unit normal (pointing from the "minus"
+ * state to the "plus" state, or towards the wall/interface in one-sided problems). The inputs and
+ * outputs have the same meaning as in ExactRiemannSolverBase::ComputeRiemannSolution and
+ * ComputeOneSidedRiemannSolution. Batches are stored contiguously (dir: 3N, states: 5N, ids: N).
+ *
+ * There is no global state: everything is owned by the handles. A solver (and the materials it uses)
+ * should be accessed by one thread at a time. To solve in parallel, create a solver per thread and,
+ * for EOS that store intermediate results (ANEOS), a set of materials per thread as well.
+ *****************************************************************************************/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! equations of state (same values as MaterialModelData::EOS)
+enum riemann_eos {RIEMANN_EOS_STIFFENED_GAS = 0, RIEMANN_EOS_NOBLE_ABEL_STIFFENED_GAS = 1,
+                  RIEMANN_EOS_MIE_GRUNEISEN = 2, RIEMANN_EOS_EXTENDED_MIE_GRUNEISEN = 3,
+                  RIEMANN_EOS_TILLOTSON = 4, RIEMANN_EOS_JWL = 5, RIEMANN_EOS_ANEOS_BIRCH_MURNAGHAN_DEBYE = 6};
+
+//! parameters of a material. Only the block of the selected EOS is used (see IoData.h for the meaning)
+typedef struct {
+
+  int eos; //!< riemann_eos
+  double rhomin, pmin, rhomax, pmax;
+  double failsafe_density;
+
+  int verbose; //!< verbosity of the EOS warnings (0: none)
+
+  struct {
+    double specificHeatRatio, pressureConstant, enthalpyConstant;
+    double cv, T0, e0, cp, h0, rho0;
+  } sg;
+
+  struct {
+    double specificHeatRatio, pressureConstant, volumeConstant, energyConstant, entropyConstant;
+    double cv;
+  } nasg;
+
+  struct {
+    double rho0, c0, Gamma0, s, e0;
+    double cv, T0, cp, h0;
+  } mg;
+
+  struct {
+    double rho0, c0, Gamma0, s, e0;
+    double eta_min;
+    int Tlaw;
+    double cv, T0, cp, h0;
+  } mgext;
+
+  struct {
+    double rho0, e0, a, b, A, B, alpha, beta;
+    double rhoIV, eIV, eCV;
+    double cv;
+    int temperature_depends_on_density;
+    double T0, cp, h0;
+  } tillotson;
+
+  struct {
+    double omega, A1, A2, R1, R2, rho0;
+  } jwl;
+
+  struct {
+    double zeroKelvinDensity, b0, b0prime, delta_e, molar_mass, T0, e0, Gamma0, rho0;
+    double boltzmann_constant;
+    int debye_evaluation;
+  } aneos;
+
+} riemann_material_params;
+
+//! settings of the solver (see ExactRiemannSolverData in IoData.h)
+typedef struct {
+
+  int maxIts_main, maxIts_bracket, maxIts_shock;
+  int numSteps_rarefaction;
+  double tol_main, tol_shock, tol_rarefaction;
+  double min_pressure;
+  double failure_threshold, pressure_at_failure;
+  double acoustic_threshold;
+  int bracketing_candidates;
+
+  int verbose; //!< verbosity of the solver warnings (0: none)
+
+} riemann_solver_params;
+
+typedef struct riemann_materials riemann_materials; //!< opaque: a set of materials (ids 0, 1, ...)
+typedef struct riemann_solver riemann_solver; //!< opaque: an exact Riemann solver
+
+//! sets the default parameters of a material with the given EOS
+void riemann_material_params_init(riemann_material_params *params, int eos);
+
+//! error codes of riemann_materials_create
+enum riemann_materials_error {RIEMANN_MATERIALS_OK = 0, RIEMANN_MATERIALS_INVALID_ARGUMENT = 1,
+                              RIEMANN_MATERIALS_UNSUPPORTED_EOS = 2, RIEMANN_MATERIALS_INVALID_PARAMETERS = 3};
+
+//! creates n materials (material id = index in params). Returns NULL if an EOS is not supported, or if
+//! its parameters would make the EOS terminate the process (e.g., a non-positive rho0 in Mie-Gruneisen).
+//! If err is not NULL, it is set to a riemann_materials_error
+riemann_materials* riemann_materials_create(int n, const riemann_material_params *params, int *err);
+
+void riemann_materials_free(riemann_materials *materials);
+
+//! sets the default settings of the solver
+void riemann_solver_params_init(riemann_solver_params *params);
+
+//! params can be NULL (default settings). The materials must outlive the solver
+riemann_solver* riemann_solver_create(riemann_materials *materials, const riemann_solver_params *params);
+
+void riemann_solver_free(riemann_solver *solver);
+
+//! Solves a two-sided problem. Vsm and Vsp (star states) can be NULL. Returns the error code of the
+//! solver (0: success), or -1 if an input is invalid (unknown material, or a state that is not admissible)
+int riemann_solve(riemann_solver *solver, const double *dir, const double *Vm, int idm,
+                  const double *Vp, int idp, double *Vs, int *id, double *Vsm, double *Vsp);
+
+//! Solves N two-sided problems. Vsm and Vsp can be NULL. Returns the number of problems for which
+//! the solver failed (error code 1; vacuum and cavitation are not counted), or -1 if an input is
+//! invalid (in which case nothing is solved)
+int riemann_solve_batch(riemann_solver *solver, int N, const double *dir, const double *Vm, const int *idm,
+                        const double *Vp, const int *idp, double *Vs, int *id, double *Vsm, double *Vsp);
+
+//! Solves a one-sided (wall/interface) problem with wall velocity Ustar (3D). Returns the error code of
+//! the solver (0: success), or -1 if an input is invalid
+int riemann_solve_one_sided(riemann_solver *solver, const double *dir, const double *Vm, int idm,
+                            const double *Ustar, double *Vs, int *id, double *Vsm);
+
+//! Solves N one-sided problems. ps_hint (estimates of p*) can be NULL, and is only used for shocks
+//! (see ExactRiemannSolverBatch). Returns the number of problems for which the solver reported an
+//! error, or -1 if an input is invalid (in which case nothing is solved)
+int riemann_solve_one_sided_batch(riemann_solver *solver, int N, const double *dir, const double *Vm,
+                                  const int *idm, const double *Ustar, double *Vs, int *id, double *Vsm,
+                                  const double *ps_hint);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
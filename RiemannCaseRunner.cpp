@@ -0,0 +1,183 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <RiemannCaseRunner.h>
+#include <VarFcnFactory.h>
+#include <Utils.h>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cmath>
+
+//-----------------------------------------------------
+
+RiemannCaseRunner::RiemannCaseRunner(std::vector<VarFcnBase*> &vf_, IoData &iod_,
+                                     EOSAdmissibilityEnvelope *envelope_, StarPressureAtlas *atlas_,
+                                     int verbose_)
+                 : vf(vf_), iod(iod_), envelope(envelope_), atlas(atlas_), verbose(verbose_)
+{ }
+
+//-----------------------------------------------------
+
+int
+RiemannCaseRunner::Run()
+{
+  RiemannCasesData &iod_cases(iod.riemann_cases);
+
+  std::vector<RiemannCaseData*> cases;
+  std::vector<std::string> names;
+  for(auto it = iod_cases.caseMap.dataMap.begin(); it != iod_cases.caseMap.dataMap.end(); it++) {
+    RiemannCaseData &c(*it->second);
+    double norm = sqrt(c.normal_x*c.normal_x + c.normal_y*c.normal_y + c.normal_z*c.normal_z);
+    if(!(norm>0.0)) {
+      print_error("*** Error: Detected invalid normal direction in Riemann problem %d.\n", it->first);
+      return 1;
+    }
+    cases.push_back(&c);
+    names.push_back(strcmp(c.name, "") ? std::string(c.name) : std::to_string(it->first));
+  }
+
+  bool profiles = strcmp(iod_cases.solution_prefix, "");
+#if PRINT_RIEMANN_SOLUTION != 1
+  if(profiles) {
+    print("Warning: SolutionFilePrefix is ignored (requires compiling with PRINT_RIEMANN_SOLUTION).\n");
+    profiles = false;
+  }
+#endif
+
+  int N = cases.size();
+  int nThreads = iod_cases.num_threads>0 ? iod_cases.num_threads
+                                         : std::max(1, (int)std::thread::hardware_concurrency());
+  nThreads = std::max(1, std::min(nThreads, N));
+#if PRINT_RIEMANN_SOLUTION == 1
+  if(nThreads>1) { //the solver prints traces for every case, which would be interleaved
+    print("Warning: The Riemann problems are solved using 1 thread when compiled with PRINT_RIEMANN_SOLUTION.\n");
+    nThreads = 1;
+  }
+#endif
+
+  print("- Solving %d Riemann problem(s) using %d thread(s).\n", N, nThreads);
+  fflush(stdout);
+
+  std::vector<Result> results(N);
+  std::atomic<int> next(0);
+
+  // each thread takes the next unsolved case, until all the cases are solved
+  auto work = [&](std::vector<VarFcnBase*> &vf_) {
+    ExactRiemannSolverBase riemann(vf_, iod.exact_riemann);
+    riemann.SetVerbosity(verbose);
+    if(envelope)
+      riemann.SetAdmissibilityEnvelope(envelope);
+    if(atlas)
+      riemann.SetStarPressureAtlas(atlas);
+    for(int i = next++; i<N; i = next++) {
+#if PRINT_RIEMANN_SOLUTION == 1
+      riemann.SetSolutionFile(profiles ? (std::string(iod_cases.solution_prefix) + names[i] + ".txt").c_str() : "");
+#endif
+      SolveCase(riemann, *cases[i], names[i], results[i]);
+    }
+  };
+
+  // the first thread uses the original VarFcn objects. The others make copies
+  std::vector<std::vector<VarFcnBase*> > vf_threads(nThreads-1);
+  for(auto &vf_t : vf_threads)
+    vf_t = CopyMaterialVarFcns(vf, iod.eqs.materials, verbose);
+
+  std::vector<std::thread> threads;
+  for(int t=1; t<nThreads; t++)
+    threads.push_back(std::thread(work, std::ref(vf_threads[t-1])));
+  work(vf);
+  for(auto &th : threads)
+    th.join();
+
+  for(auto &vf_t : vf_threads)
+    for(auto &v : vf_t)
+      delete v;
+
+  return WriteResults(cases, names, results);
+}
+
+//-----------------------------------------------------
+
+void
+RiemannCaseRunner::SolveCase(ExactRiemannSolverBase &riemann, RiemannCaseData &c, std::string &name,
+                             Result &result)
+{
+  double norm = sqrt(c.normal_x*c.normal_x + c.normal_y*c.normal_y + c.normal_z*c.normal_z); //checked in Run
+  double dir[3] = {c.normal_x/norm, c.normal_y/norm, c.normal_z/norm};
+  double Vm[5] = {c.left.density, c.left.velocity_x, c.left.velocity_y, c.left.velocity_z, c.left.pressure};
+  double Vp[5] = {c.right.density, c.right.velocity_x, c.right.velocity_y, c.right.velocity_z, c.right.pressure};
+  int idm = c.left.materialid, idp = c.right.materialid;
+  bool one_sided = c.one_sided == RiemannCaseData::YES;
+
+  bool valid = riemann.IsValidInputState(Vm, idm);
+  if(!one_sided)
+    valid = valid && riemann.IsValidInputState(Vp, idp);
+  if(!valid) {
+    if(verbose>=1)
+      print_error("*** Error: Detected invalid state(s) in Riemann problem %s.\n", name.c_str());
+    result.err = -1;
+    result.id = -1;
+    for(int j=0; j<5; j++)
+      result.V[j] = result.Vsm[j] = result.Vsp[j] = 0.0;
+    return;
+  }
+
+  if(one_sided) {
+    double Ustar[3] = {Vp[1], Vp[2], Vp[3]};
+    result.err = riemann.ComputeOneSidedRiemannSolution(dir, Vm, idm, Ustar, result.V, result.id, result.Vsm);
+    for(int j=0; j<5; j++)
+      result.Vsp[j] = result.Vsm[j];
+  } else
+    result.err = riemann.ComputeRiemannSolution(dir, Vm, idm, Vp, idp, result.V, result.id,
+                                                result.Vsm, result.Vsp);
+}
+
+//-----------------------------------------------------
+
+int
+RiemannCaseRunner::WriteResults(std::vector<RiemannCaseData*> &cases, std::vector<std::string> &names,
+                                std::vector<Result> &results)
+{
+  const char *filename = iod.riemann_cases.result_file;
+  FILE *file = fopen(filename, "w");
+  if(!file) {
+    print_error("*** Error: Cannot open file %s for output.\n", filename);
+    return 1;
+  }
+
+  int num_failed = 0, num_invalid = 0;
+
+  print(file, "## Riemann problems: %d case(s).\n", (int)cases.size());
+  print(file, "## case | error code (-1: invalid input) | material id at x = 0 | solution at x = 0 "
+              "(density, velocity x, y, z, pressure) | left star state (same) | right star state (same)\n");
+  for(int i=0; i<(int)cases.size(); i++) {
+    Result &r(results[i]);
+    if(r.err<0)
+      num_invalid++;
+    else if(r.err>0)
+      num_failed++;
+    print(file, "%s  %d  %d", names[i].c_str(), r.err, r.id);
+    for(int j=0; j<5; j++)
+      print(file, "  %16.8e", r.V[j]);
+    for(int j=0; j<5; j++)
+      print(file, "  %16.8e", r.Vsm[j]);
+    for(int j=0; j<5; j++)
+      print(file, "  %16.8e", r.Vsp[j]);
+    print(file, "\n");
+  }
+  fclose(file);
+
+  print("- Wrote the solutions of %d Riemann problem(s) to %s.\n", (int)cases.size(), filename);
+  if(num_failed)
+    print("Warning: %d problem(s) reported an error code (vacuum, cavitation, or an approximate solution).\n",
+          num_failed);
+  if(num_invalid)
+    print("Warning: %d problem(s) had invalid input states (error code -1).\n", num_invalid);
+
+  return 0;
+}
+
+//-----------------------------------------------------
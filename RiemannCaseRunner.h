@@ -0,0 +1,63 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _RIEMANN_CASE_RUNNER_H_
+#define _RIEMANN_CASE_RUNNER_H_
+
+#include <ExactRiemannSolverBase.h>
+#include <vector>
+#include <string>
+
+/*****************************************************************************************
+ * Class RiemannCaseRunner solves the Riemann problems listed in the input file (RiemannProblems,
+ * see RiemannCasesData) in one process. The cases are distributed to multiple threads. Each thread
+ * has its own exact Riemann solver and its own VarFcn objects (some of them are not thread-safe).
+ * The admissibility envelope and the star pressure atlas, which are read-only after setup, are
+ * shared by all the threads.
+ *
+ * Output (text, one line per case, in the order of the case indices):
+ *   ## header
+ *   name  err  id  V(x=0)  Vsm  Vsp
+ * where V, Vsm, Vsp are primitive states (rho, vx, vy, vz, p), and err is the error code of the
+ * Riemann solver (-1: invalid input). For one-sided problems, Vsp = Vsm. If SolutionFilePrefix is
+ * specified, the 1D solution of each case is also written to a separate file (in the format of
+ * RiemannSolution.txt), which requires the code to be compiled with PRINT_RIEMANN_SOLUTION.
+ *****************************************************************************************/
+
+class RiemannCaseRunner {
+
+  //! the result of one case
+  struct Result {
+    int err, id;
+    double V[5], Vsm[5], Vsp[5];
+  };
+
+  std::vector<VarFcnBase*> &vf; //!< used by the first thread
+  IoData &iod;
+
+  EOSAdmissibilityEnvelope *envelope; //!< can be NULL
+  StarPressureAtlas *atlas; //!< can be NULL
+
+  int verbose;
+
+public:
+
+  RiemannCaseRunner(std::vector<VarFcnBase*> &vf_, IoData &iod_, EOSAdmissibilityEnvelope *envelope_,
+                    StarPressureAtlas *atlas_, int verbose_);
+  ~RiemannCaseRunner() {}
+
+  //! returns 0 if successful (failed cases are reported in the output, and do not count as errors)
+  int Run();
+
+private:
+
+  void SolveCase(ExactRiemannSolverBase &riemann, RiemannCaseData &c, std::string &name, Result &result);
+
+  int WriteResults(std::vector<RiemannCaseData*> &cases, std::vector<std::string> &names,
+                   std::vector<Result> &results);
+
+};
+
+#endif
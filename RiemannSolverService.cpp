@@ -0,0 +1,373 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <RiemannSolverService.h>
+#include <Utils.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+extern int verbose;
+
+//-----------------------------------------------------
+//! A bounded queue of blocks between two stages of the pipeline
+class BlockQueue {
+  std::deque<RiemannSolverService::Block*> blocks;
+  std::mutex mtx;
+  std::condition_variable not_empty, not_full;
+  size_t capacity;
+public:
+  BlockQueue(size_t capacity_) : capacity(capacity_) {}
+  void Push(RiemannSolverService::Block *block) {
+    std::unique_lock<std::mutex> lock(mtx);
+    not_full.wait(lock, [this]{return blocks.size()<capacity;});
+    blocks.push_back(block);
+    not_empty.notify_one();
+  }
+  RiemannSolverService::Block* Pop() {
+    std::unique_lock<std::mutex> lock(mtx);
+    not_empty.wait(lock, [this]{return !blocks.empty();});
+    RiemannSolverService::Block *block = blocks.front();
+    blocks.pop_front();
+    not_full.notify_one();
+    return block;
+  }
+};
+
+//-----------------------------------------------------
+
+RiemannSolverService::RiemannSolverService(std::vector<VarFcnBase*> &vf_, ExactRiemannSolverBase &riemann_,
+                                           RiemannSolverServiceData &iod_service_, int output_fd_)
+                    : vf(vf_), riemann(riemann_), iod_service(iod_service_)
+{
+  output_fd = output_fd_>=0 ? output_fd_ : STDOUT_FILENO;
+  num_requests = num_invalid = 0;
+
+#if PRINT_RIEMANN_SOLUTION == 1
+  riemann.SetSolutionFile(""); //do not write the solution of each request
+  print("Warning: The Riemann solver was compiled with PRINT_RIEMANN_SOLUTION, and prints a trace for every\n"
+        "         request (to stderr if the responses are written to stdout). For low latency, rebuild with\n"
+        "         -DPRINT_RIEMANN_SOLUTION=OFF.\n");
+#endif
+}
+
+//-----------------------------------------------------
+
+int
+RiemannSolverService::ReserveStandardOutput()
+{
+  fflush(stdout);
+  int fd = dup(STDOUT_FILENO);
+  if(fd<0 || dup2(STDERR_FILENO, STDOUT_FILENO)<0) {
+    print_error("*** Error: Unable to reserve stdout for the Riemann solver service (%s).\n", strerror(errno));
+    exit_mpi();
+  }
+  return fd;
+}
+
+//-----------------------------------------------------
+
+int
+RiemannSolverService::Run()
+{
+  signal(SIGPIPE, SIG_IGN); //a client that disconnects early should not terminate the service
+
+  if(iod_service.source == RiemannSolverServiceData::STANDARD_INPUT) {
+    print("- Riemann solver service: reading requests from stdin (%s format).\n",
+          iod_service.format == RiemannSolverServiceData::TEXT ? "text" : "binary");
+    fflush(stdout);
+    long n = Serve(STDIN_FILENO, output_fd);
+    print("- Riemann solver service: answered %ld request(s) (%ld invalid).\n", n, num_invalid);
+    return 0;
+  }
+
+  // Unix-domain socket
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if(!strcmp(iod_service.socket, "") || strlen(iod_service.socket) >= sizeof(addr.sun_path)) {
+    print_error("*** Error: Invalid socket path for the Riemann solver service (\"%s\").\n", iod_service.socket);
+    return 1;
+  }
+  strcpy(addr.sun_path, iod_service.socket);
+
+  int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(listen_fd<0) {
+    print_error("*** Error: Unable to create a socket (%s).\n", strerror(errno));
+    return 1;
+  }
+  unlink(iod_service.socket); //remove a stale socket file
+  if(bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr))<0 || listen(listen_fd, 8)<0) {
+    print_error("*** Error: Unable to listen on socket %s (%s).\n", iod_service.socket, strerror(errno));
+    close(listen_fd);
+    return 1;
+  }
+
+  print("- Riemann solver service: listening on %s (%s format).\n", iod_service.socket,
+        iod_service.format == RiemannSolverServiceData::TEXT ? "text" : "binary");
+  fflush(stdout);
+
+  while(true) {
+    int conn = accept(listen_fd, NULL, NULL);
+    if(conn<0) {
+      if(errno == EINTR)
+        continue;
+      print_error("*** Error: Failed to accept a connection (%s).\n", strerror(errno));
+      break;
+    }
+    long n = Serve(conn, conn);
+    close(conn);
+    if(verbose>=1) {
+      print("- Riemann solver service: answered %ld request(s) in this connection.\n", n);
+      fflush(stdout);
+    }
+  }
+
+  close(listen_fd);
+  unlink(iod_service.socket);
+  return 1;
+}
+
+//-----------------------------------------------------
+
+long
+RiemannSolverService::Serve(int in_fd, int out_fd)
+{
+  bool text = iod_service.format == RiemannSolverServiceData::TEXT;
+  long num_requests_0 = num_requests;
+
+  BlockQueue to_solver(8), to_writer(8);
+
+  // stage 1: read and parse
+  std::thread reader([&]() {
+    std::string buffer;
+    std::vector<char> chunk(1<<16);
+    while(true) {
+      ssize_t n = read(in_fd, chunk.data(), chunk.size());
+      if(n<0 && errno == EINTR)
+        continue;
+      if(n<=0)
+        break; //end of input (or error)
+      buffer.append(chunk.data(), n);
+      Block *block = new Block();
+      if(text)
+        ParseText(buffer, *block);
+      else
+        ParseBinary(buffer, *block);
+      if(block->requests.empty())
+        delete block;
+      else
+        to_solver.Push(block);
+    }
+    if(text && !buffer.empty()) { //the last line may not end with a newline
+      buffer.push_back('\n');
+      Block *block = new Block();
+      ParseText(buffer, *block);
+      if(block->requests.empty())
+        delete block;
+      else
+        to_solver.Push(block);
+    }
+    Block *end = new Block();
+    end->end = true;
+    to_solver.Push(end);
+  });
+
+  // stage 3: format and write
+  std::thread writer([&]() {
+    std::string output;
+    bool ok = true;
+    while(true) {
+      Block *block = to_writer.Pop();
+      if(block->end) {
+        delete block;
+        break;
+      }
+      if(ok) { //after a write error (e.g., the client disconnected), the remaining responses are discarded
+        const char *data;
+        size_t size;
+        if(text) {
+          FormatText(*block, output);
+          data = output.data();
+          size = output.size();
+        } else {
+          data = (const char*)block->responses.data();
+          size = block->responses.size()*sizeof(double);
+        }
+        while(size>0) {
+          ssize_t n = write(out_fd, data, size);
+          if(n<0 && errno == EINTR)
+            continue;
+          if(n<=0) {
+            ok = false;
+            break;
+          }
+          data += n;
+          size -= n;
+        }
+      }
+      delete block;
+    }
+  });
+
+  // stage 2: solve (in this thread, as the Riemann solver is not thread-safe)
+  while(true) {
+    Block *block = to_solver.Pop();
+    if(!block->end)
+      SolveBlock(*block);
+    bool end = block->end;
+    to_writer.Push(block);
+    if(end)
+      break;
+  }
+
+  reader.join();
+  writer.join();
+
+  return num_requests - num_requests_0;
+}
+
+//-----------------------------------------------------
+
+bool
+RiemannSolverService::IsValidMaterialID(double id)
+{
+  return std::isfinite(id) && id>=0.0 && id<(double)vf.size() && id == floor(id);
+}
+
+//-----------------------------------------------------
+
+void
+RiemannSolverService::SolveBlock(Block &block)
+{
+  int N = block.requests.size()/REQUEST_SIZE;
+  block.responses.assign(N*RESPONSE_SIZE, 0.0);
+
+  double dir[3] = {1.0, 0.0, 0.0};
+  double Vm[5], Vp[5], Vs[5], Vsm[5], Vsp[5];
+  int id;
+
+  for(int i=0; i<N; i++) {
+    double *q = &block.requests[i*REQUEST_SIZE];
+    double *r = &block.responses[i*RESPONSE_SIZE];
+
+    num_requests++;
+
+    // the material ids are checked before being converted to int
+    bool one_sided = q[7]<0.0;
+    bool valid = true;
+    for(int j=0; j<REQUEST_SIZE; j++)
+      valid = valid && std::isfinite(q[j]);
+    valid = valid && IsValidMaterialID(q[3]) && (one_sided || IsValidMaterialID(q[7]));
+    int idm = valid ? (int)q[3] : -1;
+    int idp = valid && !one_sided ? (int)q[7] : -1;
+
+    Vm[0] = q[0];  Vm[1] = q[1];  Vm[2] = Vm[3] = 0.0;  Vm[4] = q[2];
+    Vp[0] = q[4];  Vp[1] = q[5];  Vp[2] = Vp[3] = 0.0;  Vp[4] = q[6];
+
+    valid = valid && riemann.IsValidInputState(Vm, idm);
+    if(!one_sided)
+      valid = valid && riemann.IsValidInputState(Vp, idp);
+    if(!valid) {
+      num_invalid++;
+      r[0] = -1.0;
+      r[1] = -1.0;
+      continue;
+    }
+
+    int err;
+    if(one_sided) {
+      double Ustar[3] = {q[5], 0.0, 0.0};
+      err = riemann.ComputeOneSidedRiemannSolution(dir, Vm, idm, Ustar, Vs, id, Vsm);
+      for(int j=0; j<5; j++)
+        Vsp[j] = Vsm[j];
+    } else
+      err = riemann.ComputeRiemannSolution(dir, Vm, idm, Vp, idp, Vs, id, Vsm, Vsp);
+
+    r[0]  = err;
+    r[1]  = id;
+    r[2]  = Vs[0];   r[3]  = Vs[1];   r[4]  = Vs[4];
+    r[5]  = Vsm[0];  r[6]  = Vsm[1];  r[7]  = Vsm[4];
+    r[8]  = Vsp[0];  r[9]  = Vsp[1];  r[10] = Vsp[4];
+  }
+}
+
+//-----------------------------------------------------
+
+void
+RiemannSolverService::ParseText(std::string &buffer, Block &block)
+{
+  size_t start = 0, end;
+  while((end = buffer.find('\n', start)) != std::string::npos) {
+    buffer[end] = '\0';
+    const char *p = buffer.c_str() + start;
+    start = end + 1;
+
+    while(*p == ' ' || *p == '\t' || *p == '\r')
+      p++;
+    if(*p == '\0' || *p == '#') //blank line or comment
+      continue;
+
+    double q[REQUEST_SIZE];
+    int n = 0;
+    for(; n<REQUEST_SIZE; n++) {
+      char *next;
+      q[n] = strtod(p, &next);
+      if(next == p)
+        break;
+      p = next;
+    }
+    while(*p == ' ' || *p == '\t' || *p == '\r')
+      p++;
+    if(n<REQUEST_SIZE || *p != '\0') //malformed (answered as invalid)
+      q[0] = NAN;
+
+    block.requests.insert(block.requests.end(), q, q+REQUEST_SIZE);
+  }
+  buffer.erase(0, start);
+}
+
+//-----------------------------------------------------
+
+void
+RiemannSolverService::ParseBinary(std::string &buffer, Block &block)
+{
+  size_t record = REQUEST_SIZE*sizeof(double);
+  size_t N = buffer.size()/record;
+  if(N==0)
+    return;
+  size_t n0 = block.requests.size();
+  block.requests.resize(n0 + N*REQUEST_SIZE);
+  memcpy(&block.requests[n0], buffer.data(), N*record);
+  buffer.erase(0, N*record);
+}
+
+//-----------------------------------------------------
+
+void
+RiemannSolverService::FormatText(Block &block, std::string &output)
+{
+  output.clear();
+  char line[512];
+  int N = block.responses.size()/RESPONSE_SIZE;
+  for(int i=0; i<N; i++) {
+    double *r = &block.responses[i*RESPONSE_SIZE];
+    int n = snprintf(line, sizeof(line), "%d %d", (int)r[0], (int)r[1]);
+    for(int j=2; j<RESPONSE_SIZE; j++)
+      n += snprintf(line+n, sizeof(line)-n, " %.16e", r[j]);
+    line[n++] = '\n';
+    output.append(line, n);
+  }
+}
+
+//-----------------------------------------------------
@@ -0,0 +1,92 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _RIEMANN_SOLVER_SERVICE_H_
+#define _RIEMANN_SOLVER_SERVICE_H_
+
+#include <ExactRiemannSolverBase.h>
+#include <vector>
+#include <string>
+
+/*****************************************************************************************
+ * Class RiemannSolverService keeps the materials and the exact Riemann solver in memory, and
+ * answers a stream of requests, read from stdin or from connections to a Unix-domain socket
+ * (one connection at a time). Each request is a one-dimensional Riemann problem
+ *   rhol  ul  pl  idl  rhor  ur  pr  idr
+ * If idr < 0, it is a one-sided problem, with ur being the interface/wall velocity. The response is
+ *   err  id  rho  u  p  rhol*  ul*  pl*  rhor*  ur*  pr*
+ * where err is the error code of the Riemann solver (-1: invalid request), (rho, u, p) is the solution
+ * at x = 0 with material id, and the rest are the left and right star states (for a one-sided problem,
+ * the right star state is the same as the left one).
+ *
+ * Text format: one request per line (blank lines and lines starting with '#' are skipped), and one
+ * response per line. Binary format: a request is 8 doubles, a response 11 doubles (ids and err are
+ * stored as doubles), in native byte order.
+ *
+ * Reading, solving, and writing run in three threads, connected by queues of blocks. A block contains
+ * the complete requests available in one read, so a single request is answered immediately, and
+ * a stream of requests is answered in blocks. In the standard input mode, stdout is reserved for the
+ * responses (see ReserveStandardOutput).
+ *****************************************************************************************/
+
+class RiemannSolverService {
+
+public:
+
+  static const int REQUEST_SIZE = 8;
+  static const int RESPONSE_SIZE = 11;
+
+  struct Block {
+    std::vector<double> requests; //!< REQUEST_SIZE doubles per request
+    std::vector<double> responses; //!< RESPONSE_SIZE doubles per request
+    bool end; //!< the last block of a stream (no requests)
+    Block() : end(false) {}
+  };
+
+private:
+
+  std::vector<VarFcnBase*> &vf;
+  ExactRiemannSolverBase &riemann;
+  RiemannSolverServiceData &iod_service;
+
+  int output_fd; //!< responses in the standard input mode (stdout, or its copy)
+
+  long num_requests, num_invalid; //!< statistics
+
+public:
+
+  RiemannSolverService(std::vector<VarFcnBase*> &vf_, ExactRiemannSolverBase &riemann_,
+                       RiemannSolverServiceData &iod_service_, int output_fd_ = -1 /*default: stdout*/);
+  ~RiemannSolverService() {}
+
+  //! Copies stdout to a new file descriptor (returned, to be used for the responses), and redirects
+  //! stdout to stderr, so that the log (including the solver's messages) does not mix with the
+  //! responses. Should be called before anything is printed.
+  static int ReserveStandardOutput();
+
+  //! returns 0 if successful. In the socket mode, it runs until the process is terminated
+  int Run();
+
+  long GetNumberOfRequests() {return num_requests;}
+
+private:
+
+  //! serves one stream until the end of input. Returns the number of requests served
+  long Serve(int in_fd, int out_fd);
+
+  void SolveBlock(Block &block);
+
+  //! a material id in a request (a double) is valid if it is a whole number in [0, vf.size())
+  bool IsValidMaterialID(double id);
+
+  //! parses the complete records in buffer (removing them), and appends them to block.requests
+  void ParseText(std::string &buffer, Block &block);
+  void ParseBinary(std::string &buffer, Block &block);
+
+  void FormatText(Block &block, std::string &output);
+
+};
+
+#endif
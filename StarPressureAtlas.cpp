@@ -0,0 +1,328 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <StarPressureAtlas.h>
+#include <ExactRiemannSolverBase.h>
+#include <Utils.h>
+#include <cstring>
+#include <cmath>
+
+//-----------------------------------------------------
+
+StarPressureAtlas::StarPressureAtlas(std::vector<VarFcnBase*> &vf_, StarPressureAtlasData &iod_atlas_)
+                 : vf(vf_), iod_atlas(iod_atlas_)
+{
+  Nx = iod_atlas.Np;
+  Ny = iod_atlas.Nrho;
+  Nz = iod_atlas.Nu;
+  if(Nx<2 || Ny<2 || Nz<2) {
+    print_error("*** Error: Detected invalid number of points for the star pressure atlas (%d x %d x %d).\n",
+                Nx, Ny, Nz);
+    exit_mpi();
+  }
+  if(iod_atlas.pressure_ratio_max<=1.0 || iod_atlas.density_ratio_max<1.0 || iod_atlas.velocity_jump_max<=0.0) {
+    print_error("*** Error: Detected invalid range for the star pressure atlas (max pressure ratio: %e, "
+                "max density ratio: %e, max velocity jump: %e).\n", iod_atlas.pressure_ratio_max,
+                iod_atlas.density_ratio_max, iod_atlas.velocity_jump_max);
+    exit_mpi();
+  }
+
+  xmax = log10(iod_atlas.pressure_ratio_max);
+  ymax = log10(iod_atlas.density_ratio_max);
+  zmax = iod_atlas.velocity_jump_max;
+  dx = 2.0*xmax/(Nx-1);
+  dy = 2.0*ymax/(Ny-1);
+  dz = 2.0*zmax/(Nz-1);
+
+  int nmat = vf.size();
+  table_index.assign(nmat*nmat, -1);
+
+  for(auto it = iod_atlas.pairMap.dataMap.begin(); it != iod_atlas.pairMap.dataMap.end(); it++) {
+    StarPressureAtlasPairData &pair(*it->second);
+    if(pair.materialid_left<0  || pair.materialid_left>=nmat ||
+       pair.materialid_right<0 || pair.materialid_right>=nmat) {
+      print_error("*** Error: Detected invalid material pair (%d, %d) for the star pressure atlas.\n",
+                  pair.materialid_left, pair.materialid_right);
+      exit_mpi();
+    }
+    if(pair.density_left<=0.0 || pair.density_right<=0.0 || pair.pressure<=0.0) {
+      print_error("*** Error: The reference state of material pair (%d, %d) in the star pressure atlas must "
+                  "have positive density and pressure.\n", pair.materialid_left, pair.materialid_right);
+      exit_mpi();
+    }
+    int index = pair.materialid_left*nmat + pair.materialid_right;
+    if(table_index[index]>=0) {
+      print_error("*** Error: Material pair (%d, %d) is specified more than once in the star pressure atlas.\n",
+                  pair.materialid_left, pair.materialid_right);
+      exit_mpi();
+    }
+    table_index[index] = tables.size();
+
+    tables.push_back(Table());
+    Table &table(tables.back());
+    table.idl      = pair.materialid_left;
+    table.idr      = pair.materialid_right;
+    table.rhol_ref = pair.density_left;
+    table.rhor_ref = pair.density_right;
+    table.p_ref    = pair.pressure;
+  }
+}
+
+//-----------------------------------------------------
+
+int
+StarPressureAtlas::Setup(ExactRiemannSolverBase &riemann)
+{
+  if(tables.empty()) {
+    print("Warning: No material pairs are specified for the star pressure atlas.\n");
+    return 0;
+  }
+
+  if(ReadFile(iod_atlas.filename) == (int)tables.size()) {
+    print("- Read the star pressure atlas (%d material pair(s)) from %s.\n", (int)tables.size(),
+          iod_atlas.filename);
+    return 0;
+  }
+
+  print("- Building the star pressure atlas (%d material pair(s), %d x %d x %d points).\n",
+        (int)tables.size(), Nx, Ny, Nz);
+#if PRINT_RIEMANN_SOLUTION == 1
+  std::string solution_file = riemann.solution_file;
+  riemann.SetSolutionFile(""); //do not write the solution at every grid point
+#endif
+  for(auto &table : tables)
+    BuildTable(riemann, table);
+#if PRINT_RIEMANN_SOLUTION == 1
+  riemann.SetSolutionFile(solution_file.c_str());
+#endif
+
+  return WriteFile(iod_atlas.filename);
+}
+
+//-----------------------------------------------------
+
+void
+StarPressureAtlas::BuildTable(ExactRiemannSolverBase &riemann, Table &table)
+{
+  table.value.assign(Nx*Ny*Nz, NAN);
+
+  VarFcnBase *vfl = vf[table.idl], *vfr = vf[table.idr];
+  double rhol = table.rhol_ref, pl = table.p_ref;
+  double cl = vfl->ComputeSoundSpeedSquare(rhol, vfl->GetInternalEnergyPerUnitMass(rhol, pl));
+  if(vfl->CheckState(rhol, pl, true) || !(cl>0.0)) {
+    print("Warning: The reference state of material %d is not valid. Unable to build the star pressure "
+          "atlas for material pair (%d, %d).\n", table.idl, table.idl, table.idr);
+    return;
+  }
+  cl = sqrt(cl);
+
+  double dir[3] = {1.0, 0.0, 0.0};
+  double Vm[5], Vp[5], Vs[5], Vsm[5], Vsp[5];
+  int id, nfailed = 0;
+
+  for(int i=0; i<Nx; i++) {
+    double pr = pl*pow(10.0, -xmax + i*dx);
+    for(int j=0; j<Ny; j++) {
+      double rhor = table.rhor_ref*pow(10.0, -ymax + j*dy);
+      double cr = vfr->ComputeSoundSpeedSquare(rhor, vfr->GetInternalEnergyPerUnitMass(rhor, pr));
+      if(vfr->CheckState(rhor, pr, true) || !(cr>0.0)) { //the right state does not exist
+        nfailed += Nz;
+        continue;
+      }
+      cr = sqrt(cr);
+      // from compression to expansion. p* decreases with ul-ur, so once the solver fails (e.g., due to
+      // cavitation or vacuum), it would also fail at the remaining points, which are skipped. Near
+      // vacuum (p* << pl, pr), the solver is expensive, and the atlas is not needed (points skipped).
+      double p_low = 1.0e-4*std::min(pl, pr);
+      for(int k=Nz-1; k>=0; k--) {
+        double du = (-zmax + k*dz)*(cl + cr); //ul - ur
+        Vm[0] = rhol;  Vm[1] =  0.5*du;  Vm[2] = Vm[3] = 0.0;  Vm[4] = pl;
+        Vp[0] = rhor;  Vp[1] = -0.5*du;  Vp[2] = Vp[3] = 0.0;  Vp[4] = pr;
+        int err = riemann.ComputeRiemannSolution(dir, Vm, table.idl, Vp, table.idr, Vs, id, Vsm, Vsp);
+        if(err || !(Vsm[4]>0.0) || !std::isfinite(Vsm[4])) {
+          nfailed += k+1;
+          break;
+        }
+        table.value[(i*Ny + j)*Nz + k] = log10(Vsm[4]/pl);
+        if(Vsm[4]<p_low) {
+          nfailed += k;
+          break;
+        }
+      }
+    }
+  }
+
+  if(nfailed>0)
+    print("Warning: Star pressure atlas for material pair (%d, %d) is incomplete (%d of %d points). The exact "
+          "Riemann solver will use the acoustic estimate near these points.\n", table.idl, table.idr,
+          Nx*Ny*Nz - nfailed, Nx*Ny*Nz);
+}
+
+//-----------------------------------------------------
+
+bool
+StarPressureAtlas::GetStarPressure(double rhol, double ul, double pl, double cl, int idl,
+                                   double rhor, double ur, double pr, double cr, int idr, double &ps)
+{
+  int index = table_index[idl*vf.size() + idr];
+  if(index<0 || pl<=0.0 || pr<=0.0)
+    return false;
+
+  Table &table(tables[index]);
+  if(table.value.empty())
+    return false;
+
+  // non-dimensional parameters
+  double x = log10(pr/pl);
+  double y = log10((rhor*table.rhol_ref)/(rhol*table.rhor_ref));
+  double z = (ul - ur)/(cl + cr);
+  if(fabs(x)>xmax || fabs(y)>ymax || fabs(z)>zmax)
+    return false;
+
+  // locate the cell
+  double xi = (x + xmax)/dx, eta = (y + ymax)/dy, zeta = (z + zmax)/dz;
+  int i = std::min((int)xi, Nx-2), j = std::min((int)eta, Ny-2), k = std::min((int)zeta, Nz-2);
+  xi -= i;  eta -= j;  zeta -= k;
+
+  // trilinear interpolation. All the 8 nodes must be valid
+  double v = 0.0;
+  for(int a=0; a<2; a++)
+    for(int b=0; b<2; b++)
+      for(int c=0; c<2; c++) {
+        double val = table.value[((i+a)*Ny + j+b)*Nz + k+c];
+        if(std::isnan(val))
+          return false;
+        v += (a ? xi : 1.0-xi)*(b ? eta : 1.0-eta)*(c ? zeta : 1.0-zeta)*val;
+      }
+
+  ps = pl*pow(10.0, v);
+  return true;
+}
+
+//-----------------------------------------------------
+
+std::vector<std::string>
+StarPressureAtlas::CreateHeader(Table *table)
+{
+  std::vector<std::string> header;
+  char line[512];
+
+  if(!table) {
+    snprintf(line, sizeof(line), "## Star pressure atlas. Number of material pairs: %d.", (int)tables.size());
+    header.push_back(line);
+    snprintf(line, sizeof(line), "## X: log10(pr/pl), %.12e -> %.12e, %d points", -xmax, xmax, Nx);
+    header.push_back(line);
+    snprintf(line, sizeof(line), "## Y: log10((rhor/rhor_ref)/(rhol/rhol_ref)), %.12e -> %.12e, %d points",
+             -ymax, ymax, Ny);
+    header.push_back(line);
+    snprintf(line, sizeof(line), "## Z: (ul-ur)/(cl+cr), %.12e -> %.12e, %d points", -zmax, zmax, Nz);
+    header.push_back(line);
+    snprintf(line, sizeof(line), "## X  Y  Z  log10(p*/pl)");
+    header.push_back(line);
+    return header;
+  }
+
+  snprintf(line, sizeof(line), "## MaterialPair: %d (EOS type: %d), %d (EOS type: %d)", table->idl,
+           vf[table->idl]->type, table->idr, vf[table->idr]->type);
+  header.push_back(line);
+
+  // the sound speeds at the reference state (to detect changes in EOS parameters)
+  double rhol = table->rhol_ref, rhor = table->rhor_ref, p = table->p_ref;
+  double cl = vf[table->idl]->ComputeSoundSpeedSquare(rhol, vf[table->idl]->GetInternalEnergyPerUnitMass(rhol, p));
+  double cr = vf[table->idr]->ComputeSoundSpeedSquare(rhor, vf[table->idr]->GetInternalEnergyPerUnitMass(rhor, p));
+  snprintf(line, sizeof(line), "## ReferenceState: rhol = %.12e, rhor = %.12e, p = %.12e, cl^2 = %.12e, cr^2 = %.12e",
+           rhol, rhor, p, cl, cr);
+  header.push_back(line);
+
+  return header;
+}
+
+//-----------------------------------------------------
+
+int
+StarPressureAtlas::ReadFile(const char *filename)
+{
+  FILE *file = fopen(filename, "r");
+  if(!file)
+    return 0;
+
+  char line[512];
+  int nread = 0;
+
+  auto match = [&](std::vector<std::string> header) {
+    for(auto &h : header) {
+      if(!fgets(line, sizeof(line), file))
+        return false;
+      line[strcspn(line, "\n")] = '\0';
+      if(h != line)
+        return false;
+    }
+    return true;
+  };
+
+  if(match(CreateHeader())) {
+    for(auto &table : tables) {
+      if(!match(CreateHeader(&table)))
+        break;
+      std::vector<double> value(Nx*Ny*Nz);
+      bool complete = true;
+      for(int n=0; n<Nx*Ny*Nz; n++) {
+        double x, y, z;
+        if(!fgets(line, sizeof(line), file) || sscanf(line, "%lf %lf %lf %lf", &x, &y, &z, &value[n]) != 4 ||
+           fabs(x - (-xmax + (n/(Ny*Nz))*dx)) > 1.0e-6*dx ||
+           fabs(y - (-ymax + (n/Nz)%Ny*dy)) > 1.0e-6*dy ||
+           fabs(z - (-zmax + (n%Nz)*dz)) > 1.0e-6*dz) {
+          complete = false;
+          break;
+        }
+      }
+      if(!complete)
+        break;
+      table.value = value;
+      nread++;
+    }
+  }
+
+  fclose(file);
+
+  if(nread < (int)tables.size())
+    print("Warning: Existing file %s does not match the specified star pressure atlas. Overwriting it.\n",
+          filename);
+
+  return nread;
+}
+
+//-----------------------------------------------------
+
+int
+StarPressureAtlas::WriteFile(const char *filename)
+{
+  FILE *file = fopen(filename, "w");
+  if(!file) {
+    print_error("*** Error: Cannot open file %s for output.\n", filename);
+    return 1;
+  }
+
+  for(auto &line : CreateHeader())
+    fprintf(file, "%s\n", line.c_str());
+
+  for(auto &table : tables) {
+    for(auto &line : CreateHeader(&table))
+      fprintf(file, "%s\n", line.c_str());
+    for(int i=0; i<Nx; i++)
+      for(int j=0; j<Ny; j++)
+        for(int k=0; k<Nz; k++)
+          fprintf(file, "%16.8e  %16.8e  %16.8e  %16.8e\n", -xmax + i*dx, -ymax + j*dy, -zmax + k*dz,
+                  table.value[(i*Ny + j)*Nz + k]);
+  }
+
+  fclose(file);
+
+  print("- Wrote the star pressure atlas to %s.\n", filename);
+  return 0;
+}
+
+//-----------------------------------------------------
+
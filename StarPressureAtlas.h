@@ -0,0 +1,75 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _STAR_PRESSURE_ATLAS_H_
+#define _STAR_PRESSURE_ATLAS_H_
+
+#include <IoData.h>
+#include <VarFcnBase.h>
+#include <vector>
+#include <string>
+
+class ExactRiemannSolverBase;
+
+/*****************************************************************************************
+ * Class StarPressureAtlas stores tabulated star pressures for the material pairs specified in
+ * StarPressureAtlasData, used by the exact Riemann solver to initialize p0 and p1. For each pair,
+ * the Riemann problem is solved on a grid of three non-dimensional parameters
+ *   X = log10(pr/pl),  Y = log10((rhor/rhor_ref)/(rhol/rhol_ref)),  Z = (ul-ur)/(cl+cr),
+ * with the left state fixed at the reference state. The table stores log10(ps/pl), where ps is
+ * the star pressure, and is interpolated trilinearly. For perfect gases, ps/pl depends only on
+ * (X,Y,Z), so the atlas is accurate up to the interpolation error. For other materials, it is an
+ * approximation that is accurate near the reference state. (Either way, it only provides the
+ * initial guess.)
+ *
+ * File format (text): a header for the atlas, then for each pair a header followed by one
+ * grid point per line (X  Y  Z  value; "nan" if the Riemann solver failed at this point).
+ * The file is reused only if all the headers match (including reference sound speeds, which
+ * change with the EOS parameters). Otherwise, the atlas is rebuilt and the file overwritten.
+ *****************************************************************************************/
+
+class StarPressureAtlas {
+
+  std::vector<VarFcnBase*> &vf;
+  StarPressureAtlasData &iod_atlas;
+
+  int Nx, Ny, Nz;
+  double xmax, ymax, zmax; //!< the grid is [-xmax,xmax] x [-ymax,ymax] x [-zmax,zmax]
+  double dx, dy, dz;
+
+  struct Table {
+    int idl, idr;
+    double rhol_ref, rhor_ref, p_ref;
+    std::vector<double> value; //!< log10(p*/pl), size Nx*Ny*Nz (z fastest)
+  };
+  std::vector<Table> tables;
+  std::vector<int> table_index; //!< (idl*vf.size() + idr) -> index in "tables" (-1: not tabulated)
+
+public:
+
+  StarPressureAtlas(std::vector<VarFcnBase*> &vf_, StarPressureAtlasData &iod_atlas_);
+  ~StarPressureAtlas() {}
+
+  //! reads the atlas from file, or builds it using "riemann" and writes it. Returns 0 if successful
+  int Setup(ExactRiemannSolverBase &riemann);
+
+  //! returns false if (idl,idr) is not tabulated, or if the state is outside the atlas
+  bool GetStarPressure(double rhol, double ul, double pl, double cl, int idl,
+                       double rhor, double ur, double pr, double cr, int idr, double &ps);
+
+private:
+
+  void BuildTable(ExactRiemannSolverBase &riemann, Table &table);
+
+  std::vector<std::string> CreateHeader(Table *table = NULL);
+
+  //! returns the number of tables read (0 if the file does not exist or does not match)
+  int ReadFile(const char *filename);
+
+  int WriteFile(const char *filename);
+
+};
+
+#endif
@@ -32,7 +32,8 @@ public:
   ~VarFcnANEOSBase() {}
 
   // ------------------------------------------------------------------------------
-  //! Compute derivatives of p(rho,e) by finite difference (central difference)
+  //! Compute derivatives of p(rho,e) by finite difference (central difference). Derived classes with a
+  //! templated pressure formula replace them by automatic differentiation (GetPressureAndDerivatives)
   // ------------------------------------------------------------------------------
 
   //! dpdrho = \frac{\partial p(\rho,e)}{\partial \rho}
@@ -8,6 +8,7 @@
 
 #include<VarFcnANEOSBase.h>
 #include<polylogarithm_function.h>
+#include<debye_function.h>
 #include<tuple>
 #include<boost/math/tools/roots.hpp>
 #include<boost/math/interpolators/cubic_b_spline.hpp>  //spline interpolation
@@ -54,6 +55,10 @@ private:
   //! Numerical parameters
   double tol_Debye; //!< non-dimensional error tolerance (hard-coded for the moment)
 
+  //! Warm start of the temperature solvers (T of the last solution, and counters)
+  double T_last;
+  int warm_start_success, warm_start_failure;
+
 public:
 
   VarFcnANEOSEx1(MaterialModelData &data);
@@ -62,36 +67,64 @@ public:
   double GetPressure(double rho, double e);
   double GetInternalEnergyPerUnitMass(double rho, double p);
   double GetDensity(double p, double e);
-  //double GetDpdrho(double rho, double e);   //!< Using finite difference, defined in base class
-  //double GetBigGamma(double rho, double e); //!< Using finite difference, defined in base class
+  inline bool HasIterativeInverse() {return true;} //!< e(rho,p) requires solving for T
+
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  Scalar ComputePressure(const Scalar &rho, const Scalar &e) {
+    Scalar T = PropagateTemperatureDerivatives(rho, e,
+                   GetTemperature(MathTools::real_part(rho), MathTools::real_part(e)));
+    return rho*rho*(ComputeColdSpecificEnergyDerivative(rho) + ComputeThermalSpecificHelmholtzDerivativeRho(rho,T));
+  }
+
+  //! Exact derivatives by automatic differentiation (instead of finite differences, as in the base class)
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double GetDpdrho(double rho, double e) {
+    double dpdrho, dpde;
+    GetPressureAndDerivatives(rho, e, dpdrho, dpde);
+    return dpdrho;}
+  inline double GetBigGamma(double rho, double e) {
+    double dpdrho, dpde;
+    GetPressureAndDerivatives(rho, e, dpdrho, dpde);
+    return dpde/rho;}
   double GetTemperature(double rho, double e);
   inline double GetReferenceTemperature() {return T0;} //!< reference temperature (ambient state)
   inline double GetReferenceInternalEnergyPerUnitMass() {return e0;} //!< ambient state 
   double GetInternalEnergyPerUnitMassFromTemperature(double rho, double T);
   double GetInternalEnergyPerUnitMassFromEnthalpy(double rho, double h);
 
+  //! number of temperature solutions obtained by warm start, and the number of fallbacks to global bracketing
+  inline void GetWarmStartCounters(int &success, int &failure) {
+    success = warm_start_success; failure = warm_start_failure;}
+
 private:
 
   //! calculate Debye temperature Theta(rho)
-  inline double ComputeDebyeTemperature(double rho) {return T0*pow(rho/rho0, Gamma0);}
+  template<typename Scalar>
+  inline Scalar ComputeDebyeTemperature(Scalar rho) {return T0*pow(rho/rho0, Gamma0);}
 
   //! calculate Theta'(rho)
-  inline double ComputeDebyeTemperatureDerivative(double rho) {
+  template<typename Scalar>
+  inline Scalar ComputeDebyeTemperatureDerivative(Scalar rho) {
     return T0*Gamma0/rho0*pow(rho/rho0, Gamma0-1.0);}
 
   //! calculate e_{cold} using the Birch-Murnaghan EOS.
-  inline double ComputeColdSpecificEnergy(double rho) {
-    double x = pow(rho/r0, 2.0/3.0) - 1.0;
+  template<typename Scalar>
+  inline Scalar ComputeColdSpecificEnergy(Scalar rho) {
+    Scalar x = pow(rho/r0, 2.0/3.0) - 1.0;
     return 1.125*b0/r0*x*x*(0.5*x*(b0prime-4.0) + 1.0);} //Birch-Murnaghan eq.
 
   //! calculate d(e_{cold})/d(\rho)
-  inline double ComputeColdSpecificEnergyDerivative(double rho) {
-    double x = pow(rho/r0, 2.0/3.0) - 1.0;
+  template<typename Scalar>
+  inline Scalar ComputeColdSpecificEnergyDerivative(Scalar rho) {
+    Scalar x = pow(rho/r0, 2.0/3.0) - 1.0;
     return 1.5*(0.75*(b0prime-4.0)*x*x + x)*b0/(r0*r0)*pow(rho/r0, -1.0/3.0);}
   
   //! calculate e_l
-  inline double ComputeThermalSpecificEnergy(double rho, double T) {
-    double Theta = ComputeDebyeTemperature(rho);   assert(T>0);
+  template<typename Scalar>
+  inline Scalar ComputeThermalSpecificEnergy(Scalar rho, Scalar T) {
+    Scalar Theta = ComputeDebyeTemperature(rho);   assert(T>0);
     return R_over_w*(1.125*Theta + 3.0*T*EvaluateDebyeFunction(Theta/T));}
 
   //! calculate F_l(rho,T)
@@ -101,9 +134,10 @@ private:
     return R_over_w*(1.125*Theta + 3.0*T*log(1.0-exp(-Theta_over_T)) - T*EvaluateDebyeFunction(Theta_over_T));}
 
   //! calculates dF_l(rho,T)/drho
-  double ComputeThermalSpecificHelmholtzDerivativeRho(double rho, double T) {
-    double ThetaPrime = ComputeDebyeTemperatureDerivative(rho);
-    double Theta_over_T = ComputeDebyeTemperature(rho)/T;
+  template<typename Scalar>
+  Scalar ComputeThermalSpecificHelmholtzDerivativeRho(Scalar rho, Scalar T) {
+    Scalar ThetaPrime = ComputeDebyeTemperatureDerivative(rho);
+    Scalar Theta_over_T = ComputeDebyeTemperature(rho)/T;
     assert(Theta_over_T>0);
     return R_over_w*ThetaPrime*(1.125 + 3.0/Theta_over_T*EvaluateDebyeFunction(Theta_over_T));}
 
@@ -117,11 +151,41 @@ private:
     return (spline_Li4 && spline_Li3 && spline_Li2) ? EvaluateDebyeFunctionByInterpolation(x)
                                                     : EvaluateDebyeFunctionOnTheFly(x);}
 
+  //! evaluate D(x) with a dual-number argument (D and D' evaluated at x.v)
+  template<int N>
+  inline MathTools::DualNumber<N> EvaluateDebyeFunction(const MathTools::DualNumber<N> &x) {
+    double D = EvaluateDebyeFunction(x.v);
+    return MathTools::chain_rule(x, D, EvaluateDebyeFunctionDerivative(x.v, D));}
+
+  //! T(rho,e) is found iteratively (GetTemperature). Its derivatives are obtained from one Newton step on
+  //! e_cold(rho) + e_l(rho,T) + delta_e = e, in dual numbers. The value of T is not changed.
+  inline double PropagateTemperatureDerivatives([[maybe_unused]] double rho, [[maybe_unused]] double e,
+                                                double T) {return T;}
+  template<int N>
+  MathTools::DualNumber<N> PropagateTemperatureDerivatives(const MathTools::DualNumber<N> &rho,
+                                                           const MathTools::DualNumber<N> &e, double T) {
+    MathTools::DualNumber<N> residual = e - delta_e - ComputeColdSpecificEnergy(rho)
+                                      - ComputeThermalSpecificEnergy(rho, MathTools::DualNumber<N>(T));
+    residual.v = 0.0;
+    double Theta_over_T = ComputeDebyeTemperature(rho.v)/T;
+    double cv = 3.0*R_over_w*EvaluateDebyeHeatCapacityFunction(Theta_over_T, EvaluateDebyeFunction(Theta_over_T));
+    return T + residual/cv;
+  }
+
   //! evaluate D'(x) (Note: Can also be done by differentiating the splines (i.e. spline.prime(x)))
   inline double EvaluateDebyeFunctionDerivative(double x) {
+    return EvaluateDebyeFunctionDerivative(x, EvaluateDebyeFunction(x));}
+  //! same as above, with D = D(x) given
+  inline double EvaluateDebyeFunctionDerivative(double x, double D) {
+    double expmx = exp(-x);
+    assert(expmx != 1.0);
+    return -3.0/x*D + 3.0*expmx/(1.0-expmx);}
+
+  //! evaluate D(x) - x*D'(x) = 4D(x) - 3x/(e^x-1), which appears in de_l/dT (i.e. heat capacity). D = D(x)
+  inline double EvaluateDebyeHeatCapacityFunction(double x, double D) {
     double expmx = exp(-x);
     assert(expmx != 1.0);
-    return -3.0/x*EvaluateDebyeFunction(x) + 3.0*expmx/(1.0-expmx);}
+    return 4.0*D - 3.0*x*expmx/(1.0-expmx);}
 
   //! evaluate Debye function D(x) on the fly
   double EvaluateDebyeFunctionOnTheFly(double x);
@@ -146,6 +210,11 @@ private:
     rho_e_p_T.back() = std::make_tuple(rho,e,p,T);
   } 
 
+  //! Solve equation(T) = 0 by Newton's method starting from T_last. Returns false if it does not
+  //! converge quickly (then, the caller should fall back to global bracketing).
+  template<typename Functor>
+  bool SolveForTemperatureWithWarmStart(Functor &equation, double &T);
+
 
 protected:
 
@@ -165,6 +234,14 @@ protected:
       return dFl_drho - (vf->R_over_w)*ThetaPrime*(1.125 + 3.0/Theta_over_T*vf->EvaluateDebyeFunction(Theta_over_T)); 
     }
 
+    inline void ValueAndDerivative(double T, double &f, double &df) { //!< f and df/dT (one Debye evaluation)
+      assert(T>0);
+      double Theta_over_T = Theta/T;
+      double D = vf->EvaluateDebyeFunction(Theta_over_T);
+      f  = dFl_drho - (vf->R_over_w)*ThetaPrime*(1.125 + 3.0/Theta_over_T*D);
+      df = -3.0*(vf->R_over_w)*ThetaPrime/Theta*vf->EvaluateDebyeHeatCapacityFunction(Theta_over_T, D);
+    }
+
   private:
     double rho, dFl_drho, Theta, ThetaPrime;
     VarFcnANEOSEx1 *vf;
@@ -184,6 +261,14 @@ protected:
       return el - vf->R_over_w*(Theta_times_9eights + 3.0*T*vf->EvaluateDebyeFunction(Theta/T));
     }
 
+    inline void ValueAndDerivative(double T, double &f, double &df) { //!< f and df/dT (= -c_v)
+      assert(T>0);
+      double Theta_over_T = Theta/T;
+      double D = vf->EvaluateDebyeFunction(Theta_over_T);
+      f  = el - vf->R_over_w*(Theta_times_9eights + 3.0*T*D);
+      df = -3.0*vf->R_over_w*vf->EvaluateDebyeHeatCapacityFunction(Theta_over_T, D);
+    }
+
   private:
     double rho, el, Theta, Theta_times_9eights;
     VarFcnANEOSEx1 *vf;
@@ -265,6 +350,9 @@ VarFcnANEOSEx1::VarFcnANEOSEx1(MaterialModelData &data) : VarFcnANEOSBase(data)
   rho_e_T.resize(4);
   rho_e_p_T.resize(4);
 
+  T_last = -1.0; //no solution yet
+  warm_start_success = warm_start_failure = 0;
+
 }
 
 //---------------------------------------------------------------------
@@ -281,9 +369,7 @@ VarFcnANEOSEx1::~VarFcnANEOSEx1()
 double 
 VarFcnANEOSEx1::GetPressure(double rho, double e) 
 {
-  double T = GetTemperature(rho, e);
-  return rho*rho*(ComputeColdSpecificEnergyDerivative(rho) + 
-                  ComputeThermalSpecificHelmholtzDerivativeRho(rho,T));
+  return ComputePressure(rho, e);
 }
 
 //---------------------------------------------------------------------
@@ -306,6 +392,13 @@ VarFcnANEOSEx1::GetInternalEnergyPerUnitMass(double rho, double p)
   //fprintf(stdout,"e_cold_prime = %e, dFl_drho = %e.\n", e_cold_prime, dFl_drho);
   ThermalHelmholtzDerivativeRhoEquation equation(rho, dFl_drho, this);
 
+  double T;
+  if(SolveForTemperatureWithWarmStart(equation, T)) {
+    double e = ComputeColdSpecificEnergy(rho) + ComputeThermalSpecificEnergy(rho,T) + delta_e;
+    Update_rho_e_p_T(rho, e, p, T);
+    return e;
+  }
+
   // find bracketing interval
   double T_low(500.0), T_high(5000.0);
   double f_low  = equation(T_low);
@@ -332,7 +425,8 @@ VarFcnANEOSEx1::GetInternalEnergyPerUnitMass(double rho, double p)
                                  [=](double rr0, double rr1){return fabs(rr1-rr0)<tol;},
                                  maxit); 
 
-  double T = 0.5*(sol.first + sol.second);
+  T = 0.5*(sol.first + sol.second);
+  T_last = T;
 
   // Calculates e from rho and T
   double e = ComputeColdSpecificEnergy(rho) + ComputeThermalSpecificEnergy(rho,T) + delta_e;
@@ -379,6 +473,13 @@ VarFcnANEOSEx1::GetTemperature(double rho, double e)
   // -------------------------------
   double el = e - delta_e - ComputeColdSpecificEnergy(rho);
   ThermalSpecificEnergyEquation equation(rho, el, this);
+
+  double T;
+  if(SolveForTemperatureWithWarmStart(equation, T)) {
+    Update_rho_e_T(rho, e, T);
+    return T;
+  }
+
   // find bracketing interval
   double T_low = 100.0; 
   double f_low(1.0);
@@ -424,7 +525,8 @@ VarFcnANEOSEx1::GetTemperature(double rho, double e)
                                  [=](double rr0, double rr1){return fabs(rr1-rr0)<tol;},
                                  maxit); 
 
-  double T = 0.5*(sol.first + sol.second);
+  T = 0.5*(sol.first + sol.second);
+  T_last = T;
   Update_rho_e_T(rho, e, T);
 
   return T;
@@ -497,17 +599,47 @@ VarFcnANEOSEx1::GetInternalEnergyPerUnitMassFromEnthalpy(double rho, double h)
 // PRIVATE FUNCTIONS
 //---------------------------------------------------------------------
 
+//---------------------------------------------------------------------
+//! Successive calls (e.g., from the Riemann solver) often differ only slightly in (rho,e) or (rho,p).
+//! In this case, Newton's method starting from the last solution converges in a few iterations, each
+//! requiring only one evaluation of the Debye function. (Both equations are monotonic in T.)
+template<typename Functor>
+bool
+VarFcnANEOSEx1::SolveForTemperatureWithWarmStart(Functor &equation, double &T)
+{
+  if(T_last<=0.0)
+    return false;
+
+  T = T_last;
+  double f, df, dT;
+  for(int iter=0; iter<8; iter++) {
+    equation.ValueAndDerivative(T, f, df);
+    if(!std::isfinite(f) || !std::isfinite(df) || df==0.0)
+      break;
+    dT = -f/df;
+    if(!(T+dT>0.5*T && T+dT<2.0*T)) //too far away from the last solution
+      break;
+    T += dT;
+    if(fabs(dT) < 1.0e-2*tol_Debye*T) {
+      T_last = T;
+      warm_start_success++;
+      return true;
+    }
+  }
+
+  warm_start_failure++;
+  return false;
+}
+
 //---------------------------------------------------------------------
 //! evaluate Debye function D(x) on the fly
 double 
 VarFcnANEOSEx1::EvaluateDebyeFunctionOnTheFly(double x) 
 {
   assert(x>0.0); 
-  double expmx = exp(-x);
-  return 3.0/(x*x*x)*(-6.0*MathTools::polylogarithm_function(4, expmx, 100, tol_Debye)
-                      - 6.0*x*MathTools::polylogarithm_function(3, expmx, 100, tol_Debye)
-                      - 3.0*x*x*MathTools::polylogarithm_function(2, expmx, 100, tol_Debye)
-                      + x*x*x*log(1.0 - expmx) + pi4_over_15);
+  // Equivalent to 3/x^3*(-6Li_4(z) - 6x*Li_3(z) - 3x^2*Li_2(z) + x^3*log(1-z) + pi^4/15), z = exp(-x),
+  // but uses a Taylor series for small x, where the polylogarithm series converge slowly.
+  return MathTools::debye_function(x);
 
 }
 
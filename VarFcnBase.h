@@ -8,6 +8,7 @@
 
 #include <IoData.h>
 #include <Vector3D.h>
+#include <dual_number.h>
 #include <cmath>
 #include <iostream>
 
@@ -31,22 +32,23 @@
  *  - 4 -  EOS related functions
  ***************************************************************************/
 
-extern int verbose;
-
 class VarFcnBase {
 
 public:
   
   enum Type{STIFFENED_GAS = 0, NOBLE_ABEL_STIFFENED_GAS = 1, MIE_GRUNEISEN = 2, 
             EXTENDED_MIE_GRUNEISEN = 3, TILLOTSON = 4,
-            JWL = 5, ANEOS_BIRCH_MURNAGHAN_DEBYE = 6, DUMMY = 7} type;
+            JWL = 5, ANEOS_BIRCH_MURNAGHAN_DEBYE = 6, DUMMY = 7,
+            TABULATED = 8} type;
 
   double rhomin,pmin;
   double rhomax,pmax;
 
   double failsafe_density;
 
-  VarFcnBase(MaterialModelData &data) {
+  int verbose; //!< verbosity of the warnings (set by the owner; 0 by default)
+
+  VarFcnBase(MaterialModelData &data) : verbose(0) {
     rhomin = data.rhomin;
     pmin = data.pmin;
     rhomax = data.rhomax;
@@ -54,7 +56,7 @@ public:
     failsafe_density = data.failsafe_density;
   }
 
-  VarFcnBase() {} //only used to construct VarFcnDummy
+  VarFcnBase() : verbose(0) {} //only used to construct VarFcnDummy
 
   virtual ~VarFcnBase() {}
  
@@ -90,6 +92,13 @@ public:
     fprintf(stdout,"\033[0;31m*** Error:  GetBigGamma Function not defined\n\033[0m");
     exit(-1); return 0.0;}
 
+  //! p(rho,e), dp/drho, and dp/de (= rho*BigGamma) together. EOS with a templated pressure formula override it
+  //  using automatic differentiation (a single evaluation, see EvaluatePressureAndDerivatives).
+  virtual double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    dpdrho = GetDpdrho(rho, e);
+    dpde   = rho*GetBigGamma(rho, e);
+    return GetPressure(rho, e);}
+
   //! temperature law, defined separately for each EOS
   virtual double GetTemperature([[maybe_unused]] double rho, [[maybe_unused]] double e) {
     fprintf(stdout,"\033[0;31m*** Error:  GetTemperature Function not defined\n\033[0m");
@@ -123,7 +132,9 @@ public:
       return true;
     }
     double e = GetInternalEnergyPerUnitMass(rho,p);
-    double c2 = GetDpdrho(rho, e) + p/rho*GetBigGamma(rho, e);
+    double dpdrho, dpde;
+    GetPressureAndDerivatives(rho, e, dpdrho, dpde);
+    double c2 = dpdrho + p/(rho*rho)*dpde;
     if(c2<=0){
       if(!silence && verbose>1)
         fprintf(stdout, "Warning: Negative density or violation of hyperbolicity. rho = %e, p = %e.\n", rho, p);
@@ -142,6 +153,20 @@ public:
     return CheckState(V[0], V[4]); 
   }
  
+  //! true if e(rho,p) is considerably more expensive than p(rho,e) (e.g., requires an extra iterative solve).
+  //  Used by the exact Riemann solver to choose the formulation for integrating isentropes.
+  virtual bool HasIterativeInverse() {return false;}
+
+  //! Solves the Hugoniot equation e(rhos,ps) - e(rho,p) + 0.5*(p+ps)*(1/rhos - 1/rho) = 0 for rhos in closed
+  //  form. Returns false if this is not available (the Riemann solver will then use an iterative method).
+  virtual bool SolveHugoniotDensity([[maybe_unused]] double rho, [[maybe_unused]] double p,
+                                    [[maybe_unused]] double ps, [[maybe_unused]] double &rhos) {return false;}
+
+  //! Returns true if the EOS has the (Noble-Abel) stiffened gas form p = (gam-1)*(e-q)/(1/rho-b) - gam*pc,
+  //  with (gam, pc, b) as outputs (q does not affect the wave curves). Used by the vectorized Riemann kernel.
+  virtual bool GetStiffenedGasParameters([[maybe_unused]] double &gam_, [[maybe_unused]] double &pc_,
+                                         [[maybe_unused]] double &b_) {return false;}
+
   //check for phase transitions
   virtual bool CheckPhaseTransition([[maybe_unused]] int id/*id of the other phase*/) {
     return false; //by default, phase transition is not allowed/considered
@@ -156,6 +181,10 @@ public:
 
   virtual double ComputeSoundSpeed(double rho, double e);
   virtual double ComputeSoundSpeedSquare(double rho, double e); //!< this one does not crash on negative c^2
+  //! c^2(rho,e), dc^2/drho, and dc^2/de. EOS with a templated pressure formula override it using second-order
+  //  automatic differentiation (see EvaluateSoundSpeedSquareAndDerivatives). By default, the derivatives are
+  //  obtained by centered finite differences (four more evaluations of c^2).
+  virtual double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de);
   virtual double ComputeMachNumber(double *V);
   virtual double ComputeEnthalpyPerUnitMass(double rho, double p); //!< h = e + p/rho
   virtual double ComputeTotalEnthalpyPerUnitMass(double *V); //!< H = 1/rho*(E + p)
@@ -202,7 +231,7 @@ void VarFcnBase::PrimitiveToConservative(double *V, double *U)
 inline
 double VarFcnBase::ComputeSoundSpeed(double rho, double e)
 {
-  double c2 = GetDpdrho(rho, e) + GetPressure(rho,e)/rho*GetBigGamma(rho, e);
+  double c2 = ComputeSoundSpeedSquare(rho, e);
   if(c2<=0) {
     fprintf(stdout,"\033[0;31m*** Error: Cannot calculate speed of sound (Square-root of a negative number): rho = %e, e = %e.\n\033[0m",
             rho, e);
@@ -216,7 +245,21 @@ double VarFcnBase::ComputeSoundSpeed(double rho, double e)
 inline
 double VarFcnBase::ComputeSoundSpeedSquare(double rho, double e)
 {
-  return GetDpdrho(rho, e) + GetPressure(rho,e)/rho*GetBigGamma(rho, e);
+  double dpdrho, dpde;
+  double p = GetPressureAndDerivatives(rho, e, dpdrho, dpde);
+  return dpdrho + p/(rho*rho)*dpde;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnBase::ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de)
+{
+  double c2 = ComputeSoundSpeedSquare(rho, e);
+  double hrho = 1.0e-6*rho, he = 1.0e-6*(fabs(e) + fabs(c2));
+  dc2drho = (ComputeSoundSpeedSquare(rho + hrho, e) - ComputeSoundSpeedSquare(rho - hrho, e))/(2.0*hrho);
+  dc2de   = (ComputeSoundSpeedSquare(rho, e + he) - ComputeSoundSpeedSquare(rho, e - he))/(2.0*he);
+  return c2;
 }
 
 //------------------------------------------------------------------------------
@@ -295,6 +338,34 @@ bool VarFcnBase::ClipDensityAndPressure(double *V, double *U)
 }
 
 //------------------------------------------------------------------------------
+//! Evaluates the templated pressure formula of an EOS, eos.ComputePressure(rho, e), once with dual numbers.
+//! Returns p, and the exact partial derivatives dp/drho and dp/de.
+template<typename EOS>
+inline double EvaluatePressureAndDerivatives(EOS &eos, double rho, double e, double &dpdrho, double &dpde)
+{
+  MathTools::DualNumber<2> rho_(rho, 0), e_(e, 1);
+  MathTools::DualNumber<2> p = eos.ComputePressure(rho_, e_);
+  dpdrho = p.d[0];
+  dpde   = p.d[1];
+  return p.v;
+}
+
+//------------------------------------------------------------------------------
+//! Evaluates eos.ComputePressure(rho, e) once with nested dual numbers, which gives the first and second
+//! derivatives of p. Returns c^2 = dp/drho + p/rho^2*dp/de, and its exact partial derivatives.
+template<typename EOS>
+inline double EvaluateSoundSpeedSquareAndDerivatives(EOS &eos, double rho, double e, double &dc2drho, double &dc2de)
+{
+  typedef MathTools::DualNumber<2> Dual;
+  MathTools::DualNumber<2,Dual> rho_(Dual(rho, 0), 0), e_(Dual(e, 1), 1);
+  MathTools::DualNumber<2,Dual> p = eos.ComputePressure(rho_, e_);
+  Dual c2 = p.d[0] + p.v*p.d[1]/(rho_.v*rho_.v); //p.d[i] = dp/dx_i, differentiated once more
+  dc2drho = c2.d[0];
+  dc2de   = c2.d[1];
+  return c2.v;
+}
+
+//------------------------------------------------------------------------------
 
 
 
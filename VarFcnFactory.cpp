@@ -0,0 +1,80 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#include <VarFcnFactory.h>
+#include <VarFcnSG.h>
+#include <VarFcnNASG.h>
+#include <VarFcnMG.h>
+#include <VarFcnMGExt.h>
+#include <VarFcnTillot.h>
+#include <VarFcnJWL.h>
+#include <VarFcnANEOSEx1.h>
+#include <VarFcnTabulated.h>
+
+//--------------------------------------------------------------
+
+VarFcnBase* CreateVarFcn(MaterialModelData &data, int verbose)
+{
+  VarFcnBase *vf = NULL;
+  if(data.eos == MaterialModelData::STIFFENED_GAS)
+    vf = new VarFcnSG(data);
+  else if(data.eos == MaterialModelData::NOBLE_ABEL_STIFFENED_GAS)
+    vf = new VarFcnNASG(data);
+  else if(data.eos == MaterialModelData::MIE_GRUNEISEN)
+    vf = new VarFcnMG(data);
+  else if(data.eos == MaterialModelData::EXTENDED_MIE_GRUNEISEN)
+    vf = new VarFcnMGExt(data);
+  else if(data.eos == MaterialModelData::TILLOTSON)
+    vf = new VarFcnTillot(data);
+  else if(data.eos == MaterialModelData::JWL)
+    vf = new VarFcnJWL(data);
+  else if(data.eos == MaterialModelData::ANEOS_BIRCH_MURNAGHAN_DEBYE)
+    vf = new VarFcnANEOSEx1(data);
+
+  if(vf)
+    vf->verbose = verbose;
+  return vf;
+}
+
+//--------------------------------------------------------------
+
+VarFcnBase* CreateTabulatedVarFcn(VarFcnBase *vf0, MaterialModelData &data)
+{
+  return new VarFcnTabulated(vf0, data);
+}
+
+//--------------------------------------------------------------
+
+std::vector<VarFcnBase*> CreateMaterialVarFcns(ObjectMap<MaterialModelData> &materials, int verbose)
+{
+  std::vector<VarFcnBase*> vf(materials.dataMap.size(), NULL);
+  for(auto it = materials.dataMap.begin(); it != materials.dataMap.end(); it++) {
+    int matid = it->first;
+    vf[matid] = CreateVarFcn(*it->second, verbose);
+    if(it->second->tabulation.type == TabulationModelData::BICUBIC)
+      vf[matid] = CreateTabulatedVarFcn(vf[matid], *it->second);
+  }
+  return vf;
+}
+
+//--------------------------------------------------------------
+
+std::vector<VarFcnBase*> CopyMaterialVarFcns(std::vector<VarFcnBase*> &vf, ObjectMap<MaterialModelData> &materials,
+                                             int verbose)
+{
+  std::vector<VarFcnBase*> vf_copy(materials.dataMap.size(), NULL);
+  for(auto it = materials.dataMap.begin(); it != materials.dataMap.end(); it++) {
+    int matid = it->first;
+    vf_copy[matid] = CreateVarFcn(*it->second, verbose);
+    if(it->second->tabulation.type == TabulationModelData::BICUBIC) {
+      VarFcnTabulated *tab = dynamic_cast<VarFcnTabulated*>(vf[matid]);
+      vf_copy[matid] = tab ? new VarFcnTabulated(*tab, vf_copy[matid])
+                           : CreateTabulatedVarFcn(vf_copy[matid], *it->second);
+    }
+  }
+  return vf_copy;
+}
+
+//--------------------------------------------------------------
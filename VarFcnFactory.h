@@ -0,0 +1,33 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _VAR_FCN_FACTORY_H_
+#define _VAR_FCN_FACTORY_H_
+
+#include <IoData.h>
+#include <VarFcnBase.h>
+
+/*****************************************************************************************
+ * Creation of VarFcn objects from material data. This is the only place where the headers of
+ * the specific EOS are included (they contain function definitions), so that the solver can be
+ * built as a library and linked to other codes. The caller owns the returned objects.
+ *****************************************************************************************/
+
+//! creates the VarFcn of the EOS specified in data (NULL if the EOS is not supported)
+VarFcnBase* CreateVarFcn(MaterialModelData &data, int verbose = 0);
+
+//! creates a tabulated EOS (see VarFcnTabulated) that takes ownership of vf0
+VarFcnBase* CreateTabulatedVarFcn(VarFcnBase *vf0, MaterialModelData &data);
+
+//! creates the VarFcn of all the materials (index = material id), e.g., a private copy for a thread.
+//! The materials must have been checked already (i.e., the EOS are supported)
+std::vector<VarFcnBase*> CreateMaterialVarFcns(ObjectMap<MaterialModelData> &materials, int verbose = 0);
+
+//! same as CreateMaterialVarFcns, except that the tables of tabulated EOS are copied from vf (which
+//! is not modified) instead of being sampled again
+std::vector<VarFcnBase*> CopyMaterialVarFcns(std::vector<VarFcnBase*> &vf, ObjectMap<MaterialModelData> &materials,
+                                             int verbose = 0);
+
+#endif
@@ -46,14 +46,23 @@ public:
   ~VarFcnJWL() {}
 
   //! ----- EOS-Specific Functions -----
-  inline double GetPressure(double rho, double e) {return omega*rho*e + Fun(rho);}
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  inline Scalar ComputePressure(const Scalar &rho, const Scalar &e) {return omega*rho*e + Fun(rho);}
+
+  inline double GetPressure(double rho, double e) {return ComputePressure(rho, e);}
   inline double GetInternalEnergyPerUnitMass(double rho, double p) {return (p-Fun(rho))/(omega*rho);}
   double GetDensity(double p, double e); 
   double GetDpdrho(double rho, double e); 
   inline double GetBigGamma([[maybe_unused]] double rho, [[maybe_unused]] double e) {return omega;}
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
 
 protected:
-  inline double Fun(double rho) {
+  template<typename Scalar>
+  inline Scalar Fun(const Scalar &rho) {
     return  A1*(1.0-omega_over_R1rho0*rho)*exp(-R1rho0/rho) 
           + A2*(1.0-omega_over_R2rho0*rho)*exp(-R2rho0/rho);}
 
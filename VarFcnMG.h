@@ -7,6 +7,7 @@
 #define _VAR_FCN_MG_H
 
 #include <VarFcnBase.h>
+#include <polynomial_equations.h>
 #include <fstream>
 
 /********************************************************************************
@@ -67,10 +68,14 @@ public:
   ~VarFcnMG() {}
 
   //! ----- EOS-Specific Functions -----
-  inline double GetPressure(double rho, double e) {
-    double eta = 1.0 - rho0/rho;
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  inline Scalar ComputePressure(const Scalar &rho, const Scalar &e) {
+    Scalar eta = 1.0 - rho0/rho;
     return rho0_c0_c0*eta*(1.0 - Gamma0_over_2*eta)/((1.0-s*eta)*(1.0-s*eta)) + Gamma0_rho0*(e-e0);}
 
+  inline double GetPressure(double rho, double e) {return ComputePressure(rho, e);}
+
   inline double GetInternalEnergyPerUnitMass(double rho, double p) {
     double eta = 1.0 - rho0/rho;
     return (p - rho0_c0_c0*eta*(1.0 - Gamma0_over_2*eta)/((1.0-s*eta)*(1.0-s*eta)))/Gamma0_rho0 + e0;
@@ -86,6 +91,13 @@ public:
 
   inline double GetBigGamma(double rho, [[maybe_unused]] double e) {return Gamma0_rho0/rho;}
 
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
+
+  bool SolveHugoniotDensity(double rho, double p, double ps, double &rhos);
+
   double GetTemperature(double rho, double e);
 
   inline double GetReferenceTemperature() {return T0;}
@@ -179,6 +191,51 @@ double VarFcnMG::GetDensity(double p, double e) {
 
 //------------------------------------------------------------------------------
 
+bool VarFcnMG::SolveHugoniotDensity(double rho, double p, double ps, double &rhos) {
+
+  // In terms of eta = 1 - rho0/rho, the Hugoniot equation becomes
+  //   f(eta_s) + Gamma0*pavg*eta_s = f(eta) + Gamma0*pavg*eta + (ps - p),
+  // where f(eta) = rho0*c0^2*eta*(1-Gamma0/2*eta)/(1-s*eta)^2 and pavg = (p+ps)/2. Multiplying
+  // it by (1-s*eta_s)^2 gives a cubic equation. The solution is the smallest root in [eta, 1/s).
+  double eta = 1.0 - rho0/rho;
+  double S = 1.0 - s*eta;
+  if(S<=0.0)
+    return false;
+
+  double G = Gamma0*0.5*(p+ps);
+  double A = rho0_c0_c0*eta*(1.0 - Gamma0_over_2*eta)/(S*S) + G*eta + (ps - p);
+  double a3 = s*s*G;
+  double a2 = -Gamma0_over_2*rho0_c0_c0 - 2.0*s*G - s*s*A;
+  double a1 = rho0_c0_c0 + G + 2.0*s*A;
+  double a0 = -A;
+
+  double x[3];
+  int nroots = MathTools::cubic_equation_solver(a3, a2, a1, a0, x[0], x[1], x[2]);
+
+  double eta_max = 1.0/s;
+  double eta_min = eta - 1.0e-12*std::max(1.0, fabs(eta)); //allow round-off
+  double eta_s = eta_max;
+  for(int i=0; i<nroots; i++) {
+    double xi = x[i];
+    for(int it=0; it<2; it++) { //polish the root (the cubic formula may lose a few digits)
+      double f  = ((a3*xi + a2)*xi + a1)*xi + a0;
+      double df = (3.0*a3*xi + 2.0*a2)*xi + a1;
+      if(df==0.0)
+        break;
+      xi -= f/df;
+    }
+    if(std::isfinite(xi) && xi>=eta_min && xi<eta_s)
+      eta_s = xi;
+  }
+  if(eta_s>=eta_max)
+    return false;
+
+  rhos = rho0/(1.0 - std::max(eta_s, eta));
+  return std::isfinite(rhos);
+}
+
+//------------------------------------------------------------------------------
+
 double VarFcnMG::GetTemperature(double rho, double e) {
 
   if(use_cp) {
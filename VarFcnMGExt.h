@@ -12,8 +12,6 @@
 #include <fstream>
 #include <cassert>
 
-extern int verbose;
-
 /********************************************************************************
  * This class is the VarFcn class for the *extended* Mie-Gruneisen equation of state (EOS)
  * that applies different equations for compression and tension, see A. Robinson (SNL Report, 2019).
@@ -114,8 +112,10 @@ public:
   }
 
   //! ----- EOS-Specific Functions -----
-  double GetPressure(double rho, double e) {
-    double eta = 1.0 - rho0/rho;
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  Scalar ComputePressure(const Scalar &rho, const Scalar &e) {
+    Scalar eta = 1.0 - rho0/rho;
     if(eta>=0.0) 
       return rho0_c0_c0*eta*(1.0 - Gamma0_over_2*eta)/((1.0-s*eta)*(1.0-s*eta)) + Gamma0_rho0*(e-e0);
     else if(eta>=eta_min)
@@ -123,6 +123,8 @@ public:
     return rho0_c0_c0*eta_min*(1.0 - Gamma0_over_2*(2.0*eta-eta_min)) + Gamma0_rho0*(e-e0);
   }  
 
+  double GetPressure(double rho, double e) {return ComputePressure(rho, e);}
+
   inline double GetInternalEnergyPerUnitMass(double rho, double p) {
     double eta = 1.0 - rho0/rho;
     return (p - GetPr(eta))/Gamma0_rho0 + GetEr(eta); 
@@ -137,6 +139,11 @@ public:
 
   inline double GetBigGamma(double rho, [[maybe_unused]] double e) {return Gamma0_rho0/rho;}
 
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
+
   double GetTemperature(double rho, double e);
 
   inline double GetReferenceTemperature() {return T0;}
@@ -329,13 +336,17 @@ void VarFcnMGExt::SetupTrInterpolation()
     double c = 1.0/(1.0 - s*z);
     *Integrand = exp(Gamma0*z)*z*z*c*c*c; return;};
 
-  int err = MathTools::runge_kutta_4(fun, 1, eta0, &sol0, delta_eta, eta1, &sol1,
-                                     [](double*){return false;}, &Trs);
-  assert(!err);
+  // store the integral at each step directly in Trs (the last step may be created due to round-off. we drop it.)
+  Trs.resize(N);
+  Trs[0] = sol0;
+  int n = 1;
+  auto store = [&](const MathTools::RKDenseOutput<1> &step) {
+    if(n<N) Trs[n++] = step.U1[0];};
 
-  if((int)Trs.size()==N+1) //the last one must be created due to round-off. we just drop it.
-    Trs.pop_back();
-  assert((int)Trs.size()==N);
+  int err = MathTools::runge_kutta_4<1>(fun, eta0, &sol0, delta_eta, eta1, &sol1,
+                                        [](double*){return false;}, store);
+  assert(!err);
+  assert(n==N);
 
   double coeff = c0*c0*s*invcv;
   double eta;
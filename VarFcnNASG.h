@@ -52,11 +52,35 @@ public:
   ~VarFcnNASG() {}
 
   //! ----- EOS-Specific Functions -----
-  inline double GetPressure(double rho, double e) {return gam1*(e-q)/(1.0/rho - b) - gam_pc;}
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  inline Scalar ComputePressure(const Scalar &rho, const Scalar &e) {return gam1*(e-q)/(1.0/rho - b) - gam_pc;}
+
+  inline double GetPressure(double rho, double e) {return ComputePressure(rho, e);}
   inline double GetInternalEnergyPerUnitMass(double rho, double p) {return invgam1*(p+gam_pc)*(1.0/rho-b) + q;}
   inline double GetDensity(double p, double e) {return 1.0/(gam1*(e-q)/(p+gam_pc) + b);}
   inline double GetDpdrho(double rho, double e) {double V = 1.0/rho; return gam1*V*V*(e-q)/((V-b)*(V-b));}
   inline double GetBigGamma(double rho, [[maybe_unused]] double e) {return gam1/(1.0 - b*rho);}
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
+
+  //! The Hugoniot equation is linear in 1/rhos
+  inline bool SolveHugoniotDensity(double rho, double p, double ps, double &rhos) {
+    double V = 1.0/rho, g1pavg = 0.5*gam1*(p+ps);
+    double denom = ps + gam_pc + g1pavg;
+    if(denom<=0.0)
+      return false;
+    double Vs = ((ps + gam_pc)*b + (p + gam_pc)*(V - b) + g1pavg*V)/denom;
+    if(!(Vs>0.0) || Vs<=b)
+      return false;
+    rhos = 1.0/Vs;
+    return std::isfinite(rhos);
+  }
+
+  inline bool GetStiffenedGasParameters(double &gam_, double &pc_, double &b_) {
+    gam_ = gam; pc_ = pc; b_ = b; return true;}
 
   inline double GetTemperature(double rho, double e) {return invcv*(e - q - pc*(1.0/rho - b));}
 
@@ -61,11 +61,32 @@ public:
   ~VarFcnSG() {}
 
   //! ----- EOS-Specific Functions -----
-  inline double GetPressure(double rho, double e) {return gam1*rho*e - gam*Pstiff;}
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  inline Scalar ComputePressure(const Scalar &rho, const Scalar &e) {return gam1*rho*e - gam*Pstiff;}
+
+  inline double GetPressure(double rho, double e) {return ComputePressure(rho, e);}
   inline double GetInternalEnergyPerUnitMass(double rho, double p) {return (p+gam*Pstiff)/(gam1*rho);}
   inline double GetDensity(double p, double e) {return (p+gam*Pstiff)/(gam1*e);}
   inline double GetDpdrho([[maybe_unused]] double rho, double e) {return gam1*e;}
   inline double GetBigGamma([[maybe_unused]] double rho, [[maybe_unused]] double e) {return gam1;}
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
+
+  //! The Hugoniot equation is linear in 1/rhos
+  inline bool SolveHugoniotDensity(double rho, double p, double ps, double &rhos) {
+    double g1pavg = 0.5*gam1*(p+ps);
+    double num = ps + gam*Pstiff + g1pavg, denom = p + gam*Pstiff + g1pavg;
+    if(num<=0.0 || denom<=0.0)
+      return false;
+    rhos = rho*num/denom;
+    return std::isfinite(rhos);
+  }
+
+  inline bool GetStiffenedGasParameters(double &gam_, double &pc_, double &b_) {
+    gam_ = gam; pc_ = Pstiff; b_ = 0.0; return true;}
 
   inline double GetTemperature(double rho, double e) {
     if(use_cv_advanced) { //Method 3
@@ -0,0 +1,596 @@
+/************************************************************************
+ * Copyright © 2020 The Multiphysics Modeling and Computation (M2C) Lab
+ * <kevin.wgy@gmail.com> <kevinw3@vt.edu>
+ ************************************************************************/
+
+#ifndef _VAR_FCN_TABULATED_H
+#define _VAR_FCN_TABULATED_H
+
+#include <VarFcnBase.h>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+
+/********************************************************************************
+ * This class replaces an existing EOS (the "source" VarFcn, which can be any
+ * of the VarFcn classes) by a table of p(rho,e) sampled on a uniform (rho,e) grid.
+ * Between grid points, p is represented by a bicubic Hermite interpolant built
+ * from the nodal values of p, dp/drho, dp/de, and d2p/(drho de). dp/drho and
+ * BigGamma are obtained by differentiating the same interpolant, and e(rho,p),
+ * rho(p,e) are obtained by inverting it. Therefore, all the returned quantities
+ * are consistent with each other (e.g., GetPressure(rho, GetInternalEnergyPerUnitMass(rho,p)) = p
+ * up to round-off), which is important for the iterations in the Riemann solver.
+ *
+ * Locating the cell that contains (rho,e) is O(1) since the grid is uniform. The
+ * inverse functions need an additional binary search along one grid line.
+ *
+ * At construction, the interpolant is compared with the source EOS at 3 x 3 points
+ * (s, t = 1/4, 1/2, 3/4) in every cell, and the max. errors are stored (GetPressureErrorBound,
+ * GetTemperatureErrorBound). For a cubic Hermite interpolant, the error is O(h^4). It vanishes
+ * at the nodes, and is largest in the interior of the cells (not always at the centers, since
+ * the cross derivatives are approximated).
+ *
+ * Outside the table, the source EOS is called (OutOfRange = Fallback), or the
+ * input is clipped to the boundary of the table (OutOfRange = Clip).
+ *
+ * The inverse functions assume that p is strictly monotonic along each grid line (fixed rho,
+ * or fixed e), so that the root is unique. This is checked at construction on the grid lines and
+ * the lines halfway between them: the nodal values and slopes must have the same sign on each line,
+ * and the derivative of each cubic (a quadratic) must not change sign inside the cell, i.e. the
+ * cubic has no interior extremum. If it is violated in one direction, the inverse in that direction
+ * is always obtained from the source EOS.
+ *
+ * Note: This class takes ownership of the source VarFcn (deleted in the destructor).
+ ********************************************************************************/
+class VarFcnTabulated : public VarFcnBase {
+
+private:
+  VarFcnBase *vf0; //!< the source EOS
+
+  int Nrho, Ne;
+  double rho0, e0; //!< lower-left corner of the table
+  double drho, de; //!< grid spacings
+  double inv_drho, inv_de;
+
+  bool with_temperature;
+  bool clip;
+
+  //! nodal data. For each node: f, df/drho, df/de, d2f/(drho de). Node (i,j) --> 4*(i*Ne+j)
+  std::vector<double> ptab;
+  std::vector<double> Ttab;
+
+  //! error bounds (measured at 3 x 3 points per cell)
+  double p_err_abs, p_err_rel;
+  double T_err_abs, T_err_rel;
+
+  //! whether p is monotonic along every line (dir = 0: fixed e, dir = 1: fixed rho)
+  bool monotonic[2];
+
+  //! number of queries outside the table (may be incremented by multiple threads)
+  std::atomic<int> out_of_range_count;
+
+public:
+  VarFcnTabulated(VarFcnBase *vf_, MaterialModelData &data);
+  //! copies the tables of "tab" (no sampling), with a new source EOS vf_ (e.g., a private copy for a thread)
+  VarFcnTabulated(const VarFcnTabulated &tab, VarFcnBase *vf_);
+  ~VarFcnTabulated() {if(vf0) delete vf0;}
+
+  //! ----- EOS-Specific Functions -----
+  double GetPressure(double rho, double e);
+  double GetInternalEnergyPerUnitMass(double rho, double p);
+  double GetDensity(double p, double e);
+  inline bool HasIterativeInverse() {return true;} //!< e(rho,p) is found by Newton iterations
+  double GetDpdrho(double rho, double e);
+  double GetBigGamma(double rho, double e);
+  double GetTemperature(double rho, double e);
+
+  inline double GetReferenceTemperature() {return vf0->GetReferenceTemperature();}
+  inline double GetReferenceInternalEnergyPerUnitMass() {return vf0->GetReferenceInternalEnergyPerUnitMass();}
+  inline double GetInternalEnergyPerUnitMassFromTemperature(double rho, double T) {
+    return vf0->GetInternalEnergyPerUnitMassFromTemperature(rho,T);}
+  inline double GetInternalEnergyPerUnitMassFromEnthalpy(double rho, double h) {
+    return vf0->GetInternalEnergyPerUnitMassFromEnthalpy(rho,h);}
+  inline bool CheckPhaseTransition(int id) {return vf0->CheckPhaseTransition(id);}
+
+  //! Overwrite the calculations done in the base class (one interpolation instead of three)
+  double ComputeSoundSpeed(double rho, double e);
+  double ComputeSoundSpeedSquare(double rho, double e);
+
+  //! ----- Table-Specific Functions -----
+  inline VarFcnBase* GetSourceVarFcn() {return vf0;}
+  inline void GetPressureErrorBound(double &abs_err, double &rel_err) {abs_err = p_err_abs; rel_err = p_err_rel;}
+  inline void GetTemperatureErrorBound(double &abs_err, double &rel_err) {abs_err = T_err_abs; rel_err = T_err_rel;}
+  inline int  GetNumberOfOutOfRangeQueries() {return out_of_range_count.load();}
+
+private:
+
+  //! returns false if (rho,e) is outside the table. i, j: cell index; s, t: local coords in [0,1]
+  inline bool LocateCell(double &rho, double &e, int &i, int &j, double &s, double &t);
+
+  //! evaluates the bicubic interpolant (and its derivatives if requested) in cell (i,j)
+  void Interpolate(std::vector<double> &tab, int i, int j, double s, double t,
+                   double *f, double *f_rho = NULL, double *f_e = NULL);
+
+  //! value and slope (in r) of the interpolant at the k-th node along the line at x = c + s in the fixed
+  //! direction (dir = 1: q = rho fixed, r = e;  dir = 0: q = e fixed, r = rho). This is the bicubic
+  //! interpolant restricted to the line, i.e. a 1D cubic Hermite interpolant in r
+  inline void GetLineData(int dir, int c, double s, int k, double &P, double &dP);
+
+  //! whether the cubic Hermite interpolant on [0,1] (values P0, P1, slopes h*dP0, h*dP1) is strictly
+  //! monotonic, with the sign of sgn
+  static bool IsMonotonicCubic(double P0, double dP0, double P1, double dP1, double h, double sgn);
+
+  //! solves p_interp = p along a grid line (fixed rho if dir = 1, fixed e if dir = 0)
+  bool InvertPressure(int dir, double q, double p, double &r);
+
+  void ComputeErrorBounds();
+
+};
+
+//------------------------------------------------------------------------------
+
+inline
+VarFcnTabulated::VarFcnTabulated(VarFcnBase *vf_, MaterialModelData &data) : VarFcnBase(data), vf0(vf_)
+{
+  TabulationModelData &tab(data.tabulation);
+
+  if(!vf0) {
+    fprintf(stdout, "\033[0;31m*** Error: Cannot tabulate an undefined EOS.\033[0m\n");
+    exit(-1);
+  }
+  if(tab.Nrho<2 || tab.Ne<2 || tab.rho_min<=0.0 || tab.rho_max<=tab.rho_min || tab.e_max<=tab.e_min) {
+    fprintf(stdout, "\033[0;31m*** Error: Detected invalid range or number of points for EOS tabulation. "
+            "(rho: %e -> %e, %d points; e: %e -> %e, %d points)\033[0m\n", tab.rho_min, tab.rho_max, tab.Nrho,
+            tab.e_min, tab.e_max, tab.Ne);
+    exit(-1);
+  }
+
+  type = TABULATED;
+  verbose = vf0->verbose;
+
+  Nrho = tab.Nrho;
+  Ne   = tab.Ne;
+  rho0 = tab.rho_min;
+  e0   = tab.e_min;
+  drho = (tab.rho_max - tab.rho_min)/(Nrho-1);
+  de   = (tab.e_max - tab.e_min)/(Ne-1);
+  inv_drho = 1.0/drho;
+  inv_de   = 1.0/de;
+
+  with_temperature = (tab.temperature == TabulationModelData::YES);
+  clip = (tab.out_of_range == TabulationModelData::CLIP);
+
+  out_of_range_count = 0;
+
+  // sample the source EOS. The derivatives of p are obtained from the source EOS directly.
+  ptab.resize(4*Nrho*Ne);
+  for(int i=0; i<Nrho; i++) {
+    double rho = rho0 + i*drho;
+    for(int j=0; j<Ne; j++) {
+      double e = e0 + j*de;
+      double *node = &ptab[4*(i*Ne+j)];
+      node[0] = vf0->GetPressure(rho, e);
+      node[1] = vf0->GetDpdrho(rho, e);
+      node[2] = rho*vf0->GetBigGamma(rho, e);
+    }
+  }
+
+  // the cross derivative is not available from VarFcn. Approximate it by differentiating
+  // dp/de w.r.t. rho and dp/drho w.r.t. e, and take the average.
+  for(int i=0; i<Nrho; i++) {
+    int im = std::max(i-1,0), ip = std::min(i+1,Nrho-1);
+    for(int j=0; j<Ne; j++) {
+      int jm = std::max(j-1,0), jp = std::min(j+1,Ne-1);
+      double d1 = (ptab[4*(ip*Ne+j)+2] - ptab[4*(im*Ne+j)+2])/((ip-im)*drho);
+      double d2 = (ptab[4*(i*Ne+jp)+1] - ptab[4*(i*Ne+jm)+1])/((jp-jm)*de);
+      ptab[4*(i*Ne+j)+3] = 0.5*(d1+d2);
+    }
+  }
+
+  // temperature (all the derivatives are approximated by finite differences)
+  if(with_temperature) {
+    Ttab.resize(4*Nrho*Ne);
+    for(int i=0; i<Nrho; i++)
+      for(int j=0; j<Ne; j++)
+        Ttab[4*(i*Ne+j)] = vf0->GetTemperature(rho0 + i*drho, e0 + j*de);
+
+    for(int i=0; i<Nrho; i++) {
+      int im = std::max(i-1,0), ip = std::min(i+1,Nrho-1);
+      for(int j=0; j<Ne; j++) {
+        int jm = std::max(j-1,0), jp = std::min(j+1,Ne-1);
+        Ttab[4*(i*Ne+j)+1] = (Ttab[4*(ip*Ne+j)] - Ttab[4*(im*Ne+j)])/((ip-im)*drho);
+        Ttab[4*(i*Ne+j)+2] = (Ttab[4*(i*Ne+jp)] - Ttab[4*(i*Ne+jm)])/((jp-jm)*de);
+        Ttab[4*(i*Ne+j)+3] = (Ttab[4*(ip*Ne+jp)] - Ttab[4*(ip*Ne+jm)] - Ttab[4*(im*Ne+jp)]
+                            + Ttab[4*(im*Ne+jm)])/((ip-im)*drho*(jp-jm)*de);
+      }
+    }
+  }
+
+  // check monotonicity along the grid lines and the lines halfway between them (x = c + s, s = 0, 1/2;
+  // and the last grid line, x = Nq-1). Each cubic is checked in the interior of the cell as well.
+  monotonic[0] = monotonic[1] = true;
+  for(int dir=0; dir<2; dir++) {
+    int Nq = dir ? Nrho : Ne, N = dir ? Ne : Nrho;
+    double h = dir ? de : drho;
+    for(int line=0; line<2*Nq-1 && monotonic[dir]; line++) {
+      int c = std::min(line/2, Nq-2);
+      double s = 0.5*(line - 2*c); //0, 1/2, or 1 (only for the last grid line)
+      double P0, dP0, P1, dP1;
+      GetLineData(dir, c, s, 0, P0, dP0);
+      double sgn = dP0>0.0 ? 1.0 : -1.0;
+      for(int k=1; k<N; k++) {
+        GetLineData(dir, c, s, k, P1, dP1);
+        if(!(sgn*(P1-P0)>0.0) || !IsMonotonicCubic(P0, dP0, P1, dP1, h, sgn)) {
+          monotonic[dir] = false;
+          break;
+        }
+        P0 = P1;
+        dP0 = dP1;
+      }
+    }
+  }
+  if(!monotonic[0] || !monotonic[1])
+    fprintf(stdout, "\033[0;35mWarning: Tabulated EOS (type %d): p is not monotonic in %s within the table. "
+            "The source EOS will be used to invert p.\033[0m\n", vf0->type,
+            (!monotonic[0] && !monotonic[1]) ? "rho and e" : (!monotonic[0] ? "rho" : "e"));
+
+  ComputeErrorBounds();
+
+  if(verbose>=1) {
+    fprintf(stdout, "- Tabulated EOS (type %d): %d x %d grid points. Max. error in p: %e (abs), %e (rel).\n",
+            vf0->type, Nrho, Ne, p_err_abs, p_err_rel);
+    if(with_temperature)
+      fprintf(stdout, "  Max. error in T: %e (abs), %e (rel).\n", T_err_abs, T_err_rel);
+  }
+
+}
+
+//------------------------------------------------------------------------------
+
+inline
+VarFcnTabulated::VarFcnTabulated(const VarFcnTabulated &tab, VarFcnBase *vf_)
+               : VarFcnBase(tab), vf0(vf_), Nrho(tab.Nrho), Ne(tab.Ne), rho0(tab.rho0), e0(tab.e0),
+                 drho(tab.drho), de(tab.de), inv_drho(tab.inv_drho), inv_de(tab.inv_de),
+                 with_temperature(tab.with_temperature), clip(tab.clip), ptab(tab.ptab), Ttab(tab.Ttab),
+                 p_err_abs(tab.p_err_abs), p_err_rel(tab.p_err_rel), T_err_abs(tab.T_err_abs),
+                 T_err_rel(tab.T_err_rel), out_of_range_count(0)
+{
+  if(!vf0) {
+    fprintf(stdout, "\033[0;31m*** Error: Cannot tabulate an undefined EOS.\033[0m\n");
+    exit(-1);
+  }
+  monotonic[0] = tab.monotonic[0];
+  monotonic[1] = tab.monotonic[1];
+}
+
+//------------------------------------------------------------------------------
+
+inline
+bool VarFcnTabulated::LocateCell(double &rho, double &e, int &i, int &j, double &s, double &t)
+{
+  double x = (rho - rho0)*inv_drho;
+  double y = (e - e0)*inv_de;
+
+  if(!(x>=0.0 && x<=Nrho-1 && y>=0.0 && y<=Ne-1)) { //also catches NaN
+    out_of_range_count++;
+    if(!clip || !std::isfinite(x) || !std::isfinite(y))
+      return false;
+    x = std::min(std::max(x, 0.0), (double)(Nrho-1));
+    y = std::min(std::max(y, 0.0), (double)(Ne-1));
+    rho = rho0 + x*drho;
+    e   = e0 + y*de;
+  }
+
+  i = std::min((int)x, Nrho-2);
+  j = std::min((int)y, Ne-2);
+  s = x - i;
+  t = y - j;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void VarFcnTabulated::Interpolate(std::vector<double> &tab, int i, int j, double s, double t,
+                                  double *f, double *f_rho, double *f_e)
+{
+  // cubic Hermite basis functions (H0: values, H1: slopes) and their derivatives
+  double s1 = 1.0 - s, t1 = 1.0 - t;
+  double H0s[2] = {(1.0+2.0*s)*s1*s1, s*s*(3.0-2.0*s)};
+  double H1s[2] = {s*s1*s1*drho, -s*s*s1*drho};
+  double H0t[2] = {(1.0+2.0*t)*t1*t1, t*t*(3.0-2.0*t)};
+  double H1t[2] = {t*t1*t1*de, -t*t*t1*de};
+
+  double *n[2][2] = {{&tab[4*(i*Ne+j)],     &tab[4*(i*Ne+j+1)]},
+                     {&tab[4*((i+1)*Ne+j)], &tab[4*((i+1)*Ne+j+1)]}};
+
+  double sum = 0.0;
+  for(int a=0; a<2; a++)
+    for(int b=0; b<2; b++)
+      sum += n[a][b][0]*H0s[a]*H0t[b] + n[a][b][1]*H1s[a]*H0t[b]
+           + n[a][b][2]*H0s[a]*H1t[b] + n[a][b][3]*H1s[a]*H1t[b];
+  *f = sum;
+
+  if(f_rho) {
+    double dH0s[2] = {6.0*s*(s-1.0)*inv_drho, -6.0*s*(s-1.0)*inv_drho};
+    double dH1s[2] = {(3.0*s-1.0)*(s-1.0), s*(3.0*s-2.0)};
+    sum = 0.0;
+    for(int a=0; a<2; a++)
+      for(int b=0; b<2; b++)
+        sum += n[a][b][0]*dH0s[a]*H0t[b] + n[a][b][1]*dH1s[a]*H0t[b]
+             + n[a][b][2]*dH0s[a]*H1t[b] + n[a][b][3]*dH1s[a]*H1t[b];
+    *f_rho = sum;
+  }
+
+  if(f_e) {
+    double dH0t[2] = {6.0*t*(t-1.0)*inv_de, -6.0*t*(t-1.0)*inv_de};
+    double dH1t[2] = {(3.0*t-1.0)*(t-1.0), t*(3.0*t-2.0)};
+    sum = 0.0;
+    for(int a=0; a<2; a++)
+      for(int b=0; b<2; b++)
+        sum += n[a][b][0]*H0s[a]*dH0t[b] + n[a][b][1]*H1s[a]*dH0t[b]
+             + n[a][b][2]*H0s[a]*dH1t[b] + n[a][b][3]*H1s[a]*dH1t[b];
+    *f_e = sum;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetPressure(double rho, double e)
+{
+  int i,j;
+  double s,t,p;
+  if(!LocateCell(rho,e,i,j,s,t))
+    return vf0->GetPressure(rho,e);
+  Interpolate(ptab,i,j,s,t,&p);
+  return p;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetDpdrho(double rho, double e)
+{
+  int i,j;
+  double s,t,p,dpdrho;
+  if(!LocateCell(rho,e,i,j,s,t))
+    return vf0->GetDpdrho(rho,e);
+  Interpolate(ptab,i,j,s,t,&p,&dpdrho);
+  return dpdrho;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetBigGamma(double rho, double e)
+{
+  int i,j;
+  double s,t,p,dpde;
+  if(!LocateCell(rho,e,i,j,s,t))
+    return vf0->GetBigGamma(rho,e);
+  Interpolate(ptab,i,j,s,t,&p,NULL,&dpde);
+  return dpde/rho;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetTemperature(double rho, double e)
+{
+  if(!with_temperature)
+    return vf0->GetTemperature(rho,e);
+
+  int i,j;
+  double s,t,T;
+  if(!LocateCell(rho,e,i,j,s,t))
+    return vf0->GetTemperature(rho,e);
+  Interpolate(Ttab,i,j,s,t,&T);
+  return T;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::ComputeSoundSpeedSquare(double rho, double e)
+{
+  int i,j;
+  double s,t,p,dpdrho,dpde;
+  if(!LocateCell(rho,e,i,j,s,t))
+    return vf0->ComputeSoundSpeedSquare(rho,e);
+  Interpolate(ptab,i,j,s,t,&p,&dpdrho,&dpde);
+  return dpdrho + p/(rho*rho)*dpde;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::ComputeSoundSpeed(double rho, double e)
+{
+  double c2 = ComputeSoundSpeedSquare(rho,e);
+  if(c2<=0) {
+    fprintf(stdout,"\033[0;31m*** Error: Cannot calculate speed of sound (Square-root of a negative number): rho = %e, e = %e.\n\033[0m",
+            rho, e);
+    exit(-1);
+  }
+  return sqrt(c2);
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetInternalEnergyPerUnitMass(double rho, double p)
+{
+  double e;
+  if(!InvertPressure(1, rho, p, e))
+    return vf0->GetInternalEnergyPerUnitMass(rho,p);
+  return e;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+double VarFcnTabulated::GetDensity(double p, double e)
+{
+  double rho;
+  if(!InvertPressure(0, e, p, rho))
+    return vf0->GetDensity(p,e);
+  return rho;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void VarFcnTabulated::GetLineData(int dir, int c, double s, int k, double &P, double &dP)
+{
+  double s1 = 1.0 - s;
+  double hq = dir ? drho : de;
+  double H0[2] = {(1.0+2.0*s)*s1*s1, s*s*(3.0-2.0*s)};
+  double H1[2] = {s*s1*s1*hq, -s*s*s1*hq};
+
+  double *n0 = dir ? &ptab[4*(c*Ne+k)] : &ptab[4*(k*Ne+c)];
+  double *n1 = dir ? &ptab[4*((c+1)*Ne+k)] : &ptab[4*(k*Ne+c+1)];
+  int iq = dir ? 1 : 2, ir = dir ? 2 : 1; //derivatives in the fixed (q) and unknown (r) directions
+  P  = H0[0]*n0[0]  + H0[1]*n1[0]  + H1[0]*n0[iq] + H1[1]*n1[iq];
+  dP = H0[0]*n0[ir] + H0[1]*n1[ir] + H1[0]*n0[3]  + H1[1]*n1[3];
+}
+
+//------------------------------------------------------------------------------
+
+inline
+bool VarFcnTabulated::IsMonotonicCubic(double P0, double dP0, double P1, double dP1, double h, double sgn)
+{
+  if(!(sgn*dP0>0.0) || !(sgn*dP1>0.0))
+    return false;
+
+  // dP/dt = a*t^2 + b*t + h*dP0 (quadratic). Since it has the sign of sgn at both ends, it can only
+  // change sign in between if its extremum is inside (0,1) and has the opposite sign.
+  double D = P1 - P0;
+  double a = -6.0*D + 3.0*h*(dP0 + dP1);
+  double b = 6.0*D - h*(4.0*dP0 + 2.0*dP1);
+  if(a==0.0)
+    return true;
+  double t = -0.5*b/a;
+  if(t<=0.0 || t>=1.0)
+    return true;
+  return sgn*((a*t + b)*t + h*dP0)>0.0;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+bool VarFcnTabulated::InvertPressure(int dir, double q, double p, double &r)
+{
+  // dir = 1: q = rho (fixed), find r = e;  dir = 0: q = e (fixed), find r = rho
+  if(!monotonic[dir]) //the root may not be unique
+    return false;
+
+  int N = dir ? Ne : Nrho; //number of nodes along the line
+  double h = dir ? de : drho; //spacing along the line
+
+  double x = dir ? (q - rho0)*inv_drho : (q - e0)*inv_de;
+  int Nq = dir ? Nrho : Ne;
+  if(!(x>=0.0 && x<=Nq-1)) {
+    out_of_range_count++;
+    if(!clip || !std::isfinite(x))
+      return false;
+    x = std::min(std::max(x, 0.0), (double)(Nq-1));
+  }
+  int c = std::min((int)x, Nq-2);
+  double s = x - c;
+  auto line = [&](int k, double &P, double &dP) {GetLineData(dir, c, s, k, P, dP);};
+
+  // binary search for a cell with a sign change
+  int lo = 0, hi = N-1;
+  double Plo, dPlo, Phi, dPhi;
+  line(lo, Plo, dPlo);
+  line(hi, Phi, dPhi);
+  if((Plo-p)*(Phi-p)>0.0) {
+    out_of_range_count++;
+    if(!clip)
+      return false;
+    double rmin = dir ? e0 : rho0;
+    r = rmin + (fabs(Plo-p)<fabs(Phi-p) ? 0 : N-1)*h;
+    return true;
+  }
+  while(hi-lo>1) {
+    int mid = (lo+hi)/2;
+    double Pmid, dPmid;
+    line(mid, Pmid, dPmid);
+    if((Pmid-p)*(Plo-p)>0.0) {lo = mid; Plo = Pmid; dPlo = dPmid;}
+    else                     {hi = mid; Phi = Pmid; dPhi = dPmid;}
+  }
+
+  // solve the cubic equation in [0,1] by Newton's method, safeguarded by bisection
+  double a = 0.0, b = 1.0, fa = Plo - p;
+  double t = (Plo==Phi) ? 0.5 : (p-Plo)/(Phi-Plo);
+  for(int iter=0; iter<50; iter++) {
+    double t1 = 1.0 - t;
+    double f  = Plo*(1.0+2.0*t)*t1*t1 + Phi*t*t*(3.0-2.0*t) + h*(dPlo*t*t1*t1 - dPhi*t*t*t1) - p;
+    double df = 6.0*t*(t-1.0)*(Plo-Phi) + h*(dPlo*(3.0*t-1.0)*(t-1.0) + dPhi*t*(3.0*t-2.0));
+    if(f==0.0)
+      break;
+    if(f*fa>0.0) {a = t; fa = f;}
+    else          b = t;
+    double t_new = (df!=0.0) ? t - f/df : 0.5*(a+b);
+    if(!(t_new>a && t_new<b)) //Newton step leaves the bracket
+      t_new = 0.5*(a+b);
+    if(fabs(t_new-t)<1.0e-14) {
+      t = t_new;
+      break;
+    }
+    t = t_new;
+  }
+
+  r = (dir ? e0 : rho0) + (lo + t)*h;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+inline
+void VarFcnTabulated::ComputeErrorBounds()
+{
+  p_err_abs = p_err_rel = 0.0;
+  T_err_abs = T_err_rel = 0.0;
+
+  // relative errors are not meaningful where p (or T) crosses zero. A floor is used in the denominator.
+  double p_floor = 0.0, T_floor = 0.0;
+  for(int n=0; n<Nrho*Ne; n++) {
+    p_floor = std::max(p_floor, fabs(ptab[4*n]));
+    if(with_temperature)
+      T_floor = std::max(T_floor, fabs(Ttab[4*n]));
+  }
+  p_floor *= 1.0e-3;
+  T_floor *= 1.0e-3;
+
+  // 3 x 3 points per cell (the error vanishes at the nodes)
+  for(int i=0; i<Nrho-1; i++)
+    for(int j=0; j<Ne-1; j++)
+      for(int m=1; m<=3; m++)
+        for(int n=1; n<=3; n++) {
+          double s = 0.25*m, t = 0.25*n;
+          double rho = rho0 + (i+s)*drho;
+          double e = e0 + (j+t)*de;
+
+          double p_exact = vf0->GetPressure(rho,e), p;
+          Interpolate(ptab,i,j,s,t,&p);
+          double err = fabs(p - p_exact);
+          p_err_abs = std::max(p_err_abs, err);
+          if(p_floor>0.0)
+            p_err_rel = std::max(p_err_rel, err/std::max(fabs(p_exact), p_floor));
+
+          if(with_temperature) {
+            double T_exact = vf0->GetTemperature(rho,e), T;
+            Interpolate(Ttab,i,j,s,t,&T);
+            err = fabs(T - T_exact);
+            T_err_abs = std::max(T_err_abs, err);
+            if(T_floor>0.0)
+              T_err_rel = std::max(T_err_rel, err/std::max(fabs(T_exact), T_floor));
+          }
+        }
+}
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -85,14 +85,31 @@ public:
 
   inline double GetPressure(double rho, double e) {return (this->*GetPressureCase[GetCaseWithRhoE(rho,e)])(rho,e);}
 
+  //! p(rho,e) for double or MathTools::DualNumber (automatic differentiation)
+  template<typename Scalar>
+  Scalar ComputePressure(const Scalar &rho, const Scalar &e) {
+    switch(GetCaseWithRhoE(MathTools::real_part(rho), MathTools::real_part(e))) {
+      case 0 : return GetPressure1(rho,e);
+      case 1 : return GetPressure2(rho,e);
+      case 2 : return GetPressure3(rho,e);
+      default: return GetPressure12(rho,e);
+    }
+  }
+
   double GetInternalEnergyPerUnitMass(double rho, double p);
 
   double GetDensity(double p, double e);
+  inline bool HasIterativeInverse() {return true;} //!< e(rho,p) may require root-finding
 
   inline double GetDpdrho(double rho, double e) {return (this->*GetDpdrhoCase[GetCaseWithRhoE(rho,e)])(rho,e);}
 
   inline double GetBigGamma(double rho, double e) {return (this->*GetGammaCase[GetCaseWithRhoE(rho,e)])(rho,e);}
 
+  inline double GetPressureAndDerivatives(double rho, double e, double &dpdrho, double &dpde) {
+    return EvaluatePressureAndDerivatives(*this, rho, e, dpdrho, dpde);}
+  inline double ComputeSoundSpeedSquareAndDerivatives(double rho, double e, double &dc2drho, double &dc2de) {
+    return EvaluateSoundSpeedSquareAndDerivatives(*this, rho, e, dc2drho, dc2de);}
+
   double GetTemperature(double rho, double e);
 
   inline double GetReferenceTemperature() {return T0;} //!< reference temperature (ambient state)
@@ -112,8 +129,10 @@ private:
   //! Get ecold from trajectory. Extend the trajectory if needed.
   double GetColdEnergy(double rho);
 
-  inline double GetChiWithEta(double eta, double e) {return 1.0/(e/(e0*eta*eta)+1.0);}
-  inline double GetChiWithOmega(double omega, double e) {return 1.0/(e/e0*(omega+1.0)*(omega+1)+1.0);}
+  template<typename Scalar>
+  inline Scalar GetChiWithEta(Scalar eta, Scalar e) {return 1.0/(e/(e0*eta*eta)+1.0);}
+  template<typename Scalar>
+  inline Scalar GetChiWithOmega(Scalar omega, Scalar e) {return 1.0/(e/e0*(omega+1.0)*(omega+1)+1.0);}
 
   //! Determine the case id, given rho and e. Returns 0, 1, 2, or 3 for Case 1, 2, 3, and 1|2
   int GetCaseWithRhoE(double rho, double e) {
@@ -136,9 +155,10 @@ private:
   /********************************
    *            Case 1
    *******************************/
-  double GetPressure1(double rho, double e) {
-    double eta = rho/rho0;
-    double mu  = eta - 1.0;
+  template<typename Scalar>
+  Scalar GetPressure1(Scalar rho, Scalar e) {
+    Scalar eta = rho/rho0;
+    Scalar mu  = eta - 1.0;
     return (a + b*GetChiWithEta(eta,e))*rho*e + (A + B*mu)*mu;
   }
 
@@ -159,10 +179,11 @@ private:
   /********************************
    *            Case 2
    *******************************/
-  double GetPressure2(double rho, double e) {
-    double mu    = rho/rho0 - 1.0;
-    double omega = rho0/rho - 1.0;
-    double rho_e = rho*e;
+  template<typename Scalar>
+  Scalar GetPressure2(Scalar rho, Scalar e) {
+    Scalar mu    = rho/rho0 - 1.0;
+    Scalar omega = rho0/rho - 1.0;
+    Scalar rho_e = rho*e;
     return a*rho_e + (b*rho_e*GetChiWithOmega(omega,e) + A*mu*exp(-beta*omega))*exp(-alpha*omega*omega);
   }
  
@@ -187,8 +208,9 @@ private:
   /********************************
    *            Case 3 
    *******************************/
-  double GetPressure3(double rho, double e) {
-    double eta = rho/rho0;
+  template<typename Scalar>
+  Scalar GetPressure3(Scalar rho, Scalar e) {
+    Scalar eta = rho/rho0;
     return (a + b*GetChiWithEta(eta,e))*rho*e + A*(eta - 1.0);
   }
 
@@ -212,7 +234,8 @@ private:
   /********************************
    *           Case 1|2 
    *******************************/
-  inline double GetPressure12(double rho, double e) {
+  template<typename Scalar>
+  inline Scalar GetPressure12(Scalar rho, Scalar e) {
     return ((eCV-e)*GetPressure1(rho,e) + (e-eIV)*GetPressure2(rho,e))/elat;
   }
 
@@ -233,8 +256,8 @@ private:
    * Function Arrays (All Cases)      
    *******************************/
   typedef double (VarFcnTillot::*DoubleFunction) (double rho, double e);
-  DoubleFunction GetPressureCase[4] = {&VarFcnTillot::GetPressure1, &VarFcnTillot::GetPressure2,
-                                       &VarFcnTillot::GetPressure3, &VarFcnTillot::GetPressure12};
+  DoubleFunction GetPressureCase[4] = {&VarFcnTillot::GetPressure1<double>, &VarFcnTillot::GetPressure2<double>,
+                                       &VarFcnTillot::GetPressure3<double>, &VarFcnTillot::GetPressure12<double>};
   DoubleFunction GetGammaCase[4]    = {&VarFcnTillot::GetGamma1, &VarFcnTillot::GetGamma2,
                                        &VarFcnTillot::GetGamma3, &VarFcnTillot::GetGamma12};
   DoubleFunction GetDpdrhoCase[4]   = {&VarFcnTillot::GetDpdrho1, &VarFcnTillot::GetDpdrho2,
@@ -415,22 +438,14 @@ VarFcnTillot::ExtendColdEnergyTrajectoryUpwards(double rhomax)
     drho0 = 1e-3*rho0;
 
   // integration
-  double ecold_max;
-  std::vector<double> rho_new, ecold_new;
-  int err = MathTools::runge_kutta_45(fun, 1, rho_plus[mysize-1], &ecold_plus[mysize-1], drho0, rhomax,
-                                      &ecold_max, [](double*){return false;}, 
-                                      tol/100.0, Nmax-mysize, &rho_new, &ecold_new); //smaller tol, because we will interpolate
+  double rho_start = rho_plus.back(), ecold_start = ecold_plus.back(), ecold_max;
+  auto store = [&](const MathTools::RKDenseOutput<1> &step) { //append each new step to the trajectory
+    rho_plus.push_back(step.t1);
+    ecold_plus.push_back(step.U1[0]); return;};
+  int err = MathTools::runge_kutta_45<1>(fun, rho_start, &ecold_start, drho0, rhomax,
+                                         &ecold_max, [](double*){return false;},
+                                         tol/100.0, Nmax-mysize, store); //smaller tol, because we will interpolate
   assert(!err);
-
-  int new_size = rho_new.size();
-  assert(new_size == (int)ecold_new.size());
-
-  rho_plus.reserve(mysize + new_size - 1);
-  ecold_plus.reserve(mysize + new_size - 1);
-  for(int i=1; i<new_size; i++) {
-    rho_plus.push_back(rho_new[i]);
-    ecold_plus.push_back(ecold_new[i]);
-  }
 }
 
 //------------------------------------------------------------------------------
@@ -458,22 +473,14 @@ VarFcnTillot::ExtendColdEnergyTrajectoryDownwards(double rhomin)
     drho0 = -1e-3*rho0;
 
   // integration
-  double ecold_min;
-  std::vector<double> rho_new, ecold_new;
-  int err = MathTools::runge_kutta_45(fun, 1, rho_minus[mysize-1], &ecold_minus[mysize-1], drho0, rhomin,
-                                      &ecold_min, [](double*){return false;}, 
-                                      tol/100.0, Nmax-mysize, &rho_new, &ecold_new); //smaller tol, because we will interpolate
+  double rho_start = rho_minus.back(), ecold_start = ecold_minus.back(), ecold_min;
+  auto store = [&](const MathTools::RKDenseOutput<1> &step) { //append each new step to the trajectory
+    rho_minus.push_back(step.t1);
+    ecold_minus.push_back(step.U1[0]); return;};
+  int err = MathTools::runge_kutta_45<1>(fun, rho_start, &ecold_start, drho0, rhomin,
+                                         &ecold_min, [](double*){return false;},
+                                         tol/100.0, Nmax-mysize, store); //smaller tol, because we will interpolate
   assert(!err);
-
-  int new_size = rho_new.size();
-  assert(new_size == (int)ecold_new.size());
-
-  rho_minus.reserve(mysize + new_size - 1);
-  ecold_minus.reserve(mysize + new_size - 1);
-  for(int i=1; i<new_size; i++) {
-    rho_minus.push_back(rho_new[i]);
-    ecold_minus.push_back(ecold_new[i]);
-  }
 }
 
 //------------------------------------------------------------------------------